@@ -1,5 +1,7 @@
 #define HERMES_REPORT_ALL
 #include "hermes2d.h"
+#include "mesh_refinement_plan.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -13,6 +15,12 @@ using namespace Hermes::Hermes2D::Views;
 // Read original or XML mesh file.
 const bool USE_XML_FORMAT = true;     
 
+// Collect the initial refinements into a MeshRefinementPlan that performs
+// them in one sweep per refinement level (useful for large meshes).
+const bool USE_REFINEMENT_PLAN = false;
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
+
 // Text message with hints.
 static char text[] = "\
 Click into the image window and:\n\
@@ -30,6 +38,11 @@ Click into the image window and:\n\
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   if (USE_XML_FORMAT == true)
@@ -52,37 +65,56 @@ int main(int argc, char* argv[])
     mloader.load("domain.mesh", &mesh);
   }
 
-  // Refine mesh uniformly (optional).
-  mesh.refine_all_elements();          
+  if (USE_REFINEMENT_PLAN == true)
+  {
+    // The same uniform, vertex and boundary refinements as below. The individual
+    // element refinements are left out since element ids depend on the order
+    // in which elements were split.
+    MeshRefinementPlan plan;
+    plan.add_uniform(1);
+    plan.add_towards_vertex(3, 4);
+    plan.add_towards_boundary("Outer", 4);
+    plan.apply(&mesh);
+  }
+  else
+  {
+    // Refine mesh uniformly (optional).
+    mesh.refine_all_elements();          
 
-  // Refine towards a mesh vertex (optional).
-  // Four refinements towards vertex no. 3.  
-  mesh.refine_towards_vertex(3, 4);    
+    // Refine towards a mesh vertex (optional).
+    // Four refinements towards vertex no. 3.  
+    mesh.refine_towards_vertex(3, 4);    
 
-  // Refine towards boundary (optional).
-  // Four successive refinements towards boundary with marker "Outer".
-  mesh.refine_towards_boundary("Outer", 4);  
+    // Refine towards boundary (optional).
+    // Four successive refinements towards boundary with marker "Outer".
+    mesh.refine_towards_boundary("Outer", 4);  
 
-  // Refine individual elements (optional).
-  // 0... isotropic refinement.
-  mesh.refine_element_id(86, 0);          
-  // 0... isotropic refinement.
-  mesh.refine_element_id(112, 0);         
-  // 2... anisotropic refinement.
-  mesh.refine_element_id(84, 2);          
-  // 1... anisotropic refinement.
-  mesh.refine_element_id(114, 1);         
+    // Refine individual elements (optional).
+    // 0... isotropic refinement.
+    mesh.refine_element_id(86, 0);          
+    // 0... isotropic refinement.
+    mesh.refine_element_id(112, 0);         
+    // 2... anisotropic refinement.
+    mesh.refine_element_id(84, 2);          
+    // 1... anisotropic refinement.
+    mesh.refine_element_id(114, 1);         
+  }
 
-  // Display the mesh.
-  // (0, 0) is the upper left corner position, 
-  // 350 x 350 is the window size.
-  MeshView mview("Hello world!", new WinGeom(0, 0, 350, 350));
-  mview.show(&mesh);
+  if (HERMES_VISUALIZATION)
+  {
+    // Display the mesh.
+    // (0, 0) is the upper left corner position, 
+    // 350 x 350 is the window size.
+    MeshView mview("Hello world!", new WinGeom(0, 0, 350, 350));
+    mview.show(&mesh);
 
-  // Practice some keyboard and mouse controls.
-  printf("%s", text);
+    // Practice some keyboard and mouse controls.
+    printf("%s", text);
 
-  // Wait for the view to be closed.
-  View::wait();
+    // Wait for the view to be closed.
+    View::wait();
+  }
+  else
+    Hermes::Mixins::Loggable::Static::info("Mesh has %d active elements.", mesh.get_num_active_elements());
   return 0;
 }
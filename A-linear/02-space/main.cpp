@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "hermes2d.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -24,8 +25,10 @@ using namespace Hermes::Hermes2D::Views;
 
 // Read original or XML mesh file.
 const bool USE_XML_FORMAT = true;     
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree of mesh elements.
-const int P_INIT = 3;
+int P_INIT = 3;
        
 // Text message with hints.
 static char text[] = "\
@@ -46,6 +49,12 @@ Click into the image window and:\n\
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   if (USE_XML_FORMAT == true)
@@ -81,16 +90,21 @@ int main(int argc, char* argv[])
   // Create an H1 space with default shapeset and natural BC.
   H1Space<double> space(&mesh, P_INIT);
 
-  // View FE basis functions.
-  BaseView<double> bview("Finite Element Space", new WinGeom(0, 0, 440, 350));
-  bview.fix_scale_width(50);
-  bview.show(&space, HERMES_EPS_HIGH);
+  Hermes::Mixins::Loggable::Static::info("ndof = %d", space.get_num_dofs());
+
+  if (HERMES_VISUALIZATION)
+  {
+    // View FE basis functions.
+    BaseView<double> bview("Finite Element Space", new WinGeom(0, 0, 440, 350));
+    bview.fix_scale_width(50);
+    bview.show(&space, HERMES_EPS_HIGH);
 
-  // Practice keyboard and mouse controls.
-  printf("%s", text);
+    // Practice keyboard and mouse controls.
+    printf("%s", text);
 
-  // Wait for the view to be closed.
-  View::wait();
+    // Wait for the view to be closed.
+    View::wait();
+  }
   return 0;
 }
 
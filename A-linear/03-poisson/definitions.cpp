@@ -4,7 +4,7 @@
 
 CustomWeakFormPoisson::CustomWeakFormPoisson(std::string mat_al, Hermes1DFunction<double>* lambda_al,
                                              std::string mat_cu, Hermes1DFunction<double>* lambda_cu,
-                                             Hermes2DFunction<double>* src_term) : WeakForm<double>(1)
+                                             Hermes2DFunction<double>* src_term) : WeakForm<double>(1), lambda_table(NULL), src_term(NULL)
 {
   // Jacobian forms.
   add_matrix_form(new DefaultJacobianDiffusion<double>(0, 0, mat_al, lambda_al));
@@ -15,3 +15,61 @@ CustomWeakFormPoisson::CustomWeakFormPoisson(std::string mat_al, Hermes1DFunctio
   add_vector_form(new DefaultResidualDiffusion<double>(0, mat_cu, lambda_cu));
   add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, src_term));
 };
+
+CustomWeakFormPoisson::CustomWeakFormPoisson(Mesh* mesh, const std::map<std::string, double>& lambda,
+                                             Hermes2DFunction<double>* src_term) : WeakForm<double>(1), src_term(src_term)
+{
+  // The conductivity of an element is looked up by its marker.
+  lambda_table = new MarkerCoefficientTable<double>(mesh, lambda);
+
+  // Jacobian forms.
+  add_matrix_form(new MarkerTableJacobianDiffusion<double>(0, 0, lambda_table));
+
+  // Residual forms.
+  add_vector_form(new MarkerTableResidualDiffusion<double>(0, lambda_table));
+  add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, src_term));
+}
+
+CustomWeakFormPoisson::~CustomWeakFormPoisson()
+{
+  delete lambda_table;
+  delete src_term;
+}
+
+/* Parameter sweep */
+
+PoissonSweep::PoissonSweep(Mesh* mesh, const Space<double>* space, const char* filename) 
+  : ParameterSweep(space), mesh(mesh)
+{
+  std::vector<std::vector<double> > sets = read_sets(filename, 3, "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC");
+  for (unsigned int i = 0; i < sets.size(); i++)
+  {
+    lambda_al.push_back(sets[i][0]);
+    lambda_cu.push_back(sets[i][1]);
+    heat_src.push_back(sets[i][2]);
+  }
+}
+
+int PoissonSweep::get_num_sets() const
+{
+  return lambda_al.size();
+}
+
+WeakForm<double>* PoissonSweep::create_weak_form(int index)
+{
+  std::map<std::string, double> lambda;
+  lambda["Aluminum"] = lambda_al[index];
+  lambda["Copper"] = lambda_cu[index];
+  return new CustomWeakFormPoisson(mesh, lambda, new Hermes2DFunction<double>(-heat_src[index]));
+}
+
+void PoissonSweep::process_solution(int index, const double* coeff_vec)
+{
+  Solution<double> sln;
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+
+  char filename[100];
+  sprintf(filename, "sln-%d.xml", index);
+  sln.save(filename);
+  this->info("Parameter set %d solved, solution saved to %s.", index, filename);
+}
@@ -1,4 +1,6 @@
 #include "hermes2d.h"
+#include "marker_table_forms.h"
+#include "parameter_sweep.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -13,4 +15,38 @@ public:
   CustomWeakFormPoisson(std::string mat_al, Hermes1DFunction<double>* lambda_al,
                         std::string mat_cu, Hermes1DFunction<double>* lambda_cu,
                         Hermes2DFunction<double>* src_term);
+
+  /// One diffusion form for all materials, 'lambda' maps the element
+  /// markers of the mesh to the thermal conductivity. The weak form takes
+  /// over 'src_term' and deletes it.
+  CustomWeakFormPoisson(Mesh* mesh, const std::map<std::string, double>& lambda,
+                        Hermes2DFunction<double>* src_term);
+
+  virtual ~CustomWeakFormPoisson();
+
+protected:
+  MarkerCoefficientTable<double>* lambda_table;
+  // Owned, only set by the marker table constructor.
+  Hermes2DFunction<double>* src_term;
+};
+
+/* Parameter sweep */
+
+// Solves the problem for the parameter sets listed in a file, one set
+// "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC" per line ('#' starts a comment),
+// and saves the solution of the set i to the file sln-i.xml.
+
+class PoissonSweep : public ParameterSweep
+{
+public:
+  PoissonSweep(Mesh* mesh, const Space<double>* space, const char* filename);
+
+  int get_num_sets() const;
+
+protected:
+  virtual WeakForm<double>* create_weak_form(int index);
+  virtual void process_solution(int index, const double* coeff_vec);
+
+  Mesh* mesh;
+  std::vector<double> lambda_al, lambda_cu, heat_src;
 };
@@ -1,5 +1,7 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "solution_output.h"
 
 // This example shows how to solve a simple PDE that describes stationary 
 // heat transfer in an object consisting of two materials (aluminum and 
@@ -28,13 +30,21 @@
 // Read the original or XML mesh file.
 const bool USE_XML_FORMAT = true;                 
 // Set to "false" to suppress Hermes OpenGL visualization. 
-const bool HERMES_VISUALIZATION = true;           
+bool HERMES_VISUALIZATION = true;           
 // Set to "true" to enable VTK output.
-const bool VTK_VISUALIZATION = true;              
+bool VTK_VISUALIZATION = true;              
+// Format of the VTK output: 0 = legacy ASCII (.vtk), 1 = binary VTU, 
+// 2 = zlib-compressed VTU, 3 = XDMF + HDF5 (see common/solution_output.h).
+int VTK_FORMAT = 0;
 // Uniform polynomial degree of mesh elements.
-const int P_INIT = 5;                             
+int P_INIT = 5;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 0;                       
+int INIT_REF_NUM = 0;                       
+// Parameter sweep: file with one set "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC" per 
+// line. If set, all sets are solved on the same space and the program ends.
+std::string SWEEP_FILE = "";
+// Number of threads solving the parameter sets.
+int SWEEP_THREADS = 1;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -51,6 +61,22 @@ const double FIXED_BDY_TEMP = 20.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("VTK_FORMAT", VTK_FORMAT);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("SWEEP_FILE", SWEEP_FILE);
+  parameters.get("SWEEP_THREADS", SWEEP_THREADS);
+  parameters.check_unused();
+
+  // Binary output format (VTK_FORMAT 0 selects the legacy output below).
+  SolutionOutput::Format output_format = SolutionOutput::FORMAT_VTU;
+  if (VTK_FORMAT != 0)
+    output_format = SolutionOutput::get_format(VTK_FORMAT);
+
   // Load the mesh.
   Mesh mesh;
   if (USE_XML_FORMAT == true)
@@ -77,10 +103,12 @@ int main(int argc, char* argv[])
   for (int i = 0; i < INIT_REF_NUM; i++) 
     mesh.refine_all_elements();
 
-  // Initialize the weak formulation.
-  CustomWeakFormPoisson wf("Aluminum", new Hermes1DFunction<double>(LAMBDA_AL), 
-                           "Copper", new Hermes1DFunction<double>(LAMBDA_CU), 
-                           new Hermes2DFunction<double>(-VOLUME_HEAT_SRC));
+  // Initialize the weak formulation. The thermal conductivity is given
+  // per material, one diffusion form covers all of them.
+  std::map<std::string, double> lambda;
+  lambda["Aluminum"] = LAMBDA_AL;
+  lambda["Copper"] = LAMBDA_CU;
+  CustomWeakFormPoisson wf(&mesh, lambda, new Hermes2DFunction<double>(-VOLUME_HEAT_SRC));
   
   // Initialize essential boundary conditions.
   DefaultEssentialBCConst<double> bc_essential(
@@ -92,19 +120,27 @@ int main(int argc, char* argv[])
   int ndof = space.get_num_dofs();
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
+  // Parameter sweep (optional): the matrix structure and the symbolic 
+  // factorization are reused for all parameter sets.
+  if (!SWEEP_FILE.empty())
+  {
+    PoissonSweep sweep(&mesh, &space, SWEEP_FILE.c_str());
+    sweep.run(sweep.get_num_sets(), SWEEP_THREADS);
+    return 0;
+  }
+
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, &space);
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
+  // Initialize the linear solver. The problem is linear, so the matrix and
+  // the right-hand side are assembled together in one pass over the elements
+  // and the system is solved once, without the Newton's residual check.
+  Hermes::Hermes2D::LinearSolver<double> linear_solver(&dp);
 
-  // Perform Newton's iteration.
+  // Solve the linear system.
   try
   {
-    // When newton.solve() is used without any parameters, this means that the initial coefficient 
-    // vector will be the zero vector, tolerance will be 1e-8, maximum allowed number of iterations 
-    // will be 100, and residual will be measured using Euclidean vector norm.
-    newton.solve();
+    linear_solver.solve();
   }
   catch(std::exception& e)
   {
@@ -114,10 +150,17 @@ int main(int argc, char* argv[])
 
   // Translate the resulting coefficient vector into a Solution.
   Solution<double> sln;
-  Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space, &sln);
 
   // VTK output.
-  if (VTK_VISUALIZATION) 
+  if (VTK_VISUALIZATION && VTK_FORMAT > 0) 
+  {
+    // Binary output, the files get the extension of the format.
+    SolutionOutput output(output_format);
+    output.save_solution(&sln, "sln", "Temperature");
+    output.save_orders(&space, "ord");
+  }
+  else if (VTK_VISUALIZATION) 
   {
     // Output solution in VTK format.
     Linearizer lin;
@@ -0,0 +1,97 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+#include "marker_table_forms.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// Checks that the marker-table forms of every block use their own solution
+// component. Two decoupled Poisson problems with the sources 1 and 2 are
+// solved on two copies of the same space by the Newton's method (which
+// evaluates the residual forms at a nonzero solution), so the second
+// component has to be exactly twice the first one.
+//
+// Usage: test-A-03-poisson-marker-table domain.mesh
+
+class TwoComponentWeakForm : public WeakForm<double>
+{
+public:
+  TwoComponentWeakForm(const MarkerCoefficientTable<double>* lambda) : WeakForm<double>(2), src_0(-1.0), src_1(-2.0)
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      add_matrix_form(new MarkerTableJacobianDiffusion<double>(i, i, lambda));
+      add_vector_form(new MarkerTableResidualDiffusion<double>(i, lambda));
+    }
+    add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, &src_0));
+    add_vector_form(new DefaultVectorFormVol<double>(1, HERMES_ANY, &src_1));
+  }
+
+protected:
+  Hermes2DFunction<double> src_0, src_1;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s domain.mesh\n", argv[0]);
+    return -1;
+  }
+
+  // Load the mesh of the example.
+  Mesh mesh;
+  MeshReaderH2D mloader;
+  mloader.load(argv[1], &mesh);
+  mesh.refine_all_elements();
+
+  // Different conductivities of the two materials.
+  std::map<std::string, double> lambda;
+  lambda["Aluminum"] = 236.0;
+  lambda["Copper"] = 386.0;
+  MarkerCoefficientTable<double> lambda_table(&mesh, lambda);
+  TwoComponentWeakForm wf(&lambda_table);
+
+  // The same space for both components.
+  DefaultEssentialBCConst<double> bc_essential(Hermes::vector<std::string>("Bottom", "Inner", "Outer", "Left"), 0.0);
+  EssentialBCs<double> bcs(&bc_essential);
+  H1Space<double> space_0(&mesh, &bcs, 3);
+  H1Space<double> space_1(&mesh, &bcs, 3);
+  Hermes::vector<const Space<double>*> spaces(&space_0, &space_1);
+  int ndof = space_0.get_num_dofs();
+
+  // Newton's method from a nonzero initial guess.
+  DiscreteProblem<double> dp(&wf, spaces);
+  NewtonSolver<double> newton(&dp);
+  newton.set_newton_tol(1e-10);
+  newton.set_newton_max_iter(10);
+  std::vector<double> coeff_vec(2 * ndof, 1.0);
+  try
+  {
+    newton.solve(&coeff_vec[0]);
+  }
+  catch(std::exception& e)
+  {
+    std::cout << e.what();
+    printf("Failure!\n");
+    return -1;
+  }
+
+  const double* sln_vector = newton.get_sln_vector();
+  double max_value = 0, max_difference = 0;
+  for (int i = 0; i < ndof; i++)
+  {
+    max_value = std::max(max_value, std::abs(sln_vector[i]));
+    max_difference = std::max(max_difference, std::abs(sln_vector[ndof + i] - 2 * sln_vector[i]));
+  }
+  Hermes::Mixins::Loggable::Static::info("max |u_0| = %g, max |u_1 - 2 u_0| = %g.", max_value, max_difference);
+
+  if (max_value > 0 && max_difference < 1e-8 * max_value)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 // This example shows how to use Neumann boundary conditions 
 // (prescibed boundary flux).
@@ -17,13 +18,13 @@
 // Read the original or XML mesh file.
 const bool USE_XML_FORMAT = true;                 
 // Set to "false" to suppress Hermes OpenGL visualization. 
-const bool HERMES_VISUALIZATION = true;           
+bool HERMES_VISUALIZATION = true;           
 // Set to "true" to enable VTK output.
-const bool VTK_VISUALIZATION = false;              
+bool VTK_VISUALIZATION = false;              
 // Uniform polynomial degree of mesh elements.
-const int P_INIT = 5;                             
+int P_INIT = 5;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 0;                       
+int INIT_REF_NUM = 0;                       
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -43,6 +44,14 @@ const double BDY_C_PARAM = 20.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   if (USE_XML_FORMAT == true)
@@ -80,13 +89,13 @@ int main(int argc, char* argv[])
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, &space);
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
+  // Initialize linear solver.
+  Hermes::Hermes2D::LinearSolver<double> linear_solver(&dp);
 
-  // Perform Newton's iteration.
+  // Solve the linear system.
   try
   {
-    newton.solve();
+    linear_solver.solve();
   }
   catch(std::exception& e)
   {
@@ -96,7 +105,7 @@ int main(int argc, char* argv[])
 
   // Translate the resulting coefficient vector into a Solution.
   Solution<double> sln;
-  Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space, &sln);
 
   // VTK output.
   if (VTK_VISUALIZATION) 
@@ -42,3 +42,49 @@ double CustomDirichletCondition::value(double x, double y, double n_x, double n_
   return A*x + B*y + C;
 }
 
+/* Parameter sweep */
+
+NewtonSweep::NewtonSweep(const Space<double>* space, const char* filename, std::string bdy_heat_flux,
+                         double alpha, double t_exterior)
+  : ParameterSweep(space), bdy_heat_flux(bdy_heat_flux), alpha(alpha), t_exterior(t_exterior)
+{
+  std::vector<std::vector<double> > sets = read_sets(filename, 3, "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC");
+  for (unsigned int i = 0; i < sets.size(); i++)
+  {
+    lambda_al.push_back(new Hermes1DFunction<double>(sets[i][0]));
+    lambda_cu.push_back(new Hermes1DFunction<double>(sets[i][1]));
+    vol_src_term.push_back(new Hermes2DFunction<double>(-sets[i][2]));
+  }
+}
+
+NewtonSweep::~NewtonSweep()
+{
+  for (unsigned int i = 0; i < lambda_al.size(); i++)
+  {
+    delete lambda_al[i];
+    delete lambda_cu[i];
+    delete vol_src_term[i];
+  }
+}
+
+int NewtonSweep::get_num_sets() const
+{
+  return lambda_al.size();
+}
+
+WeakForm<double>* NewtonSweep::create_weak_form(int index)
+{
+  return new CustomWeakFormPoissonNewton("Aluminum", lambda_al[index], "Copper", lambda_cu[index],
+                                         vol_src_term[index], bdy_heat_flux, alpha, t_exterior);
+}
+
+void NewtonSweep::process_solution(int index, const double* coeff_vec)
+{
+  Solution<double> sln;
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+
+  char filename[100];
+  sprintf(filename, "sln-%d.xml", index);
+  sln.save(filename);
+  this->info("Parameter set %d solved, solution saved to %s.", index, filename);
+}
@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "parameter_sweep.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -31,3 +32,29 @@ public:
     double A, B, C;
 };
 
+/* Parameter sweep */
+
+// Solves the problem for the parameter sets listed in a file, one set
+// "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC" per line ('#' starts a comment),
+// and saves the solution of the set i to the file sln-i.xml. The Newton
+// boundary condition (alpha, t_exterior) is the same for all sets.
+
+class NewtonSweep : public ParameterSweep
+{
+public:
+  NewtonSweep(const Space<double>* space, const char* filename, std::string bdy_heat_flux,
+              double alpha, double t_exterior);
+  virtual ~NewtonSweep();
+
+  int get_num_sets() const;
+
+protected:
+  virtual WeakForm<double>* create_weak_form(int index);
+  virtual void process_solution(int index, const double* coeff_vec);
+
+  std::string bdy_heat_flux;
+  double alpha, t_exterior;
+  // The coefficients of every set, owned (the weak forms keep pointers).
+  std::vector<Hermes1DFunction<double>*> lambda_al, lambda_cu;
+  std::vector<Hermes2DFunction<double>*> vol_src_term;
+};
@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 // This example shows how to use Newton (Robin) boundary conditions.
 // These conditions are used, for example, in heat transfer problems 
@@ -19,13 +20,18 @@
 // Read original or XML mesh file.
 const bool USE_XML_FORMAT = true;                 
 // Set to "false" to suppress Hermes OpenGL visualization.
-const bool HERMES_VISUALIZATION = true;            
+bool HERMES_VISUALIZATION = true;            
 // Set to "true" to enable VTK output.
-const bool VTK_VISUALIZATION = false;              
+bool VTK_VISUALIZATION = false;              
 // Uniform polynomial degree of mesh elements.
-const int P_INIT = 5;                             
+int P_INIT = 5;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 0;                       
+int INIT_REF_NUM = 0;                       
+// Parameter sweep: file with one set "LAMBDA_AL LAMBDA_CU VOLUME_HEAT_SRC" per 
+// line. If set, all sets are solved on the same space and the program ends.
+std::string SWEEP_FILE = "";
+// Number of threads solving the parameter sets.
+int SWEEP_THREADS = 1;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -47,6 +53,16 @@ const double BDY_C_PARAM = 20.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("SWEEP_FILE", SWEEP_FILE);
+  parameters.get("SWEEP_THREADS", SWEEP_THREADS);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   if (USE_XML_FORMAT == true)
@@ -81,16 +97,25 @@ int main(int argc, char* argv[])
   int ndof = space.get_num_dofs();
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
+  // Parameter sweep (optional): the matrix structure and the symbolic 
+  // factorization are reused for all parameter sets.
+  if (!SWEEP_FILE.empty())
+  {
+    NewtonSweep sweep(&space, SWEEP_FILE.c_str(), "Outer", ALPHA, T_EXTERIOR);
+    sweep.run(sweep.get_num_sets(), SWEEP_THREADS);
+    return 0;
+  }
+
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, &space);
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
+  // Initialize linear solver.
+  Hermes::Hermes2D::LinearSolver<double> linear_solver(&dp);
 
-  // Perform Newton's iteration.
+  // Solve the linear system.
   try
   {
-    newton.solve();
+    linear_solver.solve();
   }
   catch(std::exception& e)
   {
@@ -100,7 +125,7 @@ int main(int argc, char* argv[])
 
   // Translate the resulting coefficient vector into a Solution.
   Solution<double> sln;
-  Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space, &sln);
 
   // VTK output.
   if (VTK_VISUALIZATION) 
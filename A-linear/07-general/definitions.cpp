@@ -1,35 +1,29 @@
 #include "definitions.h"
 
-/* Global functions */
+/* Non-constant coefficients */
 
-double a_11(double x, double y) 
-{ 
-  if (y > 0) return 1 + x*x + y*y; 
-  else return 1;
-}
-double a_22(double x, double y) 
-{ 
-  if (y > 0) return 1; else return 1 + x*x + y*y;
-}
-double a_12(double x, double y) 
-{ 
-  return 1; 
-}
-double a_21(double x, double y) 
-{ 
-  return 1;
-}
-double a_1(double x, double y) 
-{ 
-  return 0.0;
+void CoefficientA11::eval(int n, const double* x, const double* y, double* out) const
+{
+  for (int i = 0; i < n; i++)
+  {
+    double r = x[i]*x[i] + y[i]*y[i];
+    out[i] = 1 + (y[i] > 0 ? r : 0.0);
+  }
 }
-double a_2(double x, double y) 
-{ 
-  return 0.0;
+
+void CoefficientA22::eval(int n, const double* x, const double* y, double* out) const
+{
+  for (int i = 0; i < n; i++)
+  {
+    double r = x[i]*x[i] + y[i]*y[i];
+    out[i] = 1 + (y[i] > 0 ? 0.0 : r);
+  }
 }
-double a_0(double x, double y) 
-{ 
-  return 0.0;
+
+void CustomRightHandSide::eval(int n, const double* x, const double* y, double* out) const
+{
+  for (int i = 0; i < n; i++)
+    out[i] = 1 + x[i]*x[i] + y[i]*y[i];
 }
 
 /* Custom non-constant Dirichlet condition */
@@ -50,20 +44,54 @@ double CustomEssentialBCNonConst::value(double x, double y, double n_x, double n
 
 /* Weak forms */
 
-CustomWeakFormGeneral::CustomWeakFormGeneral(std::string bdy_vertical) : WeakForm<double>(1)
+CustomWeakFormGeneral::CustomWeakFormGeneral(std::string bdy_vertical, QuadratureCalibration* calibration) 
+  : WeakForm<double>(1)
 {
-  // Jacobian forms - volumetric.
-  add_matrix_form(new MatrixFormVolGeneral(0, 0));
-
-  // Residual forms - volumetric.
-  add_vector_form(new VectorFormVolGeneral(0));
+  // Equation coefficients.
+  coeffs.a_11 = new CoefficientA11;
+  coeffs.a_12 = new ConstantBatchCoefficient(1.0);
+  coeffs.a_21 = new ConstantBatchCoefficient(1.0);
+  coeffs.a_22 = new CoefficientA22;
+  coeffs.a_1 = new ConstantBatchCoefficient(0.0);
+  coeffs.a_2 = new ConstantBatchCoefficient(0.0);
+  coeffs.a_0 = new ConstantBatchCoefficient(0.0);
+  coeffs.rhs = new CustomRightHandSide;
+
+  if (calibration == NULL)
+  {
+    // Jacobian forms - volumetric.
+    add_matrix_form(new MatrixFormVolGeneral(0, 0, &coeffs));
+
+    // Residual forms - volumetric.
+    add_vector_form(new VectorFormVolGeneral(0, &coeffs));
+  }
+  else
+  {
+    // The same forms, with calibrated integration orders.
+    add_matrix_form(new OrderCalibratedMatrixForm<MatrixFormVolGeneral>(MatrixFormVolGeneral(0, 0, &coeffs), 
+                                                                        calibration->add_form("jacobian")));
+    add_vector_form(new OrderCalibratedVectorForm<VectorFormVolGeneral>(VectorFormVolGeneral(0, &coeffs), 
+                                                                        calibration->add_form("residual")));
+  }
 
   // Residual forms - surface.
   add_vector_form_surf(new VectorFormSurfGeneral(0, bdy_vertical));
 }
 
-CustomWeakFormGeneral::MatrixFormVolGeneral::MatrixFormVolGeneral(int i, int j) 
-  : MatrixFormVol<double>(i, j) 
+CustomWeakFormGeneral::~CustomWeakFormGeneral()
+{
+  delete coeffs.a_11;
+  delete coeffs.a_12;
+  delete coeffs.a_21;
+  delete coeffs.a_22;
+  delete coeffs.a_1;
+  delete coeffs.a_2;
+  delete coeffs.a_0;
+  delete coeffs.rhs;
+}
+
+CustomWeakFormGeneral::MatrixFormVolGeneral::MatrixFormVolGeneral(int i, int j, const Coefficients* coeffs) 
+  : MatrixFormVol<double>(i, j), coeffs(coeffs)
 { 
   this->setSymFlag(HERMES_SYM);
 }
@@ -71,17 +99,36 @@ CustomWeakFormGeneral::MatrixFormVolGeneral::MatrixFormVolGeneral(int i, int j)
 double CustomWeakFormGeneral::MatrixFormVolGeneral::value(int n, double *wt, Func<double> *u_ext[], Func<double> *u, 
                                                           Func<double> *v, Geom<double> *e, Func<double> **ext) const 
 {
+  // Coefficient values in a chunk of integration points.
+  double a_11[COEFFICIENT_BATCH_SIZE], a_12[COEFFICIENT_BATCH_SIZE], a_21[COEFFICIENT_BATCH_SIZE], 
+         a_22[COEFFICIENT_BATCH_SIZE], a_1[COEFFICIENT_BATCH_SIZE], a_2[COEFFICIENT_BATCH_SIZE], 
+         a_0[COEFFICIENT_BATCH_SIZE];
+
   double result = 0;
-  for (int i=0; i < n; i++) {
-    double x = e->x[i];
-    double y = e->y[i];
-    result += (a_11(x, y) * u->dx[i] * v->dx[i] +
-               a_12(x, y) * u->dy[i] * v->dx[i] +
-               a_21(x, y) * u->dx[i] * v->dy[i] +
-               a_22(x, y) * u->dy[i] * v->dy[i] +
-               a_1(x, y) * u->dx[i] * v->val[i] +
-               a_2(x, y) * u->dy[i] * v->val[i] +
-               a_0(x, y) * u->val[i] * v->val[i]) * wt[i];
+  for (int start = 0; start < n; start += COEFFICIENT_BATCH_SIZE)
+  {
+    int m = std::min(COEFFICIENT_BATCH_SIZE, n - start);
+    const double* x = e->x + start;
+    const double* y = e->y + start;
+    coeffs->a_11->eval(m, x, y, a_11);
+    coeffs->a_12->eval(m, x, y, a_12);
+    coeffs->a_21->eval(m, x, y, a_21);
+    coeffs->a_22->eval(m, x, y, a_22);
+    coeffs->a_1->eval(m, x, y, a_1);
+    coeffs->a_2->eval(m, x, y, a_2);
+    coeffs->a_0->eval(m, x, y, a_0);
+
+    const double *w = wt + start, 
+                 *u_val = u->val + start, *u_dx = u->dx + start, *u_dy = u->dy + start,
+                 *v_val = v->val + start, *v_dx = v->dx + start, *v_dy = v->dy + start;
+    for (int i = 0; i < m; i++)
+      result += (a_11[i] * u_dx[i] * v_dx[i] +
+                 a_12[i] * u_dy[i] * v_dx[i] +
+                 a_21[i] * u_dx[i] * v_dy[i] +
+                 a_22[i] * u_dy[i] * v_dy[i] +
+                 a_1[i] * u_dx[i] * v_val[i] +
+                 a_2[i] * u_dy[i] * v_val[i] +
+                 a_0[i] * u_val[i] * v_val[i]) * w[i];
   }
   return result;
 }
@@ -95,28 +142,49 @@ Ord CustomWeakFormGeneral::MatrixFormVolGeneral::ord(int n, double *wt, Func<Ord
 
 MatrixFormVol<double>* CustomWeakFormGeneral::MatrixFormVolGeneral::clone() const
 {
-  return new MatrixFormVolGeneral(this->i, this->j);
+  return new MatrixFormVolGeneral(this->i, this->j, coeffs);
 }
 
-CustomWeakFormGeneral::VectorFormVolGeneral::VectorFormVolGeneral(int i) : VectorFormVol<double>(i) 
+CustomWeakFormGeneral::VectorFormVolGeneral::VectorFormVolGeneral(int i, const Coefficients* coeffs) 
+  : VectorFormVol<double>(i), coeffs(coeffs)
 { 
 }
 
 double CustomWeakFormGeneral::VectorFormVolGeneral::value(int n, double *wt, Func<double> *u_ext[], Func<double> *v, 
                                                           Geom<double> *e, Func<double> **ext) const 
 {
+  // Coefficient values in a chunk of integration points.
+  double a_11[COEFFICIENT_BATCH_SIZE], a_12[COEFFICIENT_BATCH_SIZE], a_21[COEFFICIENT_BATCH_SIZE], 
+         a_22[COEFFICIENT_BATCH_SIZE], a_1[COEFFICIENT_BATCH_SIZE], a_2[COEFFICIENT_BATCH_SIZE], 
+         a_0[COEFFICIENT_BATCH_SIZE], rhs[COEFFICIENT_BATCH_SIZE];
+
   double result = 0;
-  for (int i = 0; i < n; i++) {
-    double x = e->x[i];
-    double y = e->y[i];
-    result += wt[i] * (a_11(x, y) * u_ext[0]->dx[i] * v->dx[i] +
-                       a_12(x, y) * u_ext[0]->dy[i] * v->dx[i] +
-                       a_21(x, y) * u_ext[0]->dx[i] * v->dy[i] +
-                       a_22(x, y) * u_ext[0]->dy[i] * v->dy[i] +
-                       a_1(x, y) * u_ext[0]->dx[i] * v->val[i] +
-                       a_2(x, y) * u_ext[0]->dy[i] * v->val[i] +
-                       a_0(x, y) * u_ext[0]->val[i] * v->val[i]);
-    result -= wt[i] * rhs(e->x[i], e->y[i]) * v->val[i];
+  for (int start = 0; start < n; start += COEFFICIENT_BATCH_SIZE)
+  {
+    int m = std::min(COEFFICIENT_BATCH_SIZE, n - start);
+    const double* x = e->x + start;
+    const double* y = e->y + start;
+    coeffs->a_11->eval(m, x, y, a_11);
+    coeffs->a_12->eval(m, x, y, a_12);
+    coeffs->a_21->eval(m, x, y, a_21);
+    coeffs->a_22->eval(m, x, y, a_22);
+    coeffs->a_1->eval(m, x, y, a_1);
+    coeffs->a_2->eval(m, x, y, a_2);
+    coeffs->a_0->eval(m, x, y, a_0);
+    coeffs->rhs->eval(m, x, y, rhs);
+
+    const double *w = wt + start, 
+                 *u_val = u_ext[0]->val + start, *u_dx = u_ext[0]->dx + start, *u_dy = u_ext[0]->dy + start,
+                 *v_val = v->val + start, *v_dx = v->dx + start, *v_dy = v->dy + start;
+    for (int i = 0; i < m; i++)
+      result += w[i] * (a_11[i] * u_dx[i] * v_dx[i] +
+                        a_12[i] * u_dy[i] * v_dx[i] +
+                        a_21[i] * u_dx[i] * v_dy[i] +
+                        a_22[i] * u_dy[i] * v_dy[i] +
+                        a_1[i] * u_dx[i] * v_val[i] +
+                        a_2[i] * u_dy[i] * v_val[i] +
+                        a_0[i] * u_val[i] * v_val[i] -
+                        rhs[i] * v_val[i]);
   }
   return result;
 }
@@ -130,12 +198,7 @@ Ord CustomWeakFormGeneral::VectorFormVolGeneral::ord(int n, double *wt, Func<Ord
 
 VectorFormVol<double>* CustomWeakFormGeneral::VectorFormVolGeneral::clone() const
 {
-  return new VectorFormVolGeneral(this->i);
-}
-
-double CustomWeakFormGeneral::VectorFormVolGeneral::rhs(double x, double y) const 
-{ 
-  return 1 + x*x + y*y;
+  return new VectorFormVolGeneral(this->i, coeffs);
 }
 
 CustomWeakFormGeneral::VectorFormSurfGeneral::VectorFormSurfGeneral(int i, std::string area) 
@@ -1,4 +1,7 @@
 #include "hermes2d.h"
+#include "batch_coefficient.h"
+#include "quadrature_calibration.h"
+#include "cached_bc_space.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -18,18 +21,52 @@ public:
                        double t_x, double t_y) const;
 };
 
+/* Non-constant coefficients */
+
+// Evaluated in all integration points at once, the condition y > 0 is
+// written as a select so that the loops vectorize.
+
+class CoefficientA11 : public BatchCoefficient
+{
+public:
+  virtual void eval(int n, const double* x, const double* y, double* out) const;
+};
+
+class CoefficientA22 : public BatchCoefficient
+{
+public:
+  virtual void eval(int n, const double* x, const double* y, double* out) const;
+};
+
+class CustomRightHandSide : public BatchCoefficient
+{
+public:
+  virtual void eval(int n, const double* x, const double* y, double* out) const;
+};
+
 /* Weak forms */
 
 class CustomWeakFormGeneral : public WeakForm<double> 
 {
 public:
-  CustomWeakFormGeneral(std::string bdy_vertical);
+  /// With 'calibration', the volumetric forms take part in the quadrature
+  /// order calibration.
+  CustomWeakFormGeneral(std::string bdy_vertical, QuadratureCalibration* calibration = NULL);
+  virtual ~CustomWeakFormGeneral();
+
+  // Equation coefficients, shared by the forms.
+  struct Coefficients
+  {
+    BatchCoefficient *a_11, *a_12, *a_21, *a_22, *a_1, *a_2, *a_0, *rhs;
+  };
 
 private:
+  Coefficients coeffs;
+
   class MatrixFormVolGeneral : public MatrixFormVol<double> 
   {
   public:
-    MatrixFormVolGeneral(int i, int j);
+    MatrixFormVolGeneral(int i, int j, const Coefficients* coeffs);
 
     virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u, 
                          Func<double> *v, Geom<double> *e, Func<double> **ext) const;
@@ -38,12 +75,14 @@ private:
                     Geom<Ord> *e, Func<Ord> **ext) const;
 
     MatrixFormVol<double>* clone() const;
+  private:
+    const Coefficients* coeffs;
   };
 
   class VectorFormVolGeneral : public VectorFormVol<double> 
   {
   public:
-    VectorFormVolGeneral(int i);
+    VectorFormVolGeneral(int i, const Coefficients* coeffs);
 
     virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *v, 
                          Geom<double> *e, Func<double> **ext) const;
@@ -53,7 +92,7 @@ private:
 
     VectorFormVol<double>* clone() const;
   private:
-    double rhs(double x, double y) const;
+    const Coefficients* coeffs;
   };
 
   class VectorFormSurfGeneral : public VectorFormSurf<double> 
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 //  This example solves a general second-order linear equation with non-constant
 //  coefficients, and shows how integration orders in linear and bilinear forms
@@ -19,16 +20,36 @@
 
 // Read the original or XML mesh file.
 const bool USE_XML_FORMAT = true;                 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 3;                             
+int P_INIT = 3;                             
 // Number of initial uniform refinements.
-const int INIT_REF_NUM = 3;                       
+int INIT_REF_NUM = 3;                       
+// Determine the lowest sufficient integration orders of the volumetric forms
+// before solving and use them (see common/quadrature_calibration.h).
+bool CALIBRATE_QUADRATURE = false;
+// Relative tolerance of the element integrals for the calibration.
+double QUADRATURE_TOL = 1e-10;
+// Upper limit of the integration order of the volumetric forms, also without
+// the calibration (-1 = no limit).
+int QUAD_ORDER_CAP = -1;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("CALIBRATE_QUADRATURE", CALIBRATE_QUADRATURE);
+  parameters.get("QUADRATURE_TOL", QUADRATURE_TOL);
+  parameters.get("QUAD_ORDER_CAP", QUAD_ORDER_CAP);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -55,24 +76,35 @@ int main(int argc, char* argv[])
   CustomEssentialBCNonConst bc_essential("Horizontal");
   EssentialBCs<double> bcs(&bc_essential);
 
-  // Create an H1 space with default shapeset.
-  H1Space<double> space(&mesh, &bcs, P_INIT);
+  // Create an H1 space with default shapeset. The projections of the
+  // non-constant Dirichlet condition onto the boundary edges are cached.
+  CachedBCH1Space space(&mesh, &bcs, P_INIT);
   int ndof = space.get_num_dofs();
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
   // Initialize the weak formulation.
-  CustomWeakFormGeneral wf("Horizontal");
+  QuadratureCalibration calibration(QUADRATURE_TOL);
+  calibration.set_cap(QUAD_ORDER_CAP);
+  bool adjust_orders = CALIBRATE_QUADRATURE || QUAD_ORDER_CAP >= 0;
+  CustomWeakFormGeneral wf("Horizontal", adjust_orders ? &calibration : NULL);
+
+  // Calibrate the integration orders (optional).
+  if (CALIBRATE_QUADRATURE)
+  {
+    calibration.run(&wf, &space);
+    calibration.apply();
+  }
 
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, &space);
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
+  // Initialize linear solver.
+  Hermes::Hermes2D::LinearSolver<double> linear_solver(&dp);
 
-  // Perform Newton's iteration.
+  // Solve the linear system.
   try
   {
-    newton.solve();
+    linear_solver.solve();
   }
   catch(std::exception& e)
   {
@@ -82,22 +114,25 @@ int main(int argc, char* argv[])
 
   // Translate the resulting coefficient vector into a Solution.
   Solution<double> sln;
-  Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space, &sln);
 
   // Time measurement.
   cpu_time.tick();
 
-  // View the solution and mesh.
-  ScalarView sview("Solution", new WinGeom(0, 0, 440, 350));
-  sview.show(&sln);
-  OrderView oview("Polynomial orders", new WinGeom(450, 0, 405, 350));
-  oview.show(&space);
-
   // Print timing information.
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    // View the solution and mesh.
+    ScalarView sview("Solution", new WinGeom(0, 0, 440, 350));
+    sview.show(&sln);
+    OrderView oview("Polynomial orders", new WinGeom(450, 0, 405, 350));
+    oview.show(&space);
+
+    // Wait for all views to be closed.
+    View::wait();
+  }
 
   return 0;
 }
@@ -1,5 +1,8 @@
 #include "definitions.h"
 
+#include <fstream>
+#include <sstream>
+
 CustomWeakFormLinearElasticity::CustomWeakFormLinearElasticity(double E, double nu, double rho_g,
                                  std::string surface_force_bdy, double f0, double f1) : WeakForm<double>(2)
 {
@@ -26,3 +29,110 @@ CustomWeakFormLinearElasticity::CustomWeakFormLinearElasticity(double E, double
   // Surface force (second component).
   add_vector_form_surf(new DefaultVectorFormSurf<double>(1, surface_force_bdy, new Hermes2DFunction<double>(-f1))); 
 }
+
+void solve_with_block_matrix(DiscreteProblem<double>* dp, int ndof, double cg_tol, double* sln_vector)
+{
+  // Assemble the Jacobian and the residual at zero.
+  std::vector<double> zero(ndof, 0.0);
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  dp->assemble(&zero[0], matrix, rhs);
+
+  Hermes::Algebra::CSCMatrix<double>* csc = dynamic_cast<Hermes::Algebra::CSCMatrix<double>*>(matrix);
+  if (csc == NULL)
+    throw Hermes::Exceptions::Exception("The block matrix is created from a CSC matrix (SOLVER_UMFPACK).");
+
+  // The unknowns k and ndof/2 + k belong to the same basis function.
+  BlockSparseMatrix block_matrix;
+  block_matrix.create_from_csc(2, ndof, csc->get_Ap(), csc->get_Ai(), csc->get_Ax());
+  Hermes::Mixins::Loggable::Static::info("Scalar matrix: %d nonzeros, %g MB.", (int) csc->get_nnz(), 
+    get_scalar_sparse_memory_size(ndof, csc->get_nnz()) / 1048576.0);
+  Hermes::Mixins::Loggable::Static::info("Block matrix: %d 2x2 blocks, %g MB.", block_matrix.get_num_blocks(), 
+    block_matrix.get_memory_size() / 1048576.0);
+
+  // The solution is the Newton step from zero.
+  std::vector<double> b(ndof);
+  for (int i = 0; i < ndof; i++)
+    b[i] = -rhs->get(i);
+  delete matrix;
+  delete rhs;
+
+  std::fill(sln_vector, sln_vector + ndof, 0.0);
+  int iter = block_matrix.solve_cg(&b[0], sln_vector, cg_tol);
+  if (iter < 0)
+    throw Hermes::Exceptions::Exception("CG did not converge to the tolerance %g.", cg_tol);
+  Hermes::Mixins::Loggable::Static::info("CG converged in %d iterations.", iter);
+}
+
+CustomWeakFormElasticityMatrix::CustomWeakFormElasticityMatrix(double E, double nu) : WeakForm<double>(2)
+{
+  double lambda = (E * nu) / ((1 + nu) * (1 - 2*nu));
+  double mu = E / (2*(1 + nu));
+
+  add_matrix_form(new DefaultJacobianElasticity_0_0<double>(0, 0, lambda, mu));
+  add_matrix_form(new DefaultJacobianElasticity_0_1<double>(0, 1, lambda, mu));
+  add_matrix_form(new DefaultJacobianElasticity_1_1<double>(1, 1, lambda, mu));
+}
+
+CustomWeakFormUnitLoad::CustomWeakFormUnitLoad(int component, std::string bdy) : WeakForm<double>(2)
+{
+  // Same sign as the loads in CustomWeakFormLinearElasticity.
+  if (bdy == HERMES_ANY)
+    add_vector_form(new DefaultVectorFormVol<double>(component, HERMES_ANY, new Hermes2DFunction<double>(-1.0)));
+  else
+    add_vector_form_surf(new DefaultVectorFormSurf<double>(component, bdy, new Hermes2DFunction<double>(-1.0)));
+}
+
+void solve_load_cases(double E, double nu, std::string surface_force_bdy, const char* filename,
+                      Hermes::vector<const Space<double>*> spaces)
+{
+  std::ifstream file(filename);
+  if (!file)
+    throw Hermes::Exceptions::Exception("Unable to open the load case file '%s'.", filename);
+
+  // Factors of the unit loads (surface force x, surface force y, gravity).
+  std::vector<double> factors;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(file, line))
+  {
+    line_number++;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    std::istringstream stream(line);
+    double values[3];
+    if (!(stream >> values[0] >> values[1] >> values[2]))
+      throw Hermes::Exceptions::Exception("Line %d of '%s': expected F0 F1 RHO_G.", line_number, filename);
+    factors.insert(factors.end(), values, values + 3);
+  }
+  int num_cases = factors.size() / 3;
+
+  CustomWeakFormElasticityMatrix wf(E, nu);
+  CustomWeakFormUnitLoad surface_force_x(0, surface_force_bdy);
+  CustomWeakFormUnitLoad surface_force_y(1, surface_force_bdy);
+  CustomWeakFormUnitLoad gravity(1, HERMES_ANY);
+
+  LoadCaseSolver solver(&wf, spaces);
+  solver.add_unit_load(&surface_force_x);
+  solver.add_unit_load(&surface_force_y);
+  solver.add_unit_load(&gravity);
+  solver.prepare();
+
+  std::vector<double> sln_vector(solver.get_num_dofs());
+  for (int index = 0; index < num_cases; index++)
+  {
+    solver.solve(&factors[3 * index], &sln_vector[0]);
+
+    Solution<double> u1_sln, u2_sln;
+    Solution<double>::vector_to_solutions(&sln_vector[0], spaces, Hermes::vector<Solution<double> *>(&u1_sln, &u2_sln));
+
+    char u1_filename[100], u2_filename[100];
+    sprintf(u1_filename, "u1-%d.xml", index);
+    sprintf(u2_filename, "u2-%d.xml", index);
+    u1_sln.save(u1_filename);
+    u2_sln.save(u2_filename);
+  }
+  Hermes::Mixins::Loggable::Static::info("%d load cases solved, solutions saved to u1-*.xml, u2-*.xml.", num_cases);
+}
@@ -1,4 +1,6 @@
 #include "hermes2d.h"
+#include "block_sparse_matrix.h"
+#include "load_case_solver.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -14,3 +16,34 @@ public:
   CustomWeakFormLinearElasticity(double E, double nu, double rho_g,
       std::string surface_force_bdy, double f0, double f1);
 };
+
+/* Load cases */
+
+// Matrix forms of the elasticity operator only.
+class CustomWeakFormElasticityMatrix : public WeakForm<double>
+{
+public:
+  CustomWeakFormElasticityMatrix(double E, double nu);
+};
+
+// Unit load in the equation 'component': a surface force on 'bdy', or a
+// volume force if 'bdy' is HERMES_ANY.
+class CustomWeakFormUnitLoad : public WeakForm<double>
+{
+public:
+  CustomWeakFormUnitLoad(int component, std::string bdy);
+};
+
+// Solves all load cases "F0 F1 RHO_G" (one per line) of the file with one
+// factorization of the matrix and saves the solutions.
+void solve_load_cases(double E, double nu, std::string surface_force_bdy, const char* filename,
+                      Hermes::vector<const Space<double>*> spaces);
+
+/* Block sparse solution */
+
+// Assembles the system in the scalar format, converts it to 2x2 blocks (one
+// per pair of basis functions, coupling both displacement components) and
+// solves it by the block Jacobi preconditioned conjugate gradient method.
+// Both components must use identical spaces. Throws an exception if the
+// conjugate gradient method does not converge.
+void solve_with_block_matrix(DiscreteProblem<double>* dp, int ndof, double cg_tol, double* sln_vector);
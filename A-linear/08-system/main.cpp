@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 // This example explains how to create multiple spaces over a mesh and use them
 // to solve a simple problem of linear elasticity. Note how Tuples are used, 
@@ -19,8 +20,18 @@
 
 // Read original or XML mesh file.
 const bool USE_XML_FORMAT = true;                          
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree of all elements.
-const int P_INIT = 6;                                      
+int P_INIT = 6;                                      
+// Solve the system stored in 2x2 blocks by the conjugate gradient method
+// instead of the direct solver (see common/block_sparse_matrix.h).
+bool USE_BLOCK_MATRIX = false;
+// Relative tolerance of the conjugate gradient method.
+double CG_TOL = 1e-10;
+// Load cases: file with one case "F0 F1 RHO_G" per line. If set, the matrix
+// is factorized once, all cases are solved and the program ends.
+std::string LOAD_CASE_FILE = "";
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;           
@@ -41,6 +52,15 @@ const double f1  = 8e4;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("USE_BLOCK_MATRIX", USE_BLOCK_MATRIX);
+  parameters.get("CG_TOL", CG_TOL);
+  parameters.get("LOAD_CASE_FILE", LOAD_CASE_FILE);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh, mesh1;
   if (USE_XML_FORMAT == true)
@@ -59,9 +79,14 @@ int main(int argc, char* argv[])
   // Perform uniform mesh refinement.
   mesh.refine_all_elements();
 
-  // Show mesh.
-  MeshView mv("Mesh", new WinGeom(0, 0, 580, 400));
-  mv.show(&mesh);
+  // Show mesh (the view is only created with the visualization, it needs
+  // a display).
+  MeshView* mv = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    mv = new MeshView("Mesh", new WinGeom(0, 0, 580, 400));
+    mv->show(&mesh);
+  }
 
   // Initialize boundary conditions.
   DefaultEssentialBCConst<double> zero_disp("Bottom", 0.0);
@@ -73,44 +98,60 @@ int main(int argc, char* argv[])
   int ndof = Space<double>::get_num_dofs(Hermes::vector<const Space<double> *>(&u1_space, &u2_space));
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
+  // Load-case study (optional).
+  if (!LOAD_CASE_FILE.empty())
+  {
+    solve_load_cases(E, nu, "Top", LOAD_CASE_FILE.c_str(), Hermes::vector<const Space<double> *>(&u1_space, &u2_space));
+    return 0;
+  }
+
   // Initialize the weak formulation.
   CustomWeakFormLinearElasticity wf(E, nu, rho*g1, "Top", f0, f1);
 
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, Hermes::vector<const Space<double> *>(&u1_space, &u2_space));
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
-  newton.set_verbose_output(true);
+  // Initialize linear solver.
+  Hermes::Hermes2D::LinearSolver<double> linear_solver(&dp);
+  linear_solver.set_verbose_output(true);
 
-  // Perform Newton's iteration.
+  // Solve the linear system.
+  std::vector<double> block_sln_vector(ndof);
   try
   {
-    newton.solve();
+    if (USE_BLOCK_MATRIX)
+      solve_with_block_matrix(&dp, ndof, CG_TOL, &block_sln_vector[0]);
+    else
+      linear_solver.solve();
   }
   catch(std::exception& e)
   {
+    // No solution to show.
     std::cout << e.what();
-    
+    return -1;
   }
 
   // Translate the resulting coefficient vector into the Solution sln.
   Solution<double> u1_sln, u2_sln;
-  Solution<double>::vector_to_solutions(newton.get_sln_vector(), Hermes::vector<const Space<double> *>(&u1_space, &u2_space), 
-      Hermes::vector<Solution<double> *>(&u1_sln, &u2_sln));
+  Solution<double>::vector_to_solutions(USE_BLOCK_MATRIX ? &block_sln_vector[0] : linear_solver.get_sln_vector(), 
+      Hermes::vector<const Space<double> *>(&u1_space, &u2_space), Hermes::vector<Solution<double> *>(&u1_sln, &u2_sln));
   
   // Visualize the solution.
-  ScalarView view("Von Mises stress [Pa]", new WinGeom(590, 0, 700, 400));
-  // First Lame constant.
-  double lambda = (E * nu) / ((1 + nu) * (1 - 2*nu));  
-  // Second Lame constant.
-  double mu = E / (2*(1 + nu));                        
-  VonMisesFilter stress(Hermes::vector<MeshFunction<double> *>(&u1_sln, &u2_sln), lambda, mu);
-  view.show_mesh(false);
-  view.show(&stress, HERMES_EPS_HIGH, H2D_FN_VAL_0, &u1_sln, &u2_sln, 1.5e5);
-
-  // Wait for the view to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    ScalarView view("Von Mises stress [Pa]", new WinGeom(590, 0, 700, 400));
+    // First Lame constant.
+    double lambda = (E * nu) / ((1 + nu) * (1 - 2*nu));  
+    // Second Lame constant.
+    double mu = E / (2*(1 + nu));                        
+    VonMisesFilter stress(Hermes::vector<MeshFunction<double> *>(&u1_sln, &u2_sln), lambda, mu);
+    view.show_mesh(false);
+    view.show(&stress, HERMES_EPS_HIGH, H2D_FN_VAL_0, &u1_sln, &u2_sln, 1.5e5);
+
+    // Wait for the view to be closed.
+    View::wait();
+  }
+  delete mv;
 
   return 0;
 }
@@ -0,0 +1,113 @@
+#define HERMES_REPORT_ALL
+#include "../definitions.h"
+
+// Checks the block sparse matrix against the scalar CSC matrix it is built
+// from: the block matrix-vector product has to equal the scalar one, a second
+// conversion into the same object must not accumulate the old values, and
+// the block Jacobi CG solution has to match the direct (UMFPACK) solution of
+// the elasticity system of the example.
+//
+// Usage: test-A-08-system-block-matrix domain.mesh
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s domain.mesh\n", argv[0]);
+    return -1;
+  }
+
+  // Load the mesh of the example.
+  Mesh mesh;
+  MeshReaderH2D mloader;
+  mloader.load(argv[1], &mesh);
+  mesh.refine_all_elements();
+
+  DefaultEssentialBCConst<double> zero_disp("Bottom", 0.0);
+  EssentialBCs<double> bcs(&zero_disp);
+  H1Space<double> u1_space(&mesh, &bcs, 4);
+  H1Space<double> u2_space(&mesh, &bcs, 4);
+  Hermes::vector<const Space<double> *> spaces(&u1_space, &u2_space);
+  int ndof = Space<double>::get_num_dofs(spaces);
+
+  CustomWeakFormLinearElasticity wf(200e9, 0.3, 8000.0 * -9.81, "Top", 0.0, 8e4);
+  DiscreteProblem<double> dp(&wf, spaces);
+
+  // Scalar matrix (the default solver is UMFPACK).
+  std::vector<double> zero(ndof, 0.0);
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  dp.assemble(&zero[0], matrix, rhs);
+  Hermes::Algebra::CSCMatrix<double>* csc = dynamic_cast<Hermes::Algebra::CSCMatrix<double>*>(matrix);
+  if (csc == NULL)
+  {
+    printf("Failure! The matrix is not a CSC matrix.\n");
+    return -1;
+  }
+  const int* Ap = csc->get_Ap();
+  const int* Ai = csc->get_Ai();
+  const double* Ax = csc->get_Ax();
+
+  // Block matrix, converted twice into the same object (the products below
+  // would differ if the second conversion accumulated the old values).
+  BlockSparseMatrix block_matrix;
+  block_matrix.create_from_csc(2, ndof, Ap, Ai, Ax);
+  size_t memory_size = block_matrix.get_memory_size();
+  block_matrix.create_from_csc(2, ndof, Ap, Ai, Ax);
+  if (block_matrix.get_memory_size() != memory_size)
+  {
+    printf("Failure! The second conversion changed the size.\n");
+    return -1;
+  }
+
+  // Matrix-vector products with a vector without any symmetry.
+  std::vector<double> x(ndof), y_scalar(ndof, 0.0), y_block(ndof);
+  for (int i = 0; i < ndof; i++)
+    x[i] = std::sin(1.0 + i);
+  for (int col = 0; col < ndof; col++)
+    for (int k = Ap[col]; k < Ap[col + 1]; k++)
+      y_scalar[Ai[k]] += Ax[k] * x[col];
+  block_matrix.multiply(&x[0], &y_block[0]);
+
+  double max_y = 0, max_y_difference = 0;
+  for (int i = 0; i < ndof; i++)
+  {
+    max_y = std::max(max_y, std::abs(y_scalar[i]));
+    max_y_difference = std::max(max_y_difference, std::abs(y_block[i] - y_scalar[i]));
+  }
+  Hermes::Mixins::Loggable::Static::info("max |A x| = %g, max |A_block x - A x| = %g.", max_y, max_y_difference);
+  delete matrix;
+  delete rhs;
+
+  // Direct solution and block CG solution.
+  LinearSolver<double> linear_solver(&dp);
+  std::vector<double> block_sln_vector(ndof);
+  try
+  {
+    linear_solver.solve();
+    solve_with_block_matrix(&dp, ndof, 1e-12, &block_sln_vector[0]);
+  }
+  catch(std::exception& e)
+  {
+    std::cout << e.what();
+    printf("Failure!\n");
+    return -1;
+  }
+
+  const double* sln_vector = linear_solver.get_sln_vector();
+  double max_value = 0, max_difference = 0;
+  for (int i = 0; i < ndof; i++)
+  {
+    max_value = std::max(max_value, std::abs(sln_vector[i]));
+    max_difference = std::max(max_difference, std::abs(block_sln_vector[i] - sln_vector[i]));
+  }
+  Hermes::Mixins::Loggable::Static::info("max |u| = %g, max |u_block - u| = %g.", max_value, max_difference);
+
+  if (max_y > 0 && max_y_difference < 1e-12 * max_y && max_value > 0 && max_difference < 1e-8 * max_value)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "axisym_forms.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
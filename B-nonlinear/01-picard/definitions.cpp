@@ -1,23 +1,7 @@
 #include "definitions.h"
 
-CustomNonlinearity::CustomNonlinearity(double alpha): Hermes1DFunction<double>()
-{
-  this->is_const = false;
-  this->alpha = alpha;
-}
-
-double CustomNonlinearity::value(double u) const
-{
-  return 1 + Hermes::pow(u, alpha);
-}
-
-Ord CustomNonlinearity::value(Ord u) const
-{
-  return Ord(10);
-}
-
 CustomWeakFormPicard::CustomWeakFormPicard(Solution<double>* prev_iter_sln, 
-                                           Hermes1DFunction<double>* lambda, 
+                                           const PowerLawNonlinearity* lambda, 
                                            Hermes2DFunction<double>* f) 
   : WeakForm<double>(1)
 {
@@ -34,10 +18,20 @@ double CustomWeakFormPicard::CustomJacobian::value(int n, double *wt, Func<doubl
                                                    Func<double> *u, Func<double> *v, 
                                                    Geom<double> *e, Func<double> **ext) const
 {
+  // Nonlinearity in a chunk of integration points (the Picard's method
+  // needs no derivative).
+  double val[COEFFICIENT_BATCH_SIZE];
+
   double result = 0;
-  for (int i = 0; i < n; i++) 
+  for (int start = 0; start < n; start += COEFFICIENT_BATCH_SIZE)
   {
-    result += wt[i] * lambda->value(u_ext[0]->val[i]) * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]);
+    int m = std::min(COEFFICIENT_BATCH_SIZE, n - start);
+    lambda->values(m, u_ext[0]->val + start, val);
+    for (int i = 0; i < m; i++) 
+    {
+      int k = start + i;
+      result += wt[k] * val[i] * (u->dx[k] * v->dx[k] + u->dy[k] * v->dy[k]);
+    }
   }
   return result;
 }
@@ -96,3 +90,72 @@ double CustomEssentialBCNonConst::value(double x, double y, double n_x, double n
 {
   return (x+10) * (y+10) / 100.;
 }
+
+void run_solver_benchmark(Mesh* mesh, const Space<double>* space, double init_cond_const,
+                          const PowerLawNonlinearity* lambda, Hermes2DFunction<double>* src,
+                          int anderson_depth, double anderson_beta, double picard_tol,
+                          double newton_tol, int max_iter)
+{
+  int ndof = space->get_num_dofs();
+  ConstantSolution<double> init_sln(mesh, init_cond_const);
+  std::vector<double> init_coeff_vec(ndof), coeff_vec(ndof);
+  OGProjection<double> ogProjection; ogProjection.project_global(space, &init_sln, &init_coeff_vec[0]);
+
+  // The Newton's formulation, also measures the residual of all results.
+  BatchWeakFormPoisson wf_newton(HERMES_ANY, lambda, src);
+  DiscreteProblem<double> dp_newton(&wf_newton, space);
+  ResidualAssembler residual(&dp_newton);
+
+  Hermes::Mixins::TimeMeasurable cpu_time;
+  Hermes::Mixins::Loggable::Static::info("Solver benchmark, ndof: %d", ndof);
+  Hermes::Mixins::Loggable::Static::info("%-28s %9s %9s %9s %12s %10s", "method", "converged", "iters",
+                                         "Jacobians", "residual", "time [s]");
+
+  // Picard's method with Anderson acceleration.
+  {
+    ConstantSolution<double> sln_prev_iter(mesh, init_cond_const);
+    CustomWeakFormPicard wf(&sln_prev_iter, lambda, src);
+    DiscreteProblemLinear<double> dp(&wf, space);
+    AndersonPicardSolver picard(&dp, anderson_depth, anderson_beta);
+    picard.set_tol(picard_tol);
+    picard.set_max_iter(max_iter);
+    std::copy(init_coeff_vec.begin(), init_coeff_vec.end(), coeff_vec.begin());
+
+    cpu_time.tick();
+    bool converged = picard.solve(&coeff_vec[0]);
+    cpu_time.tick();
+    Hermes::Mixins::Loggable::Static::info("%-28s %9s %9d %9d %12g %10g", "Picard + Anderson", converged ? "yes" : "no",
+                                           picard.get_num_iters(), picard.get_num_iters(),
+                                           residual.assemble(&coeff_vec[0]), cpu_time.last());
+  }
+
+  // Newton's method.
+  const char* names[] = { "Newton", "Newton, line search", "Newton, trust region", "chord Newton, line search" };
+  ChordNewtonSolver::Globalization globalizations[] = { ChordNewtonSolver::FULL_STEP, ChordNewtonSolver::LINE_SEARCH,
+                                                        ChordNewtonSolver::TRUST_REGION, ChordNewtonSolver::LINE_SEARCH };
+  double max_contractions[] = { 0.0, 0.0, 0.0, 0.5 };
+  for (int k = 0; k < 4; k++)
+  {
+    ChordNewtonSolver newton(&dp_newton);
+    newton.set_tol(newton_tol);
+    newton.set_max_iter(max_iter);
+    newton.set_globalization(globalizations[k]);
+    newton.set_max_contraction(max_contractions[k]);
+    std::copy(init_coeff_vec.begin(), init_coeff_vec.end(), coeff_vec.begin());
+
+    bool converged = false;
+    cpu_time.tick();
+    try
+    {
+      converged = newton.solve(&coeff_vec[0]);
+    }
+    catch(std::exception& e)
+    {
+      std::cout << e.what();
+    }
+    cpu_time.tick();
+    Hermes::Mixins::Loggable::Static::info("%-28s %9s %9d %9d %12g %10g", names[k], converged ? "yes" : "no",
+                                           newton.get_num_iters(), newton.get_num_jacobian_assemblies(),
+                                           residual.assemble(&coeff_vec[0]), cpu_time.last());
+  }
+}
@@ -1,25 +1,14 @@
 #include "hermes2d.h"
+#include "cached_bc_space.h"
+#include "anderson_acceleration.h"
+#include "chord_newton.h"
+#include "power_law.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
 using namespace Hermes::Hermes2D::WeakFormsH1;
 using namespace Hermes::Hermes2D::Views;
 
-/* Nonlinearity lambda(u) = Hermes::pow(u, alpha) */
-
-class CustomNonlinearity : public Hermes1DFunction<double>
-{
-public:
-  CustomNonlinearity(double alpha);
-
-  virtual double value(double u) const;
-
-  virtual Ord value(Ord u) const;
-
-  protected:
-    double alpha;
-};
-
 /* Weak forms */
 
 // NOTE: The linear problem in the Picard's method is 
@@ -28,13 +17,13 @@ public:
 class CustomWeakFormPicard : public WeakForm<double>
 {
 public:
-  CustomWeakFormPicard(Solution<double>* prev_iter_sln, Hermes1DFunction<double>* lambda, Hermes2DFunction<double>* f);
+  CustomWeakFormPicard(Solution<double>* prev_iter_sln, const PowerLawNonlinearity* lambda, Hermes2DFunction<double>* f);
 
 private:
   class CustomJacobian : public MatrixFormVol<double>
   {
   public:
-    CustomJacobian(int i, int j, Hermes1DFunction<double>* lambda) : MatrixFormVol<double>(i, j), lambda(lambda) {};
+    CustomJacobian(int i, int j, const PowerLawNonlinearity* lambda) : MatrixFormVol<double>(i, j), lambda(lambda) {};
 
     virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
                          Func<double> *v, Geom<double> *e, Func<double> **ext) const;
@@ -45,13 +34,13 @@ private:
     MatrixFormVol<double>* clone() const;
 
     protected:
-      Hermes1DFunction<double>* lambda;
+      const PowerLawNonlinearity* lambda;
   };
 
   class CustomResidual : public VectorFormVol<double>
   {
   public:
-    CustomResidual(int i, Hermes1DFunction<double>* lambda, Hermes2DFunction<double>* f) 
+    CustomResidual(int i, const PowerLawNonlinearity* lambda, Hermes2DFunction<double>* f) 
       : VectorFormVol<double>(i), lambda(lambda), f(f) 
     {
     }
@@ -65,7 +54,7 @@ private:
     VectorFormVol<double>* clone() const;
 
   private:
-      Hermes1DFunction<double>* lambda;
+      const PowerLawNonlinearity* lambda;
       Hermes2DFunction<double>* f;
   };
 };
@@ -86,3 +75,15 @@ public:
   virtual double value(double x, double y, double n_x, double n_y, 
                        double t_x, double t_y) const;
 };
+
+/* Solver benchmark */
+
+// Solves the problem from the constant initial condition by the Picard's
+// method with Anderson acceleration and by the Newton's method (full step,
+// line search, trust region, and the chord method with the line search), and
+// prints the iterations, assemblies, residual norms and times of all.
+
+void run_solver_benchmark(Mesh* mesh, const Space<double>* space, double init_cond_const,
+                          const PowerLawNonlinearity* lambda, Hermes2DFunction<double>* src,
+                          int anderson_depth, double anderson_beta, double picard_tol,
+                          double newton_tol, int max_iter);
@@ -2,12 +2,15 @@
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
 #include "function/function.h"
+#include "tutorial_parameters.h"
 
 using namespace RefinementSelectors;
 
 //  This example uses the Picard's method to solve a nonlinear problem.
 //  Try to run this example with PICARD_NUM_LAST_ITER_USED = 1 for 
-//  comparison (Anderson acceleration turned off).)
+//  comparison (Anderson acceleration turned off).) The Anderson acceleration
+//  is implemented in common/anderson_acceleration.h, its cost per iteration
+//  grows only linearly with the number of iterations used.
 //
 //  PDE: Stationary heat transfer equation with nonlinear thermal
 //  conductivity, -div[lambda(u) grad u] + src(x, y) = 0.
@@ -22,12 +25,14 @@ using namespace RefinementSelectors;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 3;                  
+int INIT_GLOB_REF_NUM = 3;                  
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 5;                   
+int INIT_BDY_REF_NUM = 5;                   
 // Value for custom constant initial condition.
 const double INIT_COND_CONST = 3.0;               
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
@@ -37,21 +42,39 @@ MatrixSolverType matrix_solver = SOLVER_UMFPACK;
 // Picard's method.
 // Number of last iterations used. 
 // 1... standard fixed point.
-// >1... Anderson acceleration.
-const int PICARD_NUM_LAST_ITER_USED = 4;          
-// 0 <= beta <= 1... parameter for the Anderson acceleration. 
-const double PICARD_ANDERSON_BETA = 0.2;          
-// Stopping criterion for the Picard's method.
-const double PICARD_TOL = 1e-3;
+// >1... Anderson acceleration (deep histories such as 20 - 50 are fine).
+int PICARD_NUM_LAST_ITER_USED = 4;          
+// 0 < beta <= 1... mixing factor of the Anderson acceleration (1: no mixing).
+double PICARD_ANDERSON_BETA = 0.2;          
+// Stopping criterion for the Picard's method (relative change of two
+// consecutive iterations).
+const double PICARD_TOL = 1e-5;
 // Maximum allowed number of Picard iterations.
 const int PICARD_MAX_ITER = 100;                  
 
+// Set to "true" to compare the Picard's method with the Newton's method
+// (line search, trust region) from the same initial condition.
+bool SOLVER_BENCHMARK = false;
+// Stopping criterion for the Newton's method in the benchmark (residual norm).
+const double NEWTON_TOL = 1e-8;
+
 // Problem parameters.
 double heat_src = 1.0;
 double alpha = 4.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("PICARD_NUM_LAST_ITER_USED", PICARD_NUM_LAST_ITER_USED);
+  parameters.get("PICARD_ANDERSON_BETA", PICARD_ANDERSON_BETA);
+  parameters.get("SOLVER_BENCHMARK", SOLVER_BENCHMARK);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -65,52 +88,63 @@ int main(int argc, char* argv[])
   CustomEssentialBCNonConst bc_essential("Bdy");
   EssentialBCs<double> bcs(&bc_essential);
 
-  // Create an H1 space with default shapeset.
-  H1Space<double> space(&mesh, &bcs, P_INIT);
+  // Create an H1 space with default shapeset. The projections of the
+  // non-constant Dirichlet condition onto the boundary edges are cached.
+  CachedBCH1Space space(&mesh, &bcs, P_INIT);
   int ndof = space.get_num_dofs();
 
   // Initialize previous iteration solution for the Picard's method.
   ConstantSolution<double> sln_prev_iter(&mesh, INIT_COND_CONST);
 
   // Initialize the weak formulation.
-  CustomNonlinearity lambda(alpha);
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(alpha, 1.0, 1.0);
   Hermes2DFunction<double> src(-heat_src);
-  CustomWeakFormPicard wf(&sln_prev_iter, &lambda, &src);
+  CustomWeakFormPicard wf(&sln_prev_iter, lambda, &src);
 
   // Initialize the FE problem.
   DiscreteProblemLinear<double> dp(&wf, &space);
 
+  // Project the initial condition to obtain the initial coefficient vector.
+  std::vector<double> coeff_vec(ndof);
+  OGProjection<double> ogProjection; ogProjection.project_global(&space, &sln_prev_iter, &coeff_vec[0]);
+
   // Initialize the Picard solver.
-  PicardSolver<double> picard(&dp);
-  picard.use_Anderson_acceleration(true);
-
-  // Perform the Picard's iteration (Anderson acceleration on by default).
-  picard.set_picard_tol(PICARD_TOL);
-  picard.set_picard_max_iter(PICARD_MAX_ITER);
-  picard.set_num_last_vector_used(PICARD_NUM_LAST_ITER_USED);
-  picard.set_anderson_beta(PICARD_ANDERSON_BETA);
+  AndersonPicardSolver picard(&dp, PICARD_NUM_LAST_ITER_USED - 1, PICARD_ANDERSON_BETA);
+
+  // Perform the Picard's iteration.
+  picard.set_tol(PICARD_TOL);
+  picard.set_max_iter(PICARD_MAX_ITER);
   try
   {
-    picard.solve(&sln_prev_iter);
+    if (!picard.solve(&coeff_vec[0]))
+      Hermes::Mixins::Loggable::Static::info("Picard's iteration did not converge.");
   }
   catch(std::exception& e)
   {
     std::cout << e.what();
   }
 
+  if (SOLVER_BENCHMARK)
+    run_solver_benchmark(&mesh, &space, INIT_COND_CONST, lambda, &src, PICARD_NUM_LAST_ITER_USED - 1,
+                         PICARD_ANDERSON_BETA, PICARD_TOL, NEWTON_TOL, PICARD_MAX_ITER);
+
   // Translate the coefficient vector into a Solution. 
   Solution<double> sln;
-  Solution<double>::vector_to_solution(picard.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(&coeff_vec[0], &space, &sln);
   
-  // Visualise the solution and mesh.
-  ScalarView s_view("Solution", new WinGeom(0, 0, 440, 350));
-  s_view.show_mesh(false);
-  s_view.show(&sln);
-  OrderView o_view("Mesh", new WinGeom(450, 0, 420, 350));
-  o_view.show(&space);
-
-  // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    // Visualise the solution and mesh.
+    ScalarView s_view("Solution", new WinGeom(0, 0, 440, 350));
+    s_view.show_mesh(false);
+    s_view.show(&sln);
+    OrderView o_view("Mesh", new WinGeom(450, 0, 420, 350));
+    o_view.show(&space);
+
+    // Wait for all views to be closed.
+    View::wait();
+  }
+  delete lambda;
   return 0;
 }
 
@@ -1,32 +1,5 @@
 #include "definitions.h"
 
-CustomNonlinearity::CustomNonlinearity(double alpha): Hermes1DFunction<double>()
-{
-  this->is_const = false;
-  this->alpha = alpha;
-}
-
-double CustomNonlinearity::value(double u) const
-{
-  return 1 + Hermes::pow(u, alpha);
-}
-
-Ord CustomNonlinearity::value(Ord u) const
-{
-  return Ord(10);
-}
-
-double CustomNonlinearity::derivative(double u) const
-{
-  return alpha * Hermes::pow(u, alpha - 1.0);
-}
-
-Ord CustomNonlinearity::derivative(Ord u) const
-{
-  // Same comment as above applies.
-  return Ord(10);
-}
-
 double CustomInitialCondition::value(double x, double y) const 
 {
   return (x+10) * (y+10) / 100. + 2;
@@ -1,29 +1,12 @@
 #include "hermes2d.h"
+#include "chord_newton.h"
+#include "power_law.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
 using namespace Hermes::Hermes2D::WeakFormsH1;
 using namespace Hermes::Hermes2D::Views;
 
-/* Nonlinearity lambda(u) = Hermes::pow(u, alpha) */
-
-class CustomNonlinearity : public Hermes1DFunction<double>
-{
-public:
-  CustomNonlinearity(double alpha);
-
-  virtual double value(double u) const;
-
-  virtual Ord value(Ord u) const;
-
-  virtual double derivative(double u) const;
-
-  virtual Ord derivative(Ord u) const;
-
-protected:
-  double alpha;
-};
-
 /* Initial condition */
 
 class CustomInitialCondition : public ExactSolutionScalar<double>
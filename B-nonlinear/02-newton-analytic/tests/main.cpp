@@ -0,0 +1,138 @@
+#define HERMES_REPORT_ALL
+#include "../definitions.h"
+
+// Checks the ChordNewtonSolver against the NewtonSolver of Hermes on the
+// problem of the example: the residual of the ResidualAssembler has to equal
+// the right-hand side assembled together with the Jacobian, and the Newton's
+// method, the chord method and the Newton's method with the line search and
+// with the trust region all have to converge to the solution of NewtonSolver.
+// The Newton's method has to assemble one Jacobian per iteration, the chord
+// method fewer.
+//
+// Usage: test-B-02-newton-analytic-globalization square.mesh
+
+const double NEWTON_TOL = 1e-10;
+const int NEWTON_MAX_ITER = 100;
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s square.mesh\n", argv[0]);
+    return -1;
+  }
+
+  // The mesh, space and weak form of the example, on a coarser mesh.
+  Mesh mesh;
+  MeshReaderH2D mloader;
+  mloader.load(argv[1], &mesh);
+  for (int i = 0; i < 2; i++)
+    mesh.refine_all_elements();
+  mesh.refine_towards_boundary("Bdy", 2);
+
+  CustomEssentialBCNonConst bc_essential("Bdy");
+  EssentialBCs<double> bcs(&bc_essential);
+  H1Space<double> space(&mesh, &bcs, 2);
+  int ndof = space.get_num_dofs();
+
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(4.0, 1.0, 1.0);
+  Hermes2DFunction<double> src(-1.0);
+  BatchWeakFormPoisson wf(HERMES_ANY, lambda, &src);
+  DiscreteProblem<double> dp(&wf, &space);
+
+  // The initial vector of the example.
+  std::vector<double> init_coeff_vec(ndof);
+  CustomInitialCondition init_sln(&mesh);
+  OGProjection<double> ogProjection;
+  ogProjection.project_global(&space, &init_sln, &init_coeff_vec[0]);
+
+  // The residual without and with the Jacobian.
+  ResidualAssembler residual(&dp);
+  residual.assemble(&init_coeff_vec[0]);
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  dp.assemble(&init_coeff_vec[0], matrix, rhs);
+  std::vector<double> rhs_values(ndof);
+  rhs->extract(&rhs_values[0]);
+  delete matrix;
+  delete rhs;
+
+  double max_residual = 0, max_residual_difference = 0;
+  for (int i = 0; i < ndof; i++)
+  {
+    max_residual = std::max(max_residual, std::abs(rhs_values[i]));
+    max_residual_difference = std::max(max_residual_difference, std::abs(residual.get_residual()[i] - rhs_values[i]));
+  }
+  Hermes::Mixins::Loggable::Static::info("ndof: %d, max |F| = %g, max |F_residual - F| = %g.",
+    ndof, max_residual, max_residual_difference);
+  bool success = (max_residual > 0 && max_residual_difference < 1e-12 * max_residual);
+
+  // The reference solution.
+  NewtonSolver<double> reference_newton(&dp);
+  reference_newton.set_newton_tol(NEWTON_TOL);
+  reference_newton.set_newton_max_iter(NEWTON_MAX_ITER);
+  std::vector<double> coeff_vec(init_coeff_vec);
+  try
+  {
+    reference_newton.solve(&coeff_vec[0]);
+  }
+  catch(std::exception& e)
+  {
+    std::cout << e.what();
+    printf("Failure!\n");
+    return -1;
+  }
+  std::vector<double> reference(reference_newton.get_sln_vector(), reference_newton.get_sln_vector() + ndof);
+  double max_value = 0;
+  for (int i = 0; i < ndof; i++)
+    max_value = std::max(max_value, std::abs(reference[i]));
+
+  const char* names[] = { "Newton", "chord Newton", "Newton, line search", "Newton, trust region" };
+  ChordNewtonSolver::Globalization globalizations[] = { ChordNewtonSolver::FULL_STEP, ChordNewtonSolver::FULL_STEP,
+                                                        ChordNewtonSolver::LINE_SEARCH, ChordNewtonSolver::TRUST_REGION };
+  double max_contractions[] = { 0.0, 0.5, 0.0, 0.0 };
+  for (int k = 0; k < 4; k++)
+  {
+    ChordNewtonSolver newton(&dp);
+    newton.set_tol(NEWTON_TOL);
+    newton.set_max_iter(NEWTON_MAX_ITER);
+    newton.set_globalization(globalizations[k]);
+    newton.set_max_contraction(max_contractions[k]);
+    coeff_vec = init_coeff_vec;
+
+    bool converged = false;
+    try
+    {
+      converged = newton.solve(&coeff_vec[0]);
+    }
+    catch(std::exception& e)
+    {
+      std::cout << e.what();
+    }
+
+    double max_difference = 0;
+    for (int i = 0; i < ndof; i++)
+      max_difference = std::max(max_difference, std::abs(coeff_vec[i] - reference[i]));
+    Hermes::Mixins::Loggable::Static::info("%s: converged %s, %d iterations, %d Jacobians, max |u - u_reference| = %g.",
+      names[k], converged ? "yes" : "no", newton.get_num_iters(), newton.get_num_jacobian_assemblies(), max_difference);
+
+    if (!converged || !(max_difference < 1e-6 * max_value))
+      success = false;
+    // The Newton's method assembles a Jacobian in every iteration, the chord
+    // method reuses it at least once.
+    if (max_contractions[k] == 0.0 && globalizations[k] == ChordNewtonSolver::FULL_STEP
+        && newton.get_num_jacobian_assemblies() != newton.get_num_iters())
+      success = false;
+    if (max_contractions[k] > 0.0 && newton.get_num_assemblies_avoided() == 0)
+      success = false;
+  }
+  delete lambda;
+
+  if (success)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
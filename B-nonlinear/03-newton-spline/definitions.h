@@ -1,4 +1,6 @@
 #include "hermes2d.h"
+#include "chord_newton.h"
+#include "uniform_cubic_spline.h"
 //#include "weakform/weakform.h"
 //#include "integrals/h1.h"
 //#include "boundaryconditions/essential_bcs.h"
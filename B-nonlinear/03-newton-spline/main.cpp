@@ -2,6 +2,7 @@
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
 #include "function/function.h"
+#include "tutorial_parameters.h"
 
 //  This example is the same as the previous one except that the 
 //  nonlinearity is given via a cubic spline.
@@ -17,16 +18,23 @@
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // Stopping criterion for the Newton's method.
 const double NEWTON_TOL = 1e-8;                   
 // Maximum allowed number of Newton iterations.
 const int NEWTON_MAX_ITER = 100;                  
+// The Jacobian is reused while the residual norm drops at least by this
+// factor in every iteration, 0 means the Newton's method.
+double NEWTON_MAX_CONTRACTION = 0.5;
+// Maximum number of iterations with the same Jacobian, 0 means no limit.
+int NEWTON_MAX_REUSE = 0;
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 3;                  
+int INIT_GLOB_REF_NUM = 3;                  
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 4;                   
+int INIT_BDY_REF_NUM = 4;                   
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -37,6 +45,16 @@ double alpha = 4.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("NEWTON_MAX_CONTRACTION", NEWTON_MAX_CONTRACTION);
+  parameters.get("NEWTON_MAX_REUSE", NEWTON_MAX_REUSE);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
   // Define nonlinear thermal conductivity lambda(u) via a cubic spline.
   // Step 1: Fill the x values and use lambda_macro(u) = 1 + u^4 for the y values.
 #define lambda_macro(x) (1 + Hermes::pow(x, 4))
@@ -59,6 +77,9 @@ int main(int argc, char* argv[])
   double interval_extension = 3.0;
   lambda.calculate_coeffs();
   lambda.plot("spline.dat", interval_extension);
+  // Step 3: The same spline with a constant-time interval lookup, evaluated
+  // in all integration points of an element at once by the weak forms.
+  UniformCubicSpline lambda_lookup(&lambda, lambda_pts);
 
   // Load the mesh.
   Mesh mesh;
@@ -80,7 +101,7 @@ int main(int argc, char* argv[])
 
   // Initialize the weak formulation.
   Hermes2DFunction<double> src(-heat_src);
-  DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &src);
+  BatchWeakFormPoisson wf(HERMES_ANY, &lambda_lookup, &src);
 
   // Initialize the FE problem.
   DiscreteProblem<double> dp(&wf, &space);
@@ -94,15 +115,19 @@ int main(int argc, char* argv[])
   CustomInitialCondition init_sln(&mesh);
   OGProjection<double> ogProjection; ogProjection.project_global(&space, &init_sln, coeff_vec); 
 
-  // Initialize Newton solver.
-  NewtonSolver<double> newton(&dp);
+  // Initialize the Newton solver. The Jacobian is assembled and factorized
+  // again only when the convergence slows down.
+  ChordNewtonSolver newton(&dp);
 
   // Perform Newton's iteration.
   try
   {
-    newton.set_newton_max_iter(NEWTON_MAX_ITER);
-    newton.set_newton_tol(NEWTON_TOL);
-    newton.solve(coeff_vec);
+    newton.set_max_iter(NEWTON_MAX_ITER);
+    newton.set_tol(NEWTON_TOL);
+    newton.set_max_contraction(NEWTON_MAX_CONTRACTION);
+    newton.set_max_reuse(NEWTON_MAX_REUSE);
+    if (!newton.solve(coeff_vec))
+      Hermes::Mixins::Loggable::Static::info("Newton's iteration did not converge.");
   }
   catch(std::exception& e)
   {
@@ -112,7 +137,7 @@ int main(int argc, char* argv[])
 
   // Translate the resulting coefficient vector into a Solution.
   Solution<double> sln;
-  Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
+  Solution<double>::vector_to_solution(coeff_vec, &space, &sln);
 
   // Get info about time spent during assembling in its respective parts.
   //dp.get_all_profiling_output(std::cout);
@@ -120,15 +145,18 @@ int main(int argc, char* argv[])
   // Clean up.
   delete [] coeff_vec;
 
-  // Visualise the solution and mesh.
-  ScalarView s_view("Solution", new WinGeom(0, 0, 440, 350));
-  s_view.show_mesh(false);
-  s_view.show(&sln);
-  OrderView o_view("Mesh", new WinGeom(450, 0, 400, 350));
-  o_view.show(&space);
-
-  // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    // Visualise the solution and mesh.
+    ScalarView s_view("Solution", new WinGeom(0, 0, 440, 350));
+    s_view.show_mesh(false);
+    s_view.show(&sln);
+    OrderView o_view("Mesh", new WinGeom(450, 0, 400, 350));
+    o_view.show(&space);
+
+    // Wait for all views to be closed.
+    View::wait();
+  }
   return 0;
 }
 
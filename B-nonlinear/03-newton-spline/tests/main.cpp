@@ -0,0 +1,78 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+#include "uniform_cubic_spline.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// Checks that UniformCubicSpline evaluates the same function as the cubic
+// spline of the example it is built from: the values and derivatives (single
+// and batched) have to agree with CubicSpline at the knots, next to them on
+// both sides, inside the unevenly spaced intervals and in the extrapolation
+// on both sides. At the knots the spline interpolates 1 + u^4.
+//
+// Usage: test-B-03-newton-spline-lookup
+
+static void compare(double reference_value, double reference_derivative, double value, double derivative,
+                    double& max_difference)
+{
+  double scale = std::max(1.0, std::abs(reference_value));
+  max_difference = std::max(max_difference, std::abs(value - reference_value) / scale);
+  scale = std::max(1.0, std::abs(reference_derivative));
+  max_difference = std::max(max_difference, std::abs(derivative - reference_derivative) / scale);
+}
+
+int main(int argc, char* argv[])
+{
+  // The spline of the example: 1 + u^4 at unevenly spaced knots, natural
+  // end conditions, derivatives extrapolated.
+  Hermes::vector<double> lambda_pts(-2.0, -1.5, -1.0, -0.5, 0.0, 0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 4.0, 5.0);
+  Hermes::vector<double> lambda_val;
+  for (unsigned int i = 0; i < lambda_pts.size(); i++)
+    lambda_val.push_back(1 + Hermes::pow(lambda_pts[i], 4));
+  CubicSpline lambda(lambda_pts, lambda_val, 0.0, 0.0, false, false, true, true);
+  lambda.calculate_coeffs();
+  UniformCubicSpline lambda_lookup(&lambda, lambda_pts);
+
+  // The knots and points right next to them.
+  std::vector<double> u;
+  for (unsigned int i = 0; i < lambda_pts.size(); i++)
+  {
+    u.push_back(lambda_pts[i]);
+    u.push_back(lambda_pts[i] - 1e-9);
+    u.push_back(lambda_pts[i] + 1e-9);
+  }
+  // Points in all intervals and in the extrapolation.
+  for (int i = 0; i <= 1100; i++)
+    u.push_back(-4.0 + 0.01 * i + 1e-4 * std::sin(1.0 + i));
+
+  // Interpolated values.
+  double max_knot_difference = 0;
+  for (unsigned int i = 0; i < lambda_pts.size(); i++)
+    max_knot_difference = std::max(max_knot_difference, std::abs(lambda_lookup.value(lambda_pts[i]) - lambda_val[i]) / lambda_val[i]);
+
+  int n = u.size();
+  std::vector<double> batch_value(n), batch_derivative(n), values_only(n);
+  lambda_lookup.value_and_derivative(n, &u[0], &batch_value[0], &batch_derivative[0]);
+  lambda_lookup.values(n, &u[0], &values_only[0]);
+
+  double max_difference = 0;
+  for (int i = 0; i < n; i++)
+  {
+    double reference_value = lambda.value(u[i]);
+    double reference_derivative = lambda.derivative(u[i]);
+    compare(reference_value, reference_derivative, lambda_lookup.value(u[i]), lambda_lookup.derivative(u[i]), max_difference);
+    compare(reference_value, reference_derivative, batch_value[i], batch_derivative[i], max_difference);
+    compare(reference_value, reference_derivative, values_only[i], reference_derivative, max_difference);
+  }
+  Hermes::Mixins::Loggable::Static::info("%d points, %d cells, max relative difference %g, at the knots %g.",
+    n, lambda_lookup.get_num_cells(), max_difference, max_knot_difference);
+
+  if (max_difference < 1e-10 && max_knot_difference < 1e-12)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
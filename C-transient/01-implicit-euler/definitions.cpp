@@ -28,6 +28,19 @@ CustomWeakFormHeatRK1::CustomWeakFormHeatRK1(std::string bdy_air, double alpha,
                        time_step, current_time_ptr, temp_init, t_final));
 }
 
+CustomWeakFormHeatRK1Load::CustomWeakFormHeatRK1Load(std::string bdy_air, double alpha, double heatcap, double rho,
+                                                     double time_step, double* current_time_ptr, double temp_init, double t_final,
+                                                     Solution<double>* prev_time_sln) : WeakForm<double>(1)
+{
+  this->set_ext(prev_time_sln);
+
+  // Previous time level solution.
+  add_vector_form(new CustomWeakFormHeatRK1::CustomVectorFormVol(0, time_step));
+  // Exterior temperature.
+  add_vector_form_surf(new CustomWeakFormHeatRK1::CustomVectorFormSurf(0, bdy_air, alpha, rho, heatcap,
+                       time_step, current_time_ptr, temp_init, t_final));
+}
+
 double CustomWeakFormHeatRK1::CustomVectorFormVol::value(int n, double *wt, Func<double> *u_ext[], Func<double> *v, Geom<double> *e, Func<double> **ext) const 
 {
   Func<double>* temp_prev_time = ext[0];
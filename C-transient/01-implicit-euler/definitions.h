@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "constant_operator_solver.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -15,6 +16,8 @@ public:
                         Solution<double>* prev_time_sln);
 
 private:
+  friend class CustomWeakFormHeatRK1Load;
+
   // This form is custom since it contains previous time-level solution.
   class CustomVectorFormVol : public VectorFormVol<double>
   {
@@ -56,3 +59,14 @@ private:
     VectorFormSurf<double>* clone() const;
   };
 };
+
+// The vector forms of CustomWeakFormHeatRK1 that change in every time step
+// (previous time level solution, exterior temperature), for the
+// ConstantOperatorSolver.
+class CustomWeakFormHeatRK1Load : public WeakForm<double>
+{
+public:
+  CustomWeakFormHeatRK1Load(std::string bdy_air, double alpha, double heatcap, double rho,
+                            double time_step, double* current_time_ptr, double temp_init, double t_final,
+                            Solution<double>* prev_time_sln);
+};
@@ -1,6 +1,8 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "solution_output.h"
 
 using namespace RefinementSelectors;
 
@@ -23,14 +25,28 @@ using namespace RefinementSelectors;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
+// Set to "true" to enable VTK output of every time step.
+bool VTK_VISUALIZATION = false;
+// Format of the VTK output: 1 = binary VTU, 2 = zlib-compressed VTU,
+// 3 = XDMF + HDF5 (see common/solution_output.h).
+int VTK_FORMAT = 1;
+// The VTK output is written by a separate thread. At most this many time
+// steps wait for it, then the time stepping waits.
+int OUTPUT_MAX_PENDING = 4;
 // Polynomial degree of mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 1;                       
+int INIT_REF_NUM = 1;                       
 // Number of initial uniform mesh refinements towards the boundary.
-const int INIT_REF_NUM_BDY = 3;                   
+int INIT_REF_NUM_BDY = 3;                   
 // Time step in seconds.
 const double time_step = 300.0;                   
+// The matrix is constant: factorize it once and assemble only the changing
+// part of the right-hand side in every time step. Set to "false" to perform
+// the Newton's iteration in every time step instead.
+bool CONSTANT_OPERATOR = true;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -51,6 +67,21 @@ const double T_FINAL = 86400;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("VTK_FORMAT", VTK_FORMAT);
+  parameters.get("OUTPUT_MAX_PENDING", OUTPUT_MAX_PENDING);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("INIT_REF_NUM_BDY", INIT_REF_NUM_BDY);
+  parameters.get("CONSTANT_OPERATOR", CONSTANT_OPERATOR);
+  parameters.check_unused();
+
+  // Format of the VTK output, checked before anything is computed.
+  SolutionOutput::Format output_format = SolutionOutput::get_format(VTK_FORMAT);
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -84,10 +115,26 @@ int main(int argc, char* argv[])
   // Initialize Newton solver.
   NewtonSolver<double> newton(&dp);
 
+  // Initialize the constant operator solver.
+  CustomWeakFormHeatRK1Load wf_load("Boundary air", ALPHA, HEATCAP, RHO, time_step,
+                                    &current_time, TEMP_INIT, T_FINAL, &tsln);
+  ConstantOperatorSolver constant_operator(&wf, &wf_load, &space);
+  std::vector<double> coeff_vec(ndof);
+
   // Initialize views.
-  ScalarView Tview("Temperature", new WinGeom(0, 0, 450, 600));
-  Tview.set_min_max_range(0,20);
-  Tview.fix_scale_width(30);
+  ScalarView* Tview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    Tview = new ScalarView("Temperature", new WinGeom(0, 0, 450, 600));
+    Tview->set_min_max_range(0,20);
+    Tview->fix_scale_width(30);
+  }
+
+  // The view is updated in this thread, the VTK files are written by an
+  // output thread (only started with the VTK output).
+  SolutionOutput output(output_format, VTK_VISUALIZATION, OUTPUT_MAX_PENDING);
+  if (HERMES_VISUALIZATION)
+    output.set_view(Tview);
 
   // Time stepping:
   int ts = 1;
@@ -95,25 +142,41 @@ int main(int argc, char* argv[])
   {
     Hermes::Mixins::Loggable::Static::info("---- Time step %d, time %3.5f s", ts, current_time);
 
-    // Perform Newton's iteration.
-    try
+    const double* sln_vector;
+    if (CONSTANT_OPERATOR)
     {
-      newton.solve_keep_jacobian();
+      // One forward and back substitution.
+      constant_operator.solve(&coeff_vec[0]);
+      sln_vector = &coeff_vec[0];
     }
-    catch(std::exception& e)
+    else
     {
-      std::cout << e.what();
-      
+      // Perform Newton's iteration.
+      try
+      {
+        newton.solve_keep_jacobian();
+      }
+      catch(std::exception& e)
+      {
+        std::cout << e.what();
+        
+      }
+
+      sln_vector = newton.get_sln_vector();
     }
 
-    // Translate the resulting coefficient vector into the Solution sln.
-    Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &tsln);
+    // Translate the resulting coefficient vector into the Solution sln,
+    // needed for the next time step.
+    Solution<double>::vector_to_solution(sln_vector, &space, &tsln);
 
-    // Visualize the solution.
-    char title[100];
-    sprintf(title, "Time %3.2f s", current_time);
-    Tview.set_title(title);
-    Tview.show(&tsln);
+    if (HERMES_VISUALIZATION || VTK_VISUALIZATION)
+    {
+      // Show the solution, the file is written in the background.
+      char title[100], filename[100];
+      sprintf(title, "Time %3.2f s", current_time);
+      sprintf(filename, "Temperature-%d", ts);
+      output.save_snapshot(sln_vector, &space, VTK_VISUALIZATION ? filename : NULL, "Temperature", title);
+    }
 
     // Increase current time and time step counter.
     current_time += time_step;
@@ -121,7 +184,10 @@ int main(int argc, char* argv[])
   }
   while (current_time < T_FINAL);
 
-  // Wait for the view to be closed.
-  View::wait();
+  // Wait for the output thread, then for the view to be closed.
+  output.wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete Tview;
   return 0;
 }
@@ -0,0 +1,100 @@
+#define HERMES_REPORT_ALL
+#include "../definitions.h"
+
+// Checks the ConstantOperatorSolver against the Newton's method on the
+// implicit Euler steps of the example: both time stepping loops start from
+// the same initial condition, and after every step the solution with the
+// factorized matrix and the stored constant residual has to equal the one
+// of the NewtonSolver with the full weak form (nonzero Dirichlet values,
+// time-dependent exterior temperature).
+//
+// Usage: test-C-01-implicit-euler-constant-operator domain.mesh
+
+const int NUM_STEPS = 10;
+const double TIME_STEP = 300.0;
+const double TEMP_INIT = 10;
+const double ALPHA = 10;
+const double LAMBDA = 1e2;
+const double HEATCAP = 1e2;
+const double RHO = 3000;
+const double T_FINAL = 86400;
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s domain.mesh\n", argv[0]);
+    return -1;
+  }
+
+  // Load the mesh of the example.
+  Mesh mesh;
+  MeshReaderH2D mloader;
+  mloader.load(argv[1], &mesh);
+  mesh.refine_towards_boundary("Boundary air", 1);
+  mesh.refine_towards_boundary("Boundary ground", 1);
+
+  DefaultEssentialBCConst<double> bc_essential("Boundary ground", TEMP_INIT);
+  EssentialBCs<double> bcs(&bc_essential);
+  H1Space<double> space(&mesh, &bcs, 2);
+  int ndof = space.get_num_dofs();
+
+  // The previous time levels of both loops (initialized as in the example).
+  double current_time = 0;
+  ConstantSolution<double> tsln_newton(&mesh, TEMP_INIT);
+  ConstantSolution<double> tsln_constant(&mesh, TEMP_INIT);
+
+  // The Newton's method with the full weak form.
+  CustomWeakFormHeatRK1 wf_newton("Boundary air", ALPHA, LAMBDA, HEATCAP, RHO, TIME_STEP,
+                                  &current_time, TEMP_INIT, T_FINAL, &tsln_newton);
+  DiscreteProblem<double> dp(&wf_newton, &space);
+  NewtonSolver<double> newton(&dp);
+
+  // The constant operator solver.
+  CustomWeakFormHeatRK1 wf("Boundary air", ALPHA, LAMBDA, HEATCAP, RHO, TIME_STEP,
+                           &current_time, TEMP_INIT, T_FINAL, &tsln_constant);
+  CustomWeakFormHeatRK1Load wf_load("Boundary air", ALPHA, HEATCAP, RHO, TIME_STEP,
+                                    &current_time, TEMP_INIT, T_FINAL, &tsln_constant);
+  ConstantOperatorSolver constant_operator(&wf, &wf_load, &space);
+  std::vector<double> coeff_vec(ndof);
+
+  double max_value = 0, max_difference = 0;
+  for (int ts = 1; ts <= NUM_STEPS; ts++)
+  {
+    try
+    {
+      newton.solve();
+      constant_operator.solve(&coeff_vec[0]);
+    }
+    catch(std::exception& e)
+    {
+      std::cout << e.what();
+      printf("Failure!\n");
+      return -1;
+    }
+
+    const double* sln_vector = newton.get_sln_vector();
+    double step_difference = 0;
+    for (int i = 0; i < ndof; i++)
+    {
+      max_value = std::max(max_value, std::abs(sln_vector[i]));
+      step_difference = std::max(step_difference, std::abs(coeff_vec[i] - sln_vector[i]));
+    }
+    max_difference = std::max(max_difference, step_difference);
+    Hermes::Mixins::Loggable::Static::info("Time step %d, time %g s: max |T - T_newton| = %g.", ts, current_time, step_difference);
+
+    Solution<double>::vector_to_solution(sln_vector, &space, &tsln_newton);
+    Solution<double>::vector_to_solution(&coeff_vec[0], &space, &tsln_constant);
+    current_time += TIME_STEP;
+  }
+  Hermes::Mixins::Loggable::Static::info("ndof: %d, %d steps, max |T| = %g, max |T - T_newton| = %g.",
+    ndof, constant_operator.get_num_steps(), max_value, max_difference);
+
+  if (constant_operator.get_num_steps() == NUM_STEPS && max_value > 0 && max_difference < 1e-10 * max_value)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
@@ -1,6 +1,10 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "solution_output.h"
+#include "time_levels.h"
+#include "stage_runge_kutta.h"
 
 using namespace RefinementSelectors;
 
@@ -34,18 +38,33 @@ using namespace RefinementSelectors;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
+// Set to "true" to enable VTK output of every time step.
+bool VTK_VISUALIZATION = false;
+// Format of the VTK output: 1 = binary VTU, 2 = zlib-compressed VTU,
+// 3 = XDMF + HDF5 (see common/solution_output.h).
+int VTK_FORMAT = 1;
+// The VTK output is written by a separate thread. At most this many time
+// steps wait for it, then the time stepping waits.
+int OUTPUT_MAX_PENDING = 4;
 // Polynomial degree of mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 1;                       
+int INIT_REF_NUM = 1;                       
 // Number of initial uniform mesh refinements towards the boundary.
-const int INIT_REF_NUM_BDY = 3;                   
+int INIT_REF_NUM_BDY = 3;                   
 // Time step in seconds.
 const double time_step = 3e+2;                    
  // Stopping criterion for the Newton's method.
 const double NEWTON_TOL = 1e-5;                  
 // Maximum allowed number of Newton iterations.
 const int NEWTON_MAX_ITER = 100;                  
+// The problem is linear and the time step constant: assemble and factorize
+// the stage matrix once and assemble only the right-hand side in every time
+// step (common/stage_runge_kutta.h, needs SOLVER_UMFPACK). Set to "false" to
+// use RungeKutta with the Newton's method in every time step instead.
+bool CACHED_STAGE_MATRIX = true;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -83,6 +102,21 @@ const double T_FINAL = 86400;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("VTK_FORMAT", VTK_FORMAT);
+  parameters.get("OUTPUT_MAX_PENDING", OUTPUT_MAX_PENDING);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("INIT_REF_NUM_BDY", INIT_REF_NUM_BDY);
+  parameters.get("CACHED_STAGE_MATRIX", CACHED_STAGE_MATRIX);
+  parameters.check_unused();
+
+  // Format of the VTK output, checked before anything is computed.
+  SolutionOutput::Format output_format = SolutionOutput::get_format(VTK_FORMAT);
+
   // Choose a Butcher's table or define your own.
   ButcherTable bt(butcher_table_type);
   if (bt.is_explicit()) Hermes::Mixins::Loggable::Static::info("Using a %d-stage explicit R-K method.", bt.get_size());
@@ -99,9 +133,11 @@ int main(int argc, char* argv[])
   mesh.refine_towards_boundary("Boundary_air", INIT_REF_NUM_BDY);
   mesh.refine_towards_boundary("Boundary_ground", INIT_REF_NUM_BDY);
 
-  // Previous and next time level solutions.
-  ConstantSolution<double> sln_time_prev(&mesh, TEMP_INIT);
-  Solution<double> sln_time_new(&mesh);
+  // Previous and next time level solutions. The initial condition is the
+  // previous time level of the first step.
+  ConstantSolution<double> sln_init(&mesh, TEMP_INIT);
+  TimeLevels<double> time_levels(2);
+  time_levels.set(1, &sln_init);
 
   // Initialize the weak formulation.
   double current_time = 0;
@@ -119,13 +155,30 @@ int main(int argc, char* argv[])
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
   // Initialize views.
-  ScalarView Tview("Temperature", new WinGeom(0, 0, 450, 600));
-  Tview.set_min_max_range(0,20);
-  Tview.fix_scale_width(30);
+  ScalarView* Tview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    Tview = new ScalarView("Temperature", new WinGeom(0, 0, 450, 600));
+    Tview->set_min_max_range(0,20);
+    Tview->fix_scale_width(30);
+  }
+
+  // The view is updated in this thread, the VTK files are written by an
+  // output thread (only started with the VTK output).
+  SolutionOutput output(output_format, VTK_VISUALIZATION, OUTPUT_MAX_PENDING);
+  if (HERMES_VISUALIZATION)
+    output.set_view(Tview);
 
   // Initialize Runge-Kutta time stepping.
   RungeKutta<double> runge_kutta(&wf, &space, &bt);
 
+  // Runge-Kutta time stepping with the cached stage matrix, and the
+  // coefficient vector of the initial condition.
+  StageRungeKutta stage_runge_kutta(&wf, &space, &bt);
+  std::vector<double> coeff_vec(ndof);
+  OGProjection<double> ogProjection;
+  ogProjection.project_global(&space, &sln_init, &coeff_vec[0]);
+
   // Time stepping loop:
   int ts = 1;
   do 
@@ -135,25 +188,42 @@ int main(int argc, char* argv[])
          current_time, time_step, bt.get_size());
     try
     {
-      runge_kutta.set_time(current_time);
-      runge_kutta.set_time_step(time_step);
-      runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
-      runge_kutta.set_newton_tol(NEWTON_TOL);
-      runge_kutta.rk_time_step_newton(&sln_time_prev, &sln_time_new);
+      if (CACHED_STAGE_MATRIX)
+      {
+        stage_runge_kutta.set_time(current_time);
+        stage_runge_kutta.set_time_step(time_step);
+        stage_runge_kutta.rk_time_step(&coeff_vec[0]);
+      }
+      else
+      {
+        runge_kutta.set_time(current_time);
+        runge_kutta.set_time_step(time_step);
+        runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
+        runge_kutta.set_newton_tol(NEWTON_TOL);
+        runge_kutta.rk_time_step_newton(time_levels.get(1), time_levels.get(0));
+      }
     }
     catch(Exceptions::Exception& e)
     {
       std::cout << e.what();
     }
 
-    // Show the new time level solution.
-    char title[100];
-    sprintf(title, "Time %3.2f s", current_time);
-    Tview.set_title(title);
-    Tview.show(&sln_time_new);
+    if (HERMES_VISUALIZATION || VTK_VISUALIZATION)
+    {
+      // Show the new time level solution, the file is written in the
+      // background. The cached stage matrix only updates the coefficient
+      // vector, it is converted into a Solution for the output only.
+      char title[100], filename[100];
+      sprintf(title, "Time %3.2f s", current_time);
+      sprintf(filename, "Temperature-%d", ts);
+      if (CACHED_STAGE_MATRIX)
+        output.save_snapshot(&coeff_vec[0], &space, VTK_VISUALIZATION ? filename : NULL, "Temperature", title);
+      else
+        output.save_snapshot(time_levels.get(0), VTK_VISUALIZATION ? filename : NULL, "Temperature", title);
+    }
 
-    // Copy solution for the new time step.
-    sln_time_prev.copy(&sln_time_new);
+    // The new solution becomes the previous one (no copy).
+    time_levels.rotate();
 
     // Increase current time and time step counter.
     current_time += time_step;
@@ -161,7 +231,14 @@ int main(int argc, char* argv[])
   } 
   while (current_time < T_FINAL);
 
-  // Wait for the view to be closed.
-  View::wait();
+  if (CACHED_STAGE_MATRIX)
+    Hermes::Mixins::Loggable::Static::info("%d time steps, %d matrix factorizations.",
+      stage_runge_kutta.get_num_steps(), stage_runge_kutta.get_num_factorizations());
+
+  // Wait for the output thread, then for the view to be closed.
+  output.wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete Tview;
   return 0;
 }
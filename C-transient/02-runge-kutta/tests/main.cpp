@@ -0,0 +1,131 @@
+#define HERMES_REPORT_ALL
+#include "../definitions.h"
+#include "time_levels.h"
+#include "stage_runge_kutta.h"
+
+// Checks StageRungeKutta against RungeKutta::rk_time_step_newton on the
+// problem of the example: with the same Butcher's table and time step, the
+// time levels of both have to agree after every step. Covered are the stage
+// by stage solution of a linear problem (SDIRK, and ESDIRK with an explicit
+// first stage), the block matrix of a table that is not diagonally implicit
+// (Radau IIA) and the Newton's method of the stages (set_linear(false)).
+//
+// Usage: test-C-02-runge-kutta-stage-solver domain.mesh
+
+const int NUM_STEPS = 5;
+const double TIME_STEP = 3e+2;
+const double TEMP_INIT = 10;
+const double ALPHA = 10;
+const double LAMBDA = 1e2;
+const double HEATCAP = 1e2;
+const double RHO = 3000;
+const double T_FINAL = 86400;
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s domain.mesh\n", argv[0]);
+    return -1;
+  }
+
+  // Load the mesh of the example.
+  Mesh mesh;
+  MeshReaderH2D mloader;
+  mloader.load(argv[1], &mesh);
+  mesh.refine_towards_boundary("Boundary_air", 1);
+  mesh.refine_towards_boundary("Boundary_ground", 1);
+
+  DefaultEssentialBCConst<double> bc_essential("Boundary_ground", TEMP_INIT);
+  EssentialBCs<double> bcs(&bc_essential);
+  H1Space<double> space(&mesh, &bcs, 2);
+  int ndof = space.get_num_dofs();
+  ConstantSolution<double> sln_init(&mesh, TEMP_INIT);
+
+  // Start at a time where the exterior temperature differs from the initial
+  // one.
+  double current_time = T_FINAL / 8;
+  CustomWeakFormHeatRK wf("Boundary_air", ALPHA, LAMBDA, HEATCAP, RHO,
+                          &current_time, TEMP_INIT, T_FINAL);
+
+  const char* names[] = { "SDIRK 2", "ESDIRK TR-BDF2", "Radau IIA 3", "SDIRK 2, Newton" };
+  ButcherTableType tables[] = { Implicit_SDIRK_2_2, Implicit_ESDIRK_TRBDF2_3_23_embedded,
+                                Implicit_Radau_IIA_3_5, Implicit_SDIRK_2_2 };
+  bool linear[] = { true, true, true, false };
+  bool diagonally_implicit[] = { true, true, false, true };
+
+  bool success = true;
+  for (int k = 0; k < 4; k++)
+  {
+    ButcherTable bt(tables[k]);
+    current_time = T_FINAL / 8;
+
+    // The reference: the Newton's method for all stages at once.
+    RungeKutta<double> runge_kutta(&wf, &space, &bt);
+    runge_kutta.set_newton_tol(1e-10);
+    runge_kutta.set_newton_max_iter(20);
+    TimeLevels<double> time_levels(2);
+    time_levels.set(1, &sln_init);
+
+    StageRungeKutta stage_runge_kutta(&wf, &space, &bt);
+    stage_runge_kutta.set_linear(linear[k]);
+    stage_runge_kutta.set_newton_tol(1e-10);
+    std::vector<double> coeff_vec(ndof), reference(ndof);
+    OGProjection<double> ogProjection;
+    ogProjection.project_global(&space, &sln_init, &coeff_vec[0]);
+
+    double max_value = 0, max_difference = 0;
+    for (int ts = 1; ts <= NUM_STEPS; ts++)
+    {
+      try
+      {
+        runge_kutta.set_time(current_time);
+        runge_kutta.set_time_step(TIME_STEP);
+        runge_kutta.rk_time_step_newton(time_levels.get(1), time_levels.get(0));
+
+        stage_runge_kutta.set_time(current_time);
+        stage_runge_kutta.set_time_step(TIME_STEP);
+        stage_runge_kutta.rk_time_step(&coeff_vec[0]);
+      }
+      catch(std::exception& e)
+      {
+        std::cout << e.what();
+        printf("Failure!\n");
+        return -1;
+      }
+
+      // The coefficients of the reference time level.
+      ogProjection.project_global(&space, time_levels.get(0), &reference[0]);
+      for (int i = 0; i < ndof; i++)
+      {
+        max_value = std::max(max_value, std::abs(reference[i]));
+        max_difference = std::max(max_difference, std::abs(coeff_vec[i] - reference[i]));
+      }
+
+      time_levels.rotate();
+      current_time += TIME_STEP;
+    }
+    Hermes::Mixins::Loggable::Static::info("%s: %d steps, %d factorizations, %d Newton iterations, max |T - T_reference| = %g.",
+      names[k], stage_runge_kutta.get_num_steps(), stage_runge_kutta.get_num_factorizations(),
+      stage_runge_kutta.get_num_newton_iters(), max_difference);
+
+    if (stage_runge_kutta.is_diagonally_implicit() != diagonally_implicit[k]
+        || stage_runge_kutta.get_num_steps() != NUM_STEPS
+        || !(max_value > 0 && max_difference < 1e-8 * max_value))
+      success = false;
+    // A linear problem keeps its factorizations over the steps, the stages of
+    // a nonlinear one need the Newton's method.
+    if (linear[k] && stage_runge_kutta.get_num_newton_iters() != 0)
+      success = false;
+    if (!linear[k] && stage_runge_kutta.get_num_newton_iters() < NUM_STEPS)
+      success = false;
+  }
+
+  if (success)
+  {
+    printf("Success!\n");
+    return 0;
+  }
+  printf("Failure!\n");
+  return -1;
+}
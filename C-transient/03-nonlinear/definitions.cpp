@@ -1,32 +1,5 @@
 #include "definitions.h"
 
-CustomNonlinearity::CustomNonlinearity(double alpha): Hermes1DFunction<double>()
-{
-  this->is_const = false;
-  this->alpha = alpha;
-}
-
-double CustomNonlinearity::value(double u) const
-{
-  return -1 - Hermes::pow(u, alpha);
-}
-
-Ord CustomNonlinearity::value(Ord u) const
-{ 
-  return Ord(10);
-}
-
-double CustomNonlinearity::derivative(double u) const
-{
-  return -alpha * Hermes::pow(u, alpha - 1.0);
-}
-
-Ord CustomNonlinearity::derivative(Ord u) const
-{
-  return Ord(10);
-}
-
-
 EssentialBCNonConst::EssentialBCNonConst(std::string marker) : EssentialBoundaryCondition<double>(Hermes::vector<std::string>())
 {
   markers.push_back(marker);
@@ -62,4 +35,85 @@ Ord CustomInitialCondition::ord(Ord x, Ord y) const
 MeshFunction<double>* CustomInitialCondition::clone() const
 {
   return new CustomInitialCondition(this->mesh);
-}
\ No newline at end of file
+}
+
+void run_dirk_benchmark(Mesh* mesh, const Space<double>* space, WeakForm<double>* wf, double time_step,
+                        int num_steps, double newton_tol, int newton_max_iter)
+{
+  int ndof = space->get_num_dofs();
+  CustomInitialCondition init_sln(mesh);
+  std::vector<double> init_coeff_vec(ndof), coeff_vec(ndof);
+  OGProjection<double> ogProjection; ogProjection.project_global(space, &init_sln, &init_coeff_vec[0]);
+
+  const int num_tables = 7;
+  ButcherTableType tables[num_tables] = { Implicit_SDIRK_CASH_3_23_embedded, Implicit_ESDIRK_TRBDF2_3_23_embedded,
+                                          Implicit_ESDIRK_TRX2_3_23_embedded, Implicit_SDIRK_BILLINGTON_3_23_embedded,
+                                          Implicit_SDIRK_CASH_5_24_embedded, Implicit_SDIRK_CASH_5_34_embedded,
+                                          Implicit_DIRK_ISMAIL_7_45_embedded };
+  const char* names[num_tables] = { "SDIRK_CASH_3_23", "ESDIRK_TRBDF2_3_23", "ESDIRK_TRX2_3_23", "SDIRK_BILLINGTON_3_23",
+                                    "SDIRK_CASH_5_24", "SDIRK_CASH_5_34", "DIRK_ISMAIL_7_45" };
+
+  Hermes::Mixins::TimeMeasurable cpu_time;
+  Hermes::Mixins::Loggable::Static::info("DIRK benchmark, ndof: %d, %d time steps of %g", ndof, num_steps, time_step);
+  Hermes::Mixins::Loggable::Static::info("%-22s %6s %14s %14s %8s %8s %12s", "table", "stages", "monolithic [s]",
+                                         "by stage [s]", "speedup", "Newton", "difference");
+
+  for (int k = 0; k < num_tables; k++)
+  {
+    ButcherTable bt(tables[k]);
+
+    // All stages in one system.
+    TimeLevels<double> time_levels(2);
+    time_levels.set(1, &init_sln);
+    RungeKutta<double> runge_kutta(wf, space, &bt);
+    runge_kutta.set_newton_tol(newton_tol);
+    runge_kutta.set_newton_max_iter(newton_max_iter);
+    cpu_time.tick();
+    try
+    {
+      for (int ts = 0; ts < num_steps; ts++)
+      {
+        runge_kutta.set_time(ts * time_step);
+        runge_kutta.set_time_step(time_step);
+        runge_kutta.rk_time_step_newton(time_levels.get(1), time_levels.get(0));
+        time_levels.rotate();
+      }
+    }
+    catch(std::exception& e)
+    {
+      std::cout << e.what();
+    }
+    cpu_time.tick();
+    double monolithic_time = cpu_time.last();
+
+    // Stage by stage.
+    StageRungeKutta stage_runge_kutta(wf, space, &bt);
+    stage_runge_kutta.set_linear(false);
+    stage_runge_kutta.set_newton_tol(newton_tol);
+    stage_runge_kutta.set_newton_max_iter(newton_max_iter);
+    std::copy(init_coeff_vec.begin(), init_coeff_vec.end(), coeff_vec.begin());
+    cpu_time.tick();
+    try
+    {
+      for (int ts = 0; ts < num_steps; ts++)
+      {
+        stage_runge_kutta.set_time(ts * time_step);
+        stage_runge_kutta.set_time_step(time_step);
+        stage_runge_kutta.rk_time_step(&coeff_vec[0]);
+      }
+    }
+    catch(std::exception& e)
+    {
+      std::cout << e.what();
+    }
+    cpu_time.tick();
+    double stage_time = cpu_time.last();
+
+    Solution<double> sln;
+    Solution<double>::vector_to_solution(&coeff_vec[0], space, &sln);
+    double difference = Global<double>::calc_rel_error(&sln, time_levels.get(1), HERMES_H1_NORM);
+    Hermes::Mixins::Loggable::Static::info("%-22s %6d %14g %14g %8.2f %8d %12g", names[k], bt.get_size(), monolithic_time,
+                                           stage_time, monolithic_time / stage_time,
+                                           stage_runge_kutta.get_num_newton_iters(), difference);
+  }
+}
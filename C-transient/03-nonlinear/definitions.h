@@ -1,29 +1,13 @@
 #include "hermes2d.h"
+#include "power_law.h"
+#include "stage_runge_kutta.h"
+#include "time_levels.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
 using namespace Hermes::Hermes2D::WeakFormsH1;
 using namespace Hermes::Hermes2D::Views;
 
-/* Nonlinearity lambda(u) = pow(u, alpha) */
-
-class CustomNonlinearity : public Hermes1DFunction<double>
-{
-public:
-  CustomNonlinearity(double alpha);
-
-  virtual double value(double u) const;
-
-  virtual Ord value(Ord u) const;
-
-  virtual double derivative(double u) const;
-
-  virtual Ord derivative(Ord u) const;
-
-  protected:
-    double alpha;
-};
-
 /* Essential boundary condition */
 
 class EssentialBCNonConst : public EssentialBoundaryCondition<double> 
@@ -52,3 +36,14 @@ public:
   virtual Ord ord(Ord x, Ord y) const;
   MeshFunction<double>* clone() const;
 };
+
+/* Benchmark */
+
+// Performs 'num_steps' time steps from the initial condition with each
+// embedded implicit (DIRK) table, once by RungeKutta (all stages in one
+// system) and once by StageRungeKutta (stage by stage), and prints the times,
+// the Newton iterations of StageRungeKutta and the relative difference of
+// the results.
+
+void run_dirk_benchmark(Mesh* mesh, const Space<double>* space, WeakForm<double>* wf, double time_step,
+                        int num_steps, double newton_tol, int newton_max_iter);
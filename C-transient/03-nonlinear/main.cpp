@@ -1,6 +1,8 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "time_levels.h"
 
 using namespace RefinementSelectors;
 
@@ -23,11 +25,13 @@ using namespace RefinementSelectors;
 //  The following parameters can be changed:
 
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 3;                   
+int INIT_GLOB_REF_NUM = 3;                   
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 4;                    
+int INIT_BDY_REF_NUM = 4;                    
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 2;                              
+int P_INIT = 2;                              
 // Time step.
 const double time_step = 0.2;                      
 // Time interval length.
@@ -36,6 +40,15 @@ const double T_FINAL = 5.0;
 const double NEWTON_TOL = 1e-5;                    
 // Maximum allowed number of Newton iterations.
 const int NEWTON_MAX_ITER = 100;                   
+// Diagonally implicit tables: solve the stages one after the other, each by
+// the Newton's method with ndof unknowns (common/stage_runge_kutta.h, needs
+// SOLVER_UMFPACK). Set to "false" to solve for all stages at once by
+// RungeKutta.
+bool STAGE_BY_STAGE = true;
+// Set to "true" to compare both on the embedded implicit tables below, with
+// BENCHMARK_STEPS time steps each.
+bool DIRK_BENCHMARK = false;
+int BENCHMARK_STEPS = 5;
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;   
@@ -65,6 +78,17 @@ const double heat_src = 1.0;
 // Main function.
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("STAGE_BY_STAGE", STAGE_BY_STAGE);
+  parameters.get("DIRK_BENCHMARK", DIRK_BENCHMARK);
+  parameters.get("BENCHMARK_STEPS", BENCHMARK_STEPS);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
   // Choose a Butcher's table or define your own.
   ButcherTable bt(butcher_table_type);
   if (bt.is_explicit()) Hermes::Mixins::Loggable::Static::info("Using a %d-stage explicit R-K method.", bt.get_size());
@@ -89,24 +113,46 @@ int main(int argc, char* argv[])
   int ndof = space.get_num_dofs();
   Hermes::Mixins::Loggable::Static::info("ndof = %d.", ndof);
 
-  // Previous time level solution (initialized by the initial condition).
-  CustomInitialCondition sln_time_prev(&mesh);
+  // Previous time level solution (initialized by the initial condition) and
+  // the next one.
+  CustomInitialCondition sln_init(&mesh);
+  TimeLevels<double> time_levels(2);
+  time_levels.set(1, &sln_init);
 
   // Initialize the weak formulation
-  CustomNonlinearity lambda(alpha);
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(alpha, -1.0, -1.0);
   Hermes2DFunction<double> f(heat_src);
-  DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &f);
-
-  // Next time level solution.
-  Solution<double> sln_time_new(&mesh);
+  BatchWeakFormPoisson wf(HERMES_ANY, lambda, &f);
 
   // Initialize Runge-Kutta time stepping.
   RungeKutta<double> runge_kutta(&wf, &space, &bt);
 
+  // Stage by stage time stepping of diagonally implicit tables, and the
+  // coefficient vector of the initial condition.
+  StageRungeKutta stage_runge_kutta(&wf, &space, &bt);
+  bool stage_by_stage = STAGE_BY_STAGE && stage_runge_kutta.is_diagonally_implicit();
+  std::vector<double> coeff_vec(ndof);
+  if (stage_by_stage)
+  {
+    stage_runge_kutta.set_linear(false);
+    stage_runge_kutta.set_newton_tol(NEWTON_TOL);
+    stage_runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
+    OGProjection<double> ogProjection;
+    ogProjection.project_global(&space, &sln_init, &coeff_vec[0]);
+  }
+
+  if (DIRK_BENCHMARK)
+    run_dirk_benchmark(&mesh, &space, &wf, time_step, BENCHMARK_STEPS, NEWTON_TOL, NEWTON_MAX_ITER);
+
   // Initialize views.
-  ScalarView sview("Solution", new WinGeom(0, 0, 500, 400));
-  OrderView oview("Mesh", new WinGeom(510, 0, 460, 400));
-  oview.show(&space);
+  ScalarView* sview = NULL;
+  OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new ScalarView("Solution", new WinGeom(0, 0, 500, 400));
+    oview = new OrderView("Mesh", new WinGeom(510, 0, 460, 400));
+    oview->show(&space);
+  }
 
   // Time stepping loop:
   double current_time = 0; int ts = 1;
@@ -120,19 +166,29 @@ int main(int argc, char* argv[])
     double damping_coeff = 1.0;
     double max_allowed_residual_norm = 1e10;
     Hermes::vector<Solution<double>*> slns_time_prev;
-    slns_time_prev.push_back(&sln_time_prev);
+    slns_time_prev.push_back(time_levels.get(1));
     Hermes::vector<Solution<double>*> slns_time_new;
-    slns_time_new.push_back(&sln_time_new);
+    slns_time_new.push_back(time_levels.get(0));
     try
     {
-      runge_kutta.set_verbose_output(true);
-      runge_kutta.set_time(current_time);
-      runge_kutta.set_time_step(time_step);
-      runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
-      runge_kutta.set_newton_tol(NEWTON_TOL);
-      runge_kutta.set_newton_max_allowed_residual_norm(max_allowed_residual_norm);
-      
-      runge_kutta.rk_time_step_newton(slns_time_prev, slns_time_new);
+      if (stage_by_stage)
+      {
+        stage_runge_kutta.set_time(current_time);
+        stage_runge_kutta.set_time_step(time_step);
+        stage_runge_kutta.rk_time_step(&coeff_vec[0]);
+        Solution<double>::vector_to_solution(&coeff_vec[0], &space, time_levels.get(0));
+      }
+      else
+      {
+        runge_kutta.set_verbose_output(true);
+        runge_kutta.set_time(current_time);
+        runge_kutta.set_time_step(time_step);
+        runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
+        runge_kutta.set_newton_tol(NEWTON_TOL);
+        runge_kutta.set_newton_max_allowed_residual_norm(max_allowed_residual_norm);
+
+        runge_kutta.rk_time_step_newton(slns_time_prev, slns_time_new);
+      }
     }
     catch(Exceptions::Exception& e)
     {
@@ -142,22 +198,34 @@ int main(int argc, char* argv[])
     // Update time.
     current_time += time_step;
 
-    // Show the new time level solution.
-    char title[100];
-    sprintf(title, "Solution, t = %g", current_time);
-    sview.set_title(title);
-    sview.show(&sln_time_new, HERMES_EPS_HIGH);
-    oview.show(&space);
+    if (HERMES_VISUALIZATION)
+    {
+      // Show the new time level solution.
+      char title[100];
+      sprintf(title, "Solution, t = %g", current_time);
+      sview->set_title(title);
+      sview->show(time_levels.get(0), HERMES_EPS_HIGH);
+      oview->show(&space);
+    }
 
-    // Copy solution for the new time step.
-    sln_time_prev.copy(&sln_time_new);
+    // The new solution becomes the previous one (no copy).
+    time_levels.rotate();
 
     // Increase counter of time steps.
     ts++;
   }
   while (current_time < T_FINAL);
 
+  if (stage_by_stage)
+    Hermes::Mixins::Loggable::Static::info("Stage by stage: %d time steps, %d Newton iterations, %d symbolic and %d numeric factorizations.",
+         stage_runge_kutta.get_num_steps(), stage_runge_kutta.get_num_newton_iters(),
+         stage_runge_kutta.get_num_factorizations(), stage_runge_kutta.get_num_numeric_factorizations());
+
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete lambda;
+  delete sview;
+  delete oview;
   return 0;
 }
@@ -1,5 +1,7 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "solution_output.h"
 
 using namespace RefinementSelectors;
 
@@ -34,11 +36,15 @@ using namespace RefinementSelectors;
 // The following parameters can be changed:
 
 // Set to "false" to suppress Hermes OpenGL visualization. 
-const bool HERMES_VISUALIZATION = true;           
+bool HERMES_VISUALIZATION = true;           
 // Set to "true" to enable VTK output.
-const bool VTK_VISUALIZATION = false;             
+bool VTK_VISUALIZATION = false;             
+// Format of the VTK output: 0 = legacy ASCII (.vtk), 1 = binary VTU, 
+// 2 = zlib-compressed VTU, 3 = XDMF + HDF5 (see common/solution_output.h).
+// Binary output is written by a separate thread during the next adaptivity step.
+int VTK_FORMAT = 0;
 // Initial polynomial degree of mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies.
 const double THRESHOLD = 0.8;                     
@@ -83,6 +89,19 @@ const double EPS_AIR = 1.0 * EPS0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("VTK_FORMAT", VTK_FORMAT);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
+  // Binary output format (VTK_FORMAT 0 selects the legacy output below).
+  SolutionOutput::Format output_format = SolutionOutput::FORMAT_VTU;
+  if (VTK_FORMAT != 0)
+    output_format = SolutionOutput::get_format(VTK_FORMAT);
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -106,10 +125,15 @@ int main(int argc, char* argv[])
   H1ProjBasedSelector<double> selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  Views::ScalarView sview("Solution", new Views::WinGeom(0, 0, 410, 600));
-  sview.fix_scale_width(50);
-  sview.show_mesh(false);
-  Views::OrderView  oview("Polynomial orders", new Views::WinGeom(420, 0, 400, 600));
+  Views::ScalarView* sview = NULL;
+  Views::OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new Views::ScalarView("Solution", new Views::WinGeom(0, 0, 410, 600));
+    sview->fix_scale_width(50);
+    sview->show_mesh(false);
+    oview = new Views::OrderView("Polynomial orders", new Views::WinGeom(420, 0, 400, 600));
+  }
 
   // DOF and CPU convergence graphs initialization.
   SimpleGraph graph_dof, graph_cpu;
@@ -121,6 +145,11 @@ int main(int argc, char* argv[])
   NewtonSolver<double> newton(&dp);
   newton.set_verbose_output(true);
 
+  // Binary VTK output in the background (the thread is only started if
+  // there is binary output).
+  bool binary_output = VTK_VISUALIZATION && VTK_FORMAT > 0;
+  SolutionOutput output(binary_output ? output_format : SolutionOutput::FORMAT_VTU, binary_output);
+
   // Adaptivity loop:
   int as = 1; bool done = false;
   do
@@ -165,7 +194,16 @@ int main(int argc, char* argv[])
     cpu_time.tick();
 
     // VTK output.
-    if (VTK_VISUALIZATION) 
+    if (binary_output) 
+    {
+      // The data is copied, the files are written while the computation continues.
+      char title[100];
+      sprintf(title, "sln-%d", as);
+      output.save_solution(&sln, title, "Potential", false);
+      sprintf(title, "ord-%d", as);
+      output.save_orders(&space, title);
+    }
+    else if (VTK_VISUALIZATION) 
     {
       // Output solution in VTK format.
       Views::Linearizer lin;
@@ -184,8 +222,8 @@ int main(int argc, char* argv[])
     // View the coarse mesh solution and polynomial orders.
     if (HERMES_VISUALIZATION) 
     {
-      sview.show(&sln);
-      oview.show(&space);
+      sview->show(&sln);
+      oview->show(&space);
     }
 
     // Skip visualization time.
@@ -243,14 +281,19 @@ int main(int argc, char* argv[])
 
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // Show the fine mesh solution - final result.
-  sview.set_title("Fine mesh solution");
-  sview.show_mesh(false);
-  sview.show(&ref_sln);
+  if (HERMES_VISUALIZATION)
+  {
+    // Show the fine mesh solution - final result.
+    sview->set_title("Fine mesh solution");
+    sview->show_mesh(false);
+    sview->show(&ref_sln);
 
-  // Wait for all views to be closed.
-  Views::View::wait();
+    // Wait for all views to be closed.
+    Views::View::wait();
+  }
 
+  delete sview;
+  delete oview;
   return 0;
 }
 
@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 // This example shows how to run adaptive h-FEM driven by the Kelly estimator and
 // set its basic control parameters. The underlying problem is the same as in 
@@ -38,11 +39,11 @@
 // The following parameters can be changed:
 
 // Set to "false" to suppress Hermes OpenGL visualization. 
-const bool HERMES_VISUALIZATION = true;           
+bool HERMES_VISUALIZATION = true;           
 // Set to "true" to enable VTK output.
-const bool VTK_VISUALIZATION = false;             
+bool VTK_VISUALIZATION = false;             
 // Initial polynomial degree of mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies.
 const double THRESHOLD = 0.3;                     
@@ -84,6 +85,13 @@ const double EPS_AIR = 1.0 * EPS0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("VTK_VISUALIZATION", VTK_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -104,10 +112,15 @@ int main(int argc, char* argv[])
   Solution<double> sln;
 
   // Initialize views.
-  Views::ScalarView sview("Solution", new Views::WinGeom(0, 0, 410, 600));
-  sview.fix_scale_width(50);
-  sview.show_mesh(false);
-  Views::OrderView  oview("Polynomial orders", new Views::WinGeom(420, 0, 400, 600));
+  Views::ScalarView* sview = NULL;
+  Views::OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new Views::ScalarView("Solution", new Views::WinGeom(0, 0, 410, 600));
+    sview->fix_scale_width(50);
+    sview->show_mesh(false);
+    oview = new Views::OrderView("Polynomial orders", new Views::WinGeom(420, 0, 400, 600));
+  }
 
   // DOF and CPU convergence graphs initialization.
   SimpleGraph graph_dof, graph_cpu;
@@ -170,8 +183,8 @@ int main(int argc, char* argv[])
     // View the coarse mesh solution and polynomial orders.
     if (HERMES_VISUALIZATION) 
     {
-      sview.show(&sln);
-      oview.show(&space);
+      sview->show(&sln);
+      oview->show(&space);
     }
 
     // Skip visualization time.
@@ -240,14 +253,19 @@ int main(int argc, char* argv[])
 
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // The final result has already been shown in the final step of the adaptivity loop, so we only
-  // adjust the title and hide the mesh here.
-  sview.set_title("Fine mesh solution");
-  sview.show_mesh(false);
+  if (HERMES_VISUALIZATION)
+  {
+    // The final result has already been shown in the final step of the adaptivity loop, so we only
+    // adjust the title and hide the mesh here.
+    sview->set_title("Fine mesh solution");
+    sview->show_mesh(false);
 
-  // Wait for all views to be closed.
-  Views::View::wait();
+    // Wait for all views to be closed.
+    Views::View::wait();
+  }
 
+  delete sview;
+  delete oview;
   return 0;
 }
 
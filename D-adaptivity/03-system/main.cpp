@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 // This example explains how to use the multimesh adaptive hp-FEM,
 // where different physical fields (or solution components) can be
@@ -33,12 +34,14 @@
 // h-adaptivity via the CAND_LIST option, and compare the multi-mesh vs.
 // single-mesh using the MULTI parameter.
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree for u.
-const int P_INIT_U = 2;                           
+int P_INIT_U = 2;                           
 // Initial polynomial degree for v.
-const int P_INIT_V = 1;                           
+int P_INIT_V = 1;                           
 // Number of initial boundary refinements
-const int INIT_REF_BDY = 5;                       
+int INIT_REF_BDY = 5;                       
 // MULTI = true  ... use multi-mesh,
 // MULTI = false ... use single-mesh.
 // Note: In the single mesh option, the meshes are
@@ -94,6 +97,14 @@ const double K = 100.;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT_U", P_INIT_U);
+  parameters.get("P_INIT_V", P_INIT_V);
+  parameters.get("INIT_REF_BDY", INIT_REF_BDY);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -139,12 +150,19 @@ int main(int argc, char* argv[])
   H1ProjBasedSelector<double> selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  Views::ScalarView s_view_0("Solution[0]", new Views::WinGeom(0, 0, 440, 350));
-  s_view_0.show_mesh(false);
-  Views::OrderView  o_view_0("Mesh[0]", new Views::WinGeom(450, 0, 420, 350));
-  Views::ScalarView s_view_1("Solution[1]", new Views::WinGeom(880, 0, 440, 350));
-  s_view_1.show_mesh(false);
-  Views::OrderView o_view_1("Mesh[1]", new Views::WinGeom(1330, 0, 420, 350));
+  Views::ScalarView* s_view_0 = NULL;
+  Views::OrderView* o_view_0 = NULL;
+  Views::ScalarView* s_view_1 = NULL;
+  Views::OrderView* o_view_1 = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    s_view_0 = new Views::ScalarView("Solution[0]", new Views::WinGeom(0, 0, 440, 350));
+    s_view_0->show_mesh(false);
+    o_view_0 = new Views::OrderView("Mesh[0]", new Views::WinGeom(450, 0, 420, 350));
+    s_view_1 = new Views::ScalarView("Solution[1]", new Views::WinGeom(880, 0, 440, 350));
+    s_view_1->show_mesh(false);
+    o_view_1 = new Views::OrderView("Mesh[1]", new Views::WinGeom(1330, 0, 420, 350));
+  }
 
   // DOF and CPU convergence graphs.
   SimpleGraph graph_dof_est, graph_cpu_est; 
@@ -207,11 +225,14 @@ int main(int argc, char* argv[])
    
     cpu_time.tick();
 
-    // View the coarse mesh solution and polynomial orders.
-    s_view_0.show(&u_sln); 
-    o_view_0.show(&u_space);
-    s_view_1.show(&v_sln); 
-    o_view_1.show(&v_space);
+    if (HERMES_VISUALIZATION)
+    {
+      // View the coarse mesh solution and polynomial orders.
+      s_view_0->show(&u_sln); 
+      o_view_0->show(&u_space);
+      s_view_1->show(&v_sln); 
+      o_view_1->show(&v_space);
+    }
 
     // Calculate element errors.
     Hermes::Mixins::Loggable::Static::info("Calculating error estimate and exact error."); 
@@ -280,6 +301,11 @@ int main(int argc, char* argv[])
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
   // Wait for all views to be closed.
-  Views::View::wait();
+  if (HERMES_VISUALIZATION)
+    Views::View::wait();
+  delete s_view_0;
+  delete o_view_0;
+  delete s_view_1;
+  delete o_view_1;
   return 0;
 }
@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "marker_table_forms.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -8,7 +9,13 @@ using namespace Hermes::Hermes2D;
 class CustomWeakForm : public WeakForm<std::complex<double> >
 { 
 public:
-  CustomWeakForm(std::string mat_air,  double mu_air,
+  CustomWeakForm(Mesh* mesh, std::string mat_air,  double mu_air,
                  std::string mat_iron, double mu_iron, double gamma_iron,
                  std::string mat_wire, double mu_wire, std::complex<double> j_ext, double omega);
+
+  virtual ~CustomWeakForm();
+
+protected:
+  // Reluctivity 1/mu of the materials.
+  MarkerCoefficientTable<std::complex<double> >* nu_table;
 };
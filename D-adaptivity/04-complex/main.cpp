@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes::Hermes2D::RefinementSelectors;
 
@@ -18,10 +19,12 @@ using namespace Hermes::Hermes2D::RefinementSelectors;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 0;                       
+int INIT_REF_NUM = 0;                       
 // Initial polynomial degree of mesh elements.
-const int P_INIT = 1;                             
+int P_INIT = 1;                             
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies.
 const double THRESHOLD = 0.3;                     
@@ -77,6 +80,13 @@ const double OMEGA = 2 * M_PI * FREQ;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -100,7 +110,7 @@ int main(int argc, char* argv[])
   Hermes::Mixins::Loggable::Static::info("ndof = %d", ndof);
 
   // Initialize the weak formulation.
-  CustomWeakForm wf("Air", MU_0, "Iron", MU_IRON, GAMMA_IRON,
+  CustomWeakForm wf(&mesh, "Air", MU_0, "Iron", MU_IRON, GAMMA_IRON,
     "Wire", MU_0, std::complex<double>(J_EXT, 0.0), OMEGA);
 
   // Initialize coarse and reference mesh solution.
@@ -111,9 +121,14 @@ int main(int argc, char* argv[])
       selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  Views::ScalarView sview("Solution", new Views::WinGeom(0, 0, 600, 350));
-  sview.show_mesh(false);
-  Views::OrderView oview("Polynomial orders", new Views::WinGeom(610, 0, 520, 350));
+  Views::ScalarView* sview = NULL;
+  Views::OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new Views::ScalarView("Solution", new Views::WinGeom(0, 0, 600, 350));
+    sview->show_mesh(false);
+    oview = new Views::OrderView("Polynomial orders", new Views::WinGeom(610, 0, 520, 350));
+  }
 
   // DOF and CPU convergence graphs initialization.
   SimpleGraph graph_dof, graph_cpu;
@@ -158,11 +173,14 @@ int main(int argc, char* argv[])
     Hermes::Mixins::Loggable::Static::info("Projecting reference solution on coarse mesh.");
     OGProjection<std::complex<double> > ogProjection; ogProjection.project_global(&space, &ref_sln, &sln);
 
-    // View the coarse mesh solution and polynomial orders.
-    RealFilter real_filter(&sln);
-    sview.show(&real_filter);
+    if (HERMES_VISUALIZATION)
+    {
+      // View the coarse mesh solution and polynomial orders.
+      RealFilter real_filter(&sln);
+      sview->show(&real_filter);
 
-    oview.show(&space);
+      oview->show(&space);
+    }
 
     // Calculate element errors and total error estimate.
     Hermes::Mixins::Loggable::Static::info("Calculating error estimate.");
@@ -200,13 +218,18 @@ int main(int argc, char* argv[])
 
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // Show the reference solution - the final result.
-  sview.set_title("Fine mesh solution");
+  if (HERMES_VISUALIZATION)
+  {
+    // Show the reference solution - the final result.
+    sview->set_title("Fine mesh solution");
 
-  RealFilter real_filter(&ref_sln);
-  sview.show(&real_filter);
+    RealFilter real_filter(&ref_sln);
+    sview->show(&real_filter);
 
-  // Wait for all views to be closed.
-  Views::View::wait();
+    // Wait for all views to be closed.
+    Views::View::wait();
+  }
+  delete sview;
+  delete oview;
   return 0;
 }
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "hermes2d.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -25,15 +26,15 @@ using namespace Hermes::Hermes2D::RefinementSelectors;
 //  The following parameters can be changed:
 
 // Set to "false" to suppress Hermes OpenGL visualization.
-const bool HERMES_VISUALIZATION = true;
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree. NOTE: The meaning is different from
 // standard continuous elements in the space H1. Here, P_INIT refers
 // to the maximum poly order of the tangential component, and polynomials
 // of degree P_INIT + 1 are present in element interiors. P_INIT = 0
 // is for Whitney elements.
-const int P_INIT = 2;
+int P_INIT = 2;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 1;
+int INIT_REF_NUM = 1;
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies (see below).
 const double THRESHOLD = 0.3;
@@ -82,6 +83,13 @@ const double LAMBDA = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -113,9 +121,14 @@ int main(int argc, char* argv[])
   HcurlProjBasedSelector<std::complex<double> > selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  Views::VectorView v_view("Solution (magnitude)", new Views::WinGeom(0, 0, 460, 350));
-  v_view.set_min_max_range(0, 1.5);
-  Views::OrderView  o_view("Polynomial orders", new Views::WinGeom(470, 0, 400, 350));
+  Views::VectorView* v_view = NULL;
+  Views::OrderView* o_view = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    v_view = new Views::VectorView("Solution (magnitude)", new Views::WinGeom(0, 0, 460, 350));
+    v_view->set_min_max_range(0, 1.5);
+    o_view = new Views::OrderView("Polynomial orders", new Views::WinGeom(470, 0, 400, 350));
+  }
 
   // DOF and CPU convergence graphs.
   SimpleGraph graph_dof_est, graph_cpu_est,
@@ -165,8 +178,8 @@ int main(int argc, char* argv[])
     if(HERMES_VISUALIZATION)
     {
       RealFilter real_filter(&sln);
-      v_view.show(&real_filter);
-      o_view.show(&space);
+      v_view->show(&real_filter);
+      o_view->show(&space);
       lin.save_solution_vtk(&real_filter, "sln.vtk", "a");
       ord.save_mesh_vtk(&space, "mesh.vtk");
       lin.free();
@@ -212,12 +225,14 @@ int main(int argc, char* argv[])
   // Show the reference solution - the final result.
   if(HERMES_VISUALIZATION)
   {
-    v_view.set_title("Fine mesh solution (magnitude)");
+    v_view->set_title("Fine mesh solution (magnitude)");
     RealFilter real_filter(&ref_sln);
-    v_view.show(&real_filter);
+    v_view->show(&real_filter);
 
     // Wait for all views to be closed.
     Views::View::wait();
   }
+  delete v_view;
+  delete o_view;
   return 0;
 }
\ No newline at end of file
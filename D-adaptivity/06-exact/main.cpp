@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace RefinementSelectors;
 using namespace Views;
@@ -10,8 +11,10 @@ using namespace Views;
 //
 // The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree of mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies.
 const double THRESHOLD = 0.2;                     
@@ -50,6 +53,12 @@ MatrixSolverType matrix_solver = SOLVER_UMFPACK;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -73,10 +82,15 @@ int main(int argc, char* argv[])
   H1ProjBasedSelector<double> selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  ScalarView sview("Scalar potential Phi", new WinGeom(0, 0, 610, 300));
-  sview.fix_scale_width(40);
-  sview.show_mesh(false);
-  OrderView  oview("Mesh", new WinGeom(620, 0, 600, 300));
+  ScalarView* sview = NULL;
+  OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new ScalarView("Scalar potential Phi", new WinGeom(0, 0, 610, 300));
+    sview->fix_scale_width(40);
+    sview->show_mesh(false);
+    oview = new OrderView("Mesh", new WinGeom(620, 0, 600, 300));
+  }
 
   // DOF and CPU convergence graphs.
   SimpleGraph graph_dof, graph_cpu;
@@ -105,9 +119,12 @@ int main(int argc, char* argv[])
     Hermes::Mixins::Loggable::Static::info("Projecting reference solution on coarse mesh.");
     OGProjection<double> ogProjection; ogProjection.project_global(&space, ref_sln, &sln); 
    
-    // View the coarse mesh solution and polynomial orders.
-    sview.show(&sln);
-    oview.show(&space);
+    if (HERMES_VISUALIZATION)
+    {
+      // View the coarse mesh solution and polynomial orders.
+      sview->show(&sln);
+      oview->show(&space);
+    }
 
     // Calculate element errors and total error estimate.
     Hermes::Mixins::Loggable::Static::info("Calculating exact error."); 
@@ -150,12 +167,17 @@ int main(int argc, char* argv[])
   
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // Show the reference solution - the final result.
-  sview.set_title("Fine mesh solution");
-  sview.show(ref_sln);
+  if (HERMES_VISUALIZATION)
+  {
+    // Show the reference solution - the final result.
+    sview->set_title("Fine mesh solution");
+    sview->show(ref_sln);
 
-  // Wait for all views to be closed.
-  View::wait();
+    // Wait for all views to be closed.
+    View::wait();
+  }
+  delete sview;
+  delete oview;
   return 0;
 }
 
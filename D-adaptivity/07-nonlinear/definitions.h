@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "uniform_cubic_spline.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace RefinementSelectors;
 using namespace Views;
@@ -17,12 +18,14 @@ using namespace Views;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 1;                             
+int P_INIT = 1;                             
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 1;                  
+int INIT_GLOB_REF_NUM = 1;                  
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 3;                   
+int INIT_BDY_REF_NUM = 3;                   
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies.
 const double THRESHOLD = 0.2;                     
@@ -70,6 +73,14 @@ double heat_src = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
 
   // Define nonlinear thermal conductivity lambda(u) via a cubic spline.
   // Step 1: Fill the x values and use lambda_macro(u) = 1 + u^4 for the y values.
@@ -92,6 +103,9 @@ int main(int argc, char* argv[])
   double interval_extension = 3.0;
   lambda.calculate_coeffs();
   lambda.plot("spline.dat", interval_extension);
+  // Step 3: The same spline with a constant-time interval lookup, evaluated
+  // in all integration points of an element at once by the weak forms.
+  UniformCubicSpline lambda_lookup(&lambda, lambda_pts);
 
   // Load the mesh.
   Mesh mesh;
@@ -111,7 +125,7 @@ int main(int argc, char* argv[])
 
   // Initialize the weak formulation
   Hermes2DFunction<double> f(-heat_src);
-  WeakFormsH1::DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &f);
+  BatchWeakFormPoisson wf(HERMES_ANY, &lambda_lookup, &f);
 
   // Initialize the FE problem.
   DiscreteProblem<double> dp_coarse(&wf, &space);
@@ -127,9 +141,14 @@ int main(int argc, char* argv[])
   cpu_time.tick();
 
   // Initialize views.
-  ScalarView sview("Solution", new WinGeom(0, 0, 440, 350));
-  sview.show_mesh(false);
-  OrderView oview("Mesh", new WinGeom(450, 0, 400, 350));
+  ScalarView* sview = NULL;
+  OrderView* oview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new ScalarView("Solution", new WinGeom(0, 0, 440, 350));
+    sview->show_mesh(false);
+    oview = new OrderView("Mesh", new WinGeom(450, 0, 400, 350));
+  }
 
   // DOF and CPU convergence graphs.
   SimpleGraph graph_dof_est, graph_cpu_est;
@@ -236,9 +255,12 @@ int main(int argc, char* argv[])
     graph_cpu_est.add_values(cpu_time.accumulated(), err_est_rel);
     graph_cpu_est.save("conv_cpu_est.dat");
 
-    // View the coarse mesh solution.
-    sview.show(&sln);
-    oview.show(&space);
+    if (HERMES_VISUALIZATION)
+    {
+      // View the coarse mesh solution.
+      sview->show(&sln);
+      oview->show(&space);
+    }
 
     // If err_est_rel too large, adapt the mesh.
     if (err_est_rel < ERR_STOP) done = true;
@@ -264,13 +286,18 @@ int main(int argc, char* argv[])
 
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
-  // Show the reference solution - the final result.
-  sview.set_title("Fine mesh solution");
-  sview.show_mesh(false);
-  sview.show(&ref_sln);
+  if (HERMES_VISUALIZATION)
+  {
+    // Show the reference solution - the final result.
+    sview->set_title("Fine mesh solution");
+    sview->show_mesh(false);
+    sview->show(&ref_sln);
 
-  // Wait for keyboard or mouse input.
-  View::wait();
+    // Wait for keyboard or mouse input.
+    View::wait();
+  }
+  delete sview;
+  delete oview;
   return 0;
 }
 
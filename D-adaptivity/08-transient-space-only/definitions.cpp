@@ -1,31 +1,5 @@
 #include "definitions.h"
 
-CustomNonlinearity::CustomNonlinearity(double alpha): Hermes1DFunction<double>()
-{
-  this->is_const = false;
-  this->alpha = alpha;
-}
-
-double CustomNonlinearity::value(double u) const
-{
-  return -1 - std::pow(u, alpha);
-}
-
-Ord CustomNonlinearity::value(Ord u) const
-{ 
-  return Ord(10);
-}
-
-double CustomNonlinearity::derivative(double u) const
-{
-  return -alpha * std::pow(u, alpha - 1.0);
-}
-
-Ord CustomNonlinearity::derivative(Ord u) const
-{
-  return Ord(10);
-}
-
 EssentialBCNonConst::EssentialBCNonConst(std::string marker) : EssentialBoundaryCondition<double>(Hermes::vector<std::string>())
 {
   markers.push_back(marker);
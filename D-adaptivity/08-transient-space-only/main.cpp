@@ -1,6 +1,8 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "time_levels.h"
 
 using namespace RefinementSelectors;
 using namespace Views;
@@ -25,10 +27,12 @@ using namespace Views;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 2;                       
+int INIT_REF_NUM = 2;                       
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 2;                             
+int P_INIT = 2;                             
 // Time step. 
 double time_step = 0.05;                           
 // Time interval length.
@@ -107,6 +111,13 @@ const double heat_src = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Choose a Butcher's table or define your own.
   ButcherTable bt(butcher_table_type);
   if (bt.is_explicit()) Hermes::Mixins::Loggable::Static::info("Using a %d-stage explicit R-K method.", bt.get_size());
@@ -130,26 +141,36 @@ int main(int argc, char* argv[])
   H1Space<double> space(&mesh, &bcs, P_INIT);
   int ndof_coarse = space.get_num_dofs();
 
-  // Previous time level solution (initialized by initial condition).
-  CustomInitialCondition sln_time_prev(&mesh);
+  // Previous time level solution (initialized by initial condition) and the
+  // next one.
+  CustomInitialCondition sln_init(&mesh);
+  TimeLevels<double> time_levels(2);
+  time_levels.set(1, &sln_init);
+
+  // Reference spaces (with their meshes) of the solutions of the new and the
+  // previous time level, freed when the level is dropped.
+  Space<double>* ref_space_new = NULL;
+  Space<double>* ref_space_prev = NULL;
 
   // Initialize the weak formulation
-  CustomNonlinearity lambda(alpha);
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(alpha, -1.0, -1.0);
   Hermes2DFunction<double> f(heat_src);
-  WeakFormsH1::DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &f);
-
-  // Next time level solution.
-  Solution<double> sln_time_new(&mesh);
+  BatchWeakFormPoisson wf(HERMES_ANY, lambda, &f);
 
   // Create a refinement selector.
   H1ProjBasedSelector<double> selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Visualize initial condition.
   char title[100];
-  ScalarView view("Initial condition", new WinGeom(0, 0, 440, 350));
-  OrderView ordview("Initial mesh", new WinGeom(445, 0, 410, 350));
-  view.show(&sln_time_prev);
-  ordview.show(&space);
+  ScalarView* view = NULL;
+  OrderView* ordview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    view = new ScalarView("Initial condition", new WinGeom(0, 0, 440, 350));
+    ordview = new OrderView("Initial mesh", new WinGeom(445, 0, 410, 350));
+    view->show(&sln_init);
+    ordview->show(&space);
+  }
   
   // Initialize Runge-Kutta time stepping.
   RungeKutta<double> runge_kutta(&wf, &space, &bt);
@@ -189,6 +210,8 @@ int main(int argc, char* argv[])
 
     // Spatial adaptivity loop. Note: sln_time_prev must not be changed 
     // during spatial adaptivity. 
+    Solution<double>* sln_time_prev = time_levels.get(1);
+    Solution<double>* sln_time_new = time_levels.get(0);
     bool done = false; int as = 1;
     double err_est;
     do {
@@ -208,7 +231,7 @@ int main(int argc, char* argv[])
         runge_kutta.set_verbose_output(true);
         runge_kutta.set_time(current_time);
         runge_kutta.set_time_step(time_step);
-        runge_kutta.rk_time_step_newton(&sln_time_prev, &sln_time_new);
+        runge_kutta.rk_time_step_newton(sln_time_prev, sln_time_new);
       }
       catch(Exceptions::Exception& e)
       {
@@ -219,12 +242,12 @@ int main(int argc, char* argv[])
       // Project the fine mesh solution onto the coarse mesh.
       Solution<double> sln_coarse;
       Hermes::Mixins::Loggable::Static::info("Projecting fine mesh solution on coarse mesh for error estimation.");
-      OGProjection<double> ogProjection; ogProjection.project_global(&space, &sln_time_new, &sln_coarse); 
+      OGProjection<double> ogProjection; ogProjection.project_global(&space, sln_time_new, &sln_coarse); 
 
       // Calculate element errors and total error estimate.
       Hermes::Mixins::Loggable::Static::info("Calculating error estimate.");
       Adapt<double>* adaptivity = new Adapt<double>(&space);
-      double err_est_rel_total = adaptivity->calc_err_est(&sln_coarse, &sln_time_new) * 100;
+      double err_est_rel_total = adaptivity->calc_err_est(&sln_coarse, sln_time_new) * 100;
 
       // Report results.
       Hermes::Mixins::Loggable::Static::info("ndof_coarse: %d, ndof_ref: %d, err_est_rel: %g%%", 
@@ -244,26 +267,42 @@ int main(int argc, char* argv[])
           as++;
       }
       
-      // Visualize the solution and mesh.
-      char title[100];
-      sprintf(title, "Solution, time %g", current_time);
-      view.set_title(title);
-      view.show_mesh(false);
-      view.show(&sln_time_new);
-      sprintf(title, "Mesh, time %g", current_time);
-      ordview.set_title(title);
-      ordview.show(&space);
+      if (HERMES_VISUALIZATION)
+      {
+        // Visualize the solution and mesh.
+        char title[100];
+        sprintf(title, "Solution, time %g", current_time);
+        view->set_title(title);
+        view->show_mesh(false);
+        view->show(sln_time_new);
+        sprintf(title, "Mesh, time %g", current_time);
+        ordview->set_title(title);
+        ordview->show(&space);
+      }
 
       // Clean up.
       delete adaptivity;
       if(!done) {
         delete ref_space;
-        delete sln_time_new.get_mesh();
+        delete sln_time_new->get_mesh();
       }
+      else
+        ref_space_new = ref_space;
     }
     while (done == false);
 
-    sln_time_prev.copy(&sln_time_new);
+    // The new solution (on the last reference mesh, which is kept) becomes
+    // the previous one (no copy).
+    time_levels.rotate();
+
+    // The dropped level is overwritten in the next step, the reference space
+    // and mesh of its solution are no longer needed.
+    if (ref_space_prev != NULL)
+    {
+      delete ref_space_prev->get_mesh();
+      delete ref_space_prev;
+    }
+    ref_space_prev = ref_space_new;
 
     // Increase current time and counter of time steps.
     current_time += time_step;
@@ -272,6 +311,15 @@ int main(int argc, char* argv[])
   while (current_time < T_FINAL);
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete lambda;
+  if (ref_space_prev != NULL)
+  {
+    delete ref_space_prev->get_mesh();
+    delete ref_space_prev;
+  }
+  delete view;
+  delete ordview;
   return 0;
 }
@@ -1,27 +1,9 @@
 #include "hermes2d.h"
+#include "power_law.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
 
-/* Nonlinearity lambda(u) = pow(u, alpha) */
-
-class CustomNonlinearity : public Hermes1DFunction<double>
-{
-public:
-  CustomNonlinearity(double alpha);
-
-  virtual double value(double u) const;
-
-  virtual Ord value(Ord u) const;
-
-  virtual double derivative(double u) const;
-
-  virtual Ord derivative(Ord u) const;
-
-  protected:
-    double alpha;
-};
-
 /* Essential boundary condition */
 
 class EssentialBCNonConst : public EssentialBoundaryCondition<double>
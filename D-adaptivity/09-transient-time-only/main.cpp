@@ -1,6 +1,8 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "time_levels.h"
 
 using namespace RefinementSelectors;
 using namespace Views;
@@ -28,11 +30,13 @@ using namespace Views;
 //  The following parameters can be changed:
 
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 3;                   
+int INIT_GLOB_REF_NUM = 3;                   
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 4;                    
+int INIT_BDY_REF_NUM = 4;                    
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 2;                              
+int P_INIT = 2;                              
 // Time step.
 double time_step = 0.5;                           
 // Time interval length.
@@ -79,6 +83,14 @@ const double heat_src = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
   // Choose a Butcher's table or define your own.
   ButcherTable bt(butcher_table_type);
   if (bt.is_explicit()) Hermes::Mixins::Loggable::Static::info("Using a %d-stage explicit R-K method.", bt.get_size());
@@ -102,20 +114,27 @@ int main(int argc, char* argv[])
   H1Space<double> space(&mesh, &bcs, P_INIT);
   int ndof = space.get_num_dofs();
 
-  // Convert initial condition into a Solution.
-  CustomInitialCondition sln_time_prev(&mesh);
-  Solution<double> sln_time_new(&mesh);
+  // Convert initial condition into a Solution. It is the previous time
+  // level of the first step.
+  CustomInitialCondition sln_init(&mesh);
+  TimeLevels<double> time_levels(2);
+  time_levels.set(1, &sln_init);
   ZeroSolution<double> time_error_fn(&mesh);
 
   // Initialize the weak formulation
-  CustomNonlinearity lambda(alpha);
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(alpha, -1.0, -1.0);
   Hermes2DFunction<double> f(heat_src);
-  WeakFormsH1::DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &f);
+  BatchWeakFormPoisson wf(HERMES_ANY, lambda, &f);
 
   // Initialize views.
-  ScalarView sview_high("Solution (higher-order)", new WinGeom(0, 0, 500, 400));
-  ScalarView eview("Temporal error", new WinGeom(500, 0, 500, 400));
-  eview.fix_scale_width(50);
+  ScalarView* sview_high = NULL;
+  ScalarView* eview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview_high = new ScalarView("Solution (higher-order)", new WinGeom(0, 0, 500, 400));
+    eview = new ScalarView("Temporal error", new WinGeom(500, 0, 500, 400));
+    eview->fix_scale_width(50);
+  }
 
   RungeKutta<double> runge_kutta(&wf, &space, &bt);
 
@@ -130,6 +149,7 @@ int main(int argc, char* argv[])
     // Perform one Runge-Kutta time step according to the selected Butcher's table.
     Hermes::Mixins::Loggable::Static::info("Runge-Kutta time step (t = %g, tau = %g, stages: %d).", 
          current_time, time_step, bt.get_size());
+    Solution<double>* sln_time_new = time_levels.get(0);
     try
     {
       runge_kutta.set_verbose_output(true);
@@ -137,24 +157,27 @@ int main(int argc, char* argv[])
       runge_kutta.set_time_step(time_step);
       runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
       runge_kutta.set_newton_tol(NEWTON_TOL);
-      runge_kutta.rk_time_step_newton(&sln_time_prev, &sln_time_new, &time_error_fn);
+      runge_kutta.rk_time_step_newton(time_levels.get(1), sln_time_new, &time_error_fn);
     }
     catch(Exceptions::Exception& e)
     {
       std::cout << e.what();
     }
 
-    // Plot error function.
-    char title[100];
-    sprintf(title, "Temporal error, t = %g", current_time);
-    eview.set_title(title);
-    AbsFilter abs_tef(&time_error_fn);
-    eview.show(&abs_tef);
+    if (HERMES_VISUALIZATION)
+    {
+      // Plot error function.
+      char title[100];
+      sprintf(title, "Temporal error, t = %g", current_time);
+      eview->set_title(title);
+      AbsFilter abs_tef(&time_error_fn);
+      eview->show(&abs_tef);
     
-    // Show the new time level solution.
-    sprintf(title, "Solution (higher-order), t = %g", current_time);
-    sview_high.set_title(title);
-    sview_high.show(&sln_time_new);
+      // Show the new time level solution.
+      sprintf(title, "Solution (higher-order), t = %g", current_time);
+      sview_high->set_title(title);
+      sview_high->show(sln_time_new);
+    }
 
     // Calculate relative time stepping error and decide whether the 
     // time step can be accepted. If not, then the time step size is 
@@ -162,7 +185,7 @@ int main(int argc, char* argv[])
     // check is run, and if the relative error is very low, time step 
     // is increased.
     double rel_err_time = Global<double>::calc_norm(&time_error_fn, HERMES_H1_NORM) / 
-                          Global<double>::calc_norm(&sln_time_new, HERMES_H1_NORM) * 100;
+                          Global<double>::calc_norm(sln_time_new, HERMES_H1_NORM) * 100;
     Hermes::Mixins::Loggable::Static::info("rel_err_time = %g%%", rel_err_time);
     if (rel_err_time > TIME_TOL_UPPER) {
       Hermes::Mixins::Loggable::Static::info("rel_err_time above upper limit %g%% -> decreasing time step from %g to %g and repeating time step.", 
@@ -180,8 +203,8 @@ int main(int argc, char* argv[])
     time_step_graph.add_values(current_time, time_step);
     time_step_graph.save("time_step_history.dat");
 
-    // Copy solution for next time step.
-    sln_time_prev.copy(&sln_time_new);
+    // The new solution becomes the previous one (no copy).
+    time_levels.rotate();
 
     // Update time.
     current_time += time_step;
@@ -193,6 +216,10 @@ int main(int argc, char* argv[])
   while (current_time < T_FINAL);
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete lambda;
+  delete sview_high;
+  delete eview;
   return 0;
 }
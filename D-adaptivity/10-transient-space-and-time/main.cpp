@@ -1,6 +1,8 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
+#include "time_levels.h"
 
 using namespace RefinementSelectors;
 using namespace Views;
@@ -27,11 +29,13 @@ using namespace Views;
 //  The following parameters can be changed:
 
 // Number of initial uniform mesh refinements.
-const int INIT_GLOB_REF_NUM = 2;                   
+int INIT_GLOB_REF_NUM = 2;                   
 // Number of initial refinements towards boundary.
-const int INIT_BDY_REF_NUM = 0;                    
+int INIT_BDY_REF_NUM = 0;                    
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree.
-const int P_INIT = 2;                              
+int P_INIT = 2;                              
 // Time step. 
 double time_step = 0.05;                           
 // Time interval length.
@@ -128,6 +132,14 @@ const double heat_src = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_GLOB_REF_NUM", INIT_GLOB_REF_NUM);
+  parameters.get("INIT_BDY_REF_NUM", INIT_BDY_REF_NUM);
+  parameters.check_unused();
+
   // Choose a Butcher's table or define your own.
   ButcherTable bt(butcher_table_type);
   if (bt.is_explicit()) Hermes::Mixins::Loggable::Static::info("Using a %d-stage explicit R-K method.", bt.get_size());
@@ -158,13 +170,21 @@ int main(int argc, char* argv[])
   H1Space<double> space(&mesh, &bcs, P_INIT);
   int ndof = space.get_num_dofs();
 
-  // Convert initial condition into a Solution.
-  CustomInitialCondition sln_time_prev(&mesh);
+  // Convert initial condition into a Solution. It is the previous time
+  // level of the first step.
+  CustomInitialCondition sln_init(&mesh);
+  TimeLevels<double> time_levels(2);
+  time_levels.set(1, &sln_init);
+
+  // Reference spaces (with their meshes) of the solutions of the new and the
+  // previous time level, freed when the level is dropped.
+  Space<double>* ref_space_new = NULL;
+  Space<double>* ref_space_prev = NULL;
 
   // Initialize the weak formulation
-  CustomNonlinearity lambda(alpha);
+  PowerLawNonlinearity* lambda = create_power_law_nonlinearity(alpha, -1.0, -1.0);
   Hermes2DFunction<double> f(heat_src);
-  WeakFormsH1::DefaultWeakFormPoisson<double> wf(HERMES_ANY, &lambda, &f);
+  BatchWeakFormPoisson wf(HERMES_ANY, lambda, &f);
 
   // Initialize the discrete problem.
   DiscreteProblem<double> dp(&wf, &space);
@@ -174,15 +194,22 @@ int main(int argc, char* argv[])
 
   // Visualize initial condition.
   char title[100];
-  ScalarView sln_view("Initial condition", new WinGeom(0, 0, 440, 350));
-  sln_view.show_mesh(false);
-  OrderView ordview("Initial mesh", new WinGeom(445, 0, 440, 350));
-  ScalarView time_error_view("Temporal error", new WinGeom(0, 400, 440, 350));
-  time_error_view.fix_scale_width(60);
-  ScalarView space_error_view("Spatial error", new WinGeom(445, 400, 440, 350));
-  space_error_view.fix_scale_width(60);
-  sln_view.show(&sln_time_prev);
-  ordview.show(&space);
+  ScalarView* sln_view = NULL;
+  OrderView* ordview = NULL;
+  ScalarView* time_error_view = NULL;
+  ScalarView* space_error_view = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sln_view = new ScalarView("Initial condition", new WinGeom(0, 0, 440, 350));
+    sln_view->show_mesh(false);
+    ordview = new OrderView("Initial mesh", new WinGeom(445, 0, 440, 350));
+    time_error_view = new ScalarView("Temporal error", new WinGeom(0, 400, 440, 350));
+    time_error_view->fix_scale_width(60);
+    space_error_view = new ScalarView("Spatial error", new WinGeom(445, 400, 440, 350));
+    space_error_view->fix_scale_width(60);
+    sln_view->show(&sln_init);
+    ordview->show(&space);
+  }
 
   // Graph for time step history.
   SimpleGraph time_step_graph;
@@ -215,7 +242,8 @@ int main(int argc, char* argv[])
 
     // Spatial adaptivity loop. Note: sln_time_prev must not be 
     // changed during spatial adaptivity. 
-    Solution<double> ref_sln;
+    Solution<double>* sln_time_prev = time_levels.get(1);
+    Solution<double>* ref_sln = time_levels.get(0);
     Solution<double>* time_error_fn;
     if (bt.is_embedded() == true) time_error_fn = new Solution<double>(&mesh);
     else time_error_fn = NULL;
@@ -238,7 +266,7 @@ int main(int argc, char* argv[])
         runge_kutta.set_time_step(time_step);
         runge_kutta.set_newton_max_iter(NEWTON_MAX_ITER);
         runge_kutta.set_newton_tol(NEWTON_TOL_FINE);
-        runge_kutta.rk_time_step_newton(&sln_time_prev, &ref_sln, time_error_fn);
+        runge_kutta.rk_time_step_newton(sln_time_prev, ref_sln, time_error_fn);
       }
       catch(Exceptions::Exception& e)
       {
@@ -253,16 +281,19 @@ int main(int argc, char* argv[])
       if (bt.is_embedded() == true) {
         Hermes::Mixins::Loggable::Static::info("Calculating temporal error estimate.");
 
-        // Show temporal error.
-        char title[100];
-        sprintf(title, "Temporal error est, spatial adaptivity step %d", as);     
-        time_error_view.set_title(title);
-        time_error_view.show_mesh(false);
-        AbsFilter abs_tef(time_error_fn);
-        time_error_view.show(&abs_tef, HERMES_EPS_HIGH);
+        if (HERMES_VISUALIZATION)
+        {
+          // Show temporal error.
+          char title[100];
+          sprintf(title, "Temporal error est, spatial adaptivity step %d", as);     
+          time_error_view->set_title(title);
+          time_error_view->show_mesh(false);
+          AbsFilter abs_tef(time_error_fn);
+          time_error_view->show(&abs_tef, HERMES_EPS_HIGH);
+        }
 
         rel_err_time = Global<double>::calc_norm(time_error_fn, HERMES_H1_NORM) / 
-                       Global<double>::calc_norm(&ref_sln, HERMES_H1_NORM) * 100;
+                       Global<double>::calc_norm(ref_sln, HERMES_H1_NORM) * 100;
         if (ADAPTIVE_TIME_STEP_ON == false) Hermes::Mixins::Loggable::Static::info("rel_err_time: %g%%", rel_err_time);
       }
 
@@ -301,20 +332,23 @@ int main(int argc, char* argv[])
       // Project the fine mesh solution onto the coarse mesh.
       Solution<double> sln;
       Hermes::Mixins::Loggable::Static::info("Projecting fine mesh solution on coarse mesh for error estimation.");
-      OGProjection<double> ogProjection; ogProjection.project_global(&space, &ref_sln, &sln); 
+      OGProjection<double> ogProjection; ogProjection.project_global(&space, ref_sln, &sln); 
 
       // Show spatial error.
       sprintf(title, "Spatial error est, spatial adaptivity step %d", as);  
-      DiffFilter<double>* space_error_fn = new DiffFilter<double>(Hermes::vector<MeshFunction<double>*>(&ref_sln, &sln));   
-      space_error_view.set_title(title);
-      space_error_view.show_mesh(false);
-      AbsFilter abs_sef(space_error_fn);
-      space_error_view.show(&abs_sef, HERMES_EPS_HIGH);
+      DiffFilter<double>* space_error_fn = new DiffFilter<double>(Hermes::vector<MeshFunction<double>*>(ref_sln, &sln));   
+      if (HERMES_VISUALIZATION)
+      {
+        space_error_view->set_title(title);
+        space_error_view->show_mesh(false);
+        AbsFilter abs_sef(space_error_fn);
+        space_error_view->show(&abs_sef, HERMES_EPS_HIGH);
+      }
 
       // Calculate element errors and spatial error estimate.
       Hermes::Mixins::Loggable::Static::info("Calculating spatial error estimate.");
       Adapt<double>* adaptivity = new Adapt<double>(&space);
-      double err_rel_space = adaptivity->calc_err_est(&sln, &ref_sln) * 100;
+      double err_rel_space = adaptivity->calc_err_est(&sln, ref_sln) * 100;
 
       // Report results.
       Hermes::Mixins::Loggable::Static::info("ndof: %d, ref_ndof: %d, err_rel_space: %g%%", 
@@ -341,6 +375,8 @@ int main(int argc, char* argv[])
         delete ref_space->get_mesh();
         delete ref_space;
       }
+      else
+        ref_space_new = ref_space;
       delete space_error_fn;
     }
     while (done == false);
@@ -348,18 +384,31 @@ int main(int argc, char* argv[])
     // Clean up.
     if (time_error_fn != NULL) delete time_error_fn;
 
-    // Visualize the solution and mesh.
-    char title[100];
-    sprintf(title, "Solution<double>, time %g s", current_time);
-    sln_view.set_title(title);
-    sln_view.show_mesh(false);
-    sln_view.show(&ref_sln);
-    sprintf(title, "Mesh, time %g s", current_time);
-    ordview.set_title(title);
-    ordview.show(&space);
+    if (HERMES_VISUALIZATION)
+    {
+      // Visualize the solution and mesh.
+      char title[100];
+      sprintf(title, "Solution<double>, time %g s", current_time);
+      sln_view->set_title(title);
+      sln_view->show_mesh(false);
+      sln_view->show(ref_sln);
+      sprintf(title, "Mesh, time %g s", current_time);
+      ordview->set_title(title);
+      ordview->show(&space);
+    }
 
-    // Copy last reference solution into sln_time_prev.
-    sln_time_prev.copy(&ref_sln);
+    // The last reference solution (its reference mesh is kept) becomes the
+    // previous time level (no copy).
+    time_levels.rotate();
+
+    // The dropped level is overwritten in the next step, the reference space
+    // and mesh of its solution are no longer needed.
+    if (ref_space_prev != NULL)
+    {
+      delete ref_space_prev->get_mesh();
+      delete ref_space_prev;
+    }
+    ref_space_prev = ref_space_new;
 
     // Increase current time and counter of time steps.
     current_time += time_step;
@@ -368,6 +417,17 @@ int main(int argc, char* argv[])
   while (current_time < T_FINAL);
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete lambda;
+  if (ref_space_prev != NULL)
+  {
+    delete ref_space_prev->get_mesh();
+    delete ref_space_prev;
+  }
+  delete sln_view;
+  delete ordview;
+  delete time_error_view;
+  delete space_error_view;
   return 0;
 }
@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 //  This example solves a linear advection equation using Dicontinuous Galerkin (DG) method and standard continuous Finite Element Method. Shows the comparison.
 //
@@ -12,13 +13,15 @@
 //  The following parameters can be changed:
 
 // Number of initial uniform mesh refinements.
-const int INIT_REF = 3;
+int INIT_REF = 3;
 // Number of initial mesh refinements according to a specific criterion.
-const int INIT_REF_CRITERION = 4;
+int INIT_REF_CRITERION = 4;
 // Distance from the arc x^2 + y^2 = 0.25 where to refine.
 const double INIT_REF_DIST = 0.07;
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degrees of mesh elements in vertical and horizontal directions.
-const int P_INIT = 1;
+int P_INIT = 1;
 // Use shock capturing for DG.
 const bool DG_SHOCK_CAPTURING = true;
 // What parts to use.
@@ -45,6 +48,14 @@ int criterion(Element * e)
 
 int main(int argc, char* args[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, args);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF", INIT_REF);
+  parameters.get("INIT_REF_CRITERION", INIT_REF_CRITERION);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -56,8 +67,13 @@ int main(int argc, char* args[])
 
   mesh.refine_by_criterion(criterion, INIT_REF_CRITERION);
 
-  ScalarView view1("Solution - Discontinuous Galerkin FEM", new WinGeom(900, 0, 450, 350));
-  ScalarView view2("Solution - Standard continuous FEM", new WinGeom(900, 400, 450, 350));
+  ScalarView* view1 = NULL;
+  ScalarView* view2 = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    view1 = new ScalarView("Solution - Discontinuous Galerkin FEM", new WinGeom(900, 0, 450, 350));
+    view2 = new ScalarView("Solution - Standard continuous FEM", new WinGeom(900, 400, 450, 350));
+  }
 
   if(WANT_DG)
   {
@@ -93,13 +109,15 @@ int main(int argc, char* args[])
 
         flux_limiter.get_limited_solution(&sln_l2);
 
-        view1.set_title("Solution - limited Discontinuous Galerkin FEM");
+        if (HERMES_VISUALIZATION)
+          view1->set_title("Solution - limited Discontinuous Galerkin FEM");
       }
       else
         Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space_l2, &sln_l2);
 
       // View the solution.
-      view1.show(&sln_l2);
+      if (HERMES_VISUALIZATION)
+        view1->show(&sln_l2);
     }
     catch(std::exception& e)
     {
@@ -134,7 +152,8 @@ int main(int argc, char* args[])
       Solution<double>::vector_to_solution(linear_solver.get_sln_vector(), &space_h1, &sln_h1);
 
       // View the solution.
-      view2.show(&sln_h1);
+      if (HERMES_VISUALIZATION)
+        view2->show(&sln_h1);
     }
     catch(std::exception& e)
     {
@@ -143,6 +162,9 @@ int main(int argc, char* args[])
   }
 
   // Wait for keyboard or mouse input.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete view1;
+  delete view2;
   return 0;
 }
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 //  The purpose of this example is to use a simple linear problem with known 
 //  exact solution to show how to use NOX, and to compare its performance to 
@@ -16,10 +17,12 @@
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 6;                       
+int INIT_REF_NUM = 6;                       
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 3;                             
+int P_INIT = 3;                             
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_AZTECOO;  
@@ -59,6 +62,13 @@ int max_iters = 100;
 
 int main(int argc, char **argv)
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -121,8 +131,12 @@ int main(int argc, char **argv)
   Hermes::Mixins::Loggable::Static::info("Exact H1 error: %g%%.", rel_err_1);
     
   // View the solution and mesh.
-  ScalarView sview("Solution", new WinGeom(0, 0, 440, 350));
-  sview.show(&sln1);
+  ScalarView* sview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new ScalarView("Solution", new WinGeom(0, 0, 440, 350));
+    sview->show(&sln1);
+  }
   //OrderView  oview("Polynomial orders", new WinGeom(450, 0, 400, 350));
   //oview.show(&space);
   
@@ -191,9 +205,13 @@ int main(int argc, char **argv)
   time = cpu_time.tick().last();
 
   // Show the NOX solution.
-  ScalarView view2("Solution<double> 2", new WinGeom(450, 0, 460, 350));
-  view2.show(&sln2);
-  //view2.show(&exact);
+  ScalarView* view2 = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    view2 = new ScalarView("Solution<double> 2", new WinGeom(450, 0, 460, 350));
+    view2->show(&sln2);
+  }
+  //view2->show(&exact);
 
   // Calculate errors.
   double rel_err_2 = Global<double>::calc_rel_error(&sln2, &exact, HERMES_H1_NORM) * 100;
@@ -201,7 +219,10 @@ int main(int argc, char **argv)
   Hermes::Mixins::Loggable::Static::info("Exact H1 error: %g%%.", rel_err_2);
  
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
   
+  delete sview;
+  delete view2;
   return 0;
 }
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -24,10 +25,12 @@ using namespace Hermes::Hermes2D::Views;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 5;                       
+int INIT_REF_NUM = 5;                       
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 3;                             
+int P_INIT = 3;                             
 // Stopping criterion for the Newton's method.
 const double NEWTON_TOL = 1e-6;                   
 // Maximum allowed number of Newton iterations.
@@ -71,6 +74,13 @@ int max_iters = 100;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -128,8 +138,12 @@ int main(int argc, char* argv[])
   cpu_time.tick();
  
   // Show UMFPACK solution.
-  ScalarView view1("Solution 1", new WinGeom(0, 0, 500, 400));
-  view1.show(&sln1);
+  ScalarView* view1 = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    view1 = new ScalarView("Solution 1", new WinGeom(0, 0, 500, 400));
+    view1->show(&sln1);
+  }
 
   // Calculate error.
   CustomExactSolution ex(&mesh);
@@ -202,10 +216,17 @@ int main(int argc, char* argv[])
   Hermes::Mixins::Loggable::Static::info("Solution 2 (NOX): exact H1 error: %g%% (time %g + %g = %g [s])", rel_err_2, proj_time, time2, proj_time+time2);
 
   // Show NOX solution.
-  ScalarView view2("Solution 2", new WinGeom(510, 0, 500, 400));
-  view2.show(&sln2);
+  ScalarView* view2 = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    view2 = new ScalarView("Solution 2", new WinGeom(510, 0, 500, 400));
+    view2->show(&sln2);
+  }
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete view1;
+  delete view2;
   return 0;
 }
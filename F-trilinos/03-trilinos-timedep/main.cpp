@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -19,10 +20,12 @@ using namespace Hermes::Hermes2D::RefinementSelectors;
 //  BC: Dirichlet at the bottom, Newton du/dn = ALPHA*(TEMP_EXT - u) elsewhere.
 //
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 4;       
+int INIT_REF_NUM = 4;       
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 1;             
+int P_INIT = 1;             
 // Coefficient for the Nwwton boundary condition.
 const double ALPHA = 10.0;        
 const double LAMBDA = 1e5;
@@ -68,6 +71,13 @@ int max_iters = 100;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -124,8 +134,12 @@ int main(int argc, char* argv[])
   }
 
   // Initialize the view.
-  ScalarView Tview("Temperature", new WinGeom(0, 0, 450, 400));
-  Tview.set_min_max_range(10,20);
+  ScalarView* Tview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    Tview = new ScalarView("Temperature", new WinGeom(0, 0, 450, 400));
+    Tview->set_min_max_range(10,20);
+  }
 
   // Time stepping loop:
   double total_time = 0.0;
@@ -147,7 +161,8 @@ int main(int argc, char* argv[])
     Solution<double>::vector_to_solution(solver_nox.get_sln_vector(), &space, &t_prev_time);
 
     // Show the new solution.
-    Tview.show(&t_prev_time);
+    if (HERMES_VISUALIZATION)
+      Tview->show(&t_prev_time);
 
     Hermes::Mixins::Loggable::Static::info("Number of nonlin iterations: %d (norm of residual: %g)", 
       solver_nox.get_num_iters(), solver_nox.get_residual());
@@ -156,6 +171,8 @@ int main(int argc, char* argv[])
   }
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete Tview;
   return 0;
 }
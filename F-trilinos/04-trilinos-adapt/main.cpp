@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -21,10 +22,12 @@ using namespace Hermes::Hermes2D::RefinementSelectors;
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 2;                      
+int P_INIT = 2;                      
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 1;                
+int INIT_REF_NUM = 1;                
 // This is a quantitative parameter of the adapt(...) function and
 // it has different meanings for various adaptive strategies (see below).
 const double THRESHOLD = 0.3;              
@@ -103,6 +106,13 @@ int max_iters = 100;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -131,11 +141,17 @@ int main(int argc, char* argv[])
   H1ProjBasedSelector<double> selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
 
   // Initialize views.
-  ScalarView sview("Solution", new WinGeom(0, 0, 440, 350));
-  sview.show_mesh(false);
-  sview.fix_scale_width(50);
-  OrderView  oview("Polynomial orders", new WinGeom(450, 0, 420, 350));
-  OrderView  oviewa("Polynomial orders", new WinGeom(450, 0, 420, 350));
+  ScalarView* sview = NULL;
+  OrderView* oview = NULL;
+  OrderView* oviewa = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    sview = new ScalarView("Solution", new WinGeom(0, 0, 440, 350));
+    sview->show_mesh(false);
+    sview->fix_scale_width(50);
+    oview = new OrderView("Polynomial orders", new WinGeom(450, 0, 420, 350));
+    oviewa = new OrderView("Polynomial orders", new WinGeom(450, 0, 420, 350));
+  }
 
   // DOF and CPU convergence graphs.
   SimpleGraph graph_dof, graph_cpu, graph_dof_exact, graph_cpu_exact;
@@ -210,10 +226,13 @@ int main(int argc, char* argv[])
     Hermes::Mixins::Loggable::Static::info("Projecting reference solution on coarse mesh.");
     OGProjection<double> ogProjection; ogProjection.project_global(&space, &ref_sln, &sln);
 
-    // View the coarse mesh solution and polynomial orders.
-    sview.show(&sln);
-    oview.show(&space);
-    oviewa.show(ref_space);
+    if (HERMES_VISUALIZATION)
+    {
+      // View the coarse mesh solution and polynomial orders.
+      sview->show(&sln);
+      oview->show(&space);
+      oviewa->show(ref_space);
+    }
 
     // Calculate element errors and total error estimate.
     Hermes::Mixins::Loggable::Static::info("Calculating error estimate and exact error.");
@@ -266,6 +285,10 @@ int main(int argc, char* argv[])
   Hermes::Mixins::Loggable::Static::info("Total running time: %g s", cpu_time.accumulated());
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete sview;
+  delete oview;
+  delete oviewa;
   return 0;
 }
@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 //  The purpose of this example is to show how to use Trilinos for nonlinear time-dependent coupled PDE systems.
 //  Solved by NOX solver via Newton or JFNK, with or without preconditioning.
@@ -11,10 +12,12 @@
 //
 //  The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 2;         
+int INIT_REF_NUM = 2;         
 // Initial polynomial degree of all mesh elements.
-const int P_INIT = 1;               
+int P_INIT = 1;               
 // Time step.
 const double TAU = 0.5;            
 // Time interval length.
@@ -64,6 +67,13 @@ int max_iters = 100;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Time measurement.
   Hermes::Mixins::TimeMeasurable cpu_time;
   cpu_time.tick();
@@ -103,7 +113,12 @@ int main(int argc, char* argv[])
   CustomFilterDc omega_dc(Hermes::vector<Solution<double>*>(&t_prev_time_1, &c_prev_time_1), Le, alpha, beta, kappa, x1, TAU);
 
   // Initialize visualization.
-  ScalarView rview("Reaction rate", new WinGeom(0, 0, 800, 230));
+  ScalarView* rview = NULL;
+  if (HERMES_VISUALIZATION)
+  {
+    rview = new ScalarView("Reaction rate", new WinGeom(0, 0, 800, 230));
+    rview->set_min_max_range(0.0,2.0);
+  }
 
   // Initialize weak formulation.
   CustomWeakForm wf(Le, alpha, beta, kappa, x1, TAU, TRILINOS_JFNK, PRECOND, &omega, &omega_dt, 
@@ -185,15 +200,17 @@ int main(int argc, char* argv[])
     c_prev_time_1.copy(&c_prev_newton);
       
     // Visualization.
-    rview.set_min_max_range(0.0,2.0);
-    rview.show(&omega);
+    if (HERMES_VISUALIZATION)
+      rview->show(&omega);
     cpu_time.tick();
 
     Hermes::Mixins::Loggable::Static::info("Total running time for time level %d: %g s.", ts, cpu_time.tick().last());
   }
 
   // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+    View::wait();
+  delete rview;
   return 0;
 }
 
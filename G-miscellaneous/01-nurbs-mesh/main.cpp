@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "hermes2d.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -11,11 +12,19 @@ using namespace Hermes::Hermes2D;
 //         (see the end of the mesh file for details).
 //
 
-const int INIT_REF_NUM = 2;
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
+int INIT_REF_NUM = 2;
 const char* mesh_file = "domain-4.mesh";
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -25,11 +34,14 @@ int main(int argc, char* argv[])
   for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
 
   // Show the mesh.
-  Views::MeshView mview("Nurbs", new Views::WinGeom(0, 0, 350, 350));
-  mview.show(&mesh);
-	
-  // Wait for the view to be closed.
-  Views::View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    Views::MeshView mview("Nurbs", new Views::WinGeom(0, 0, 350, 350));
+    mview.show(&mesh);
+
+    // Wait for the view to be closed.
+    Views::View::wait();
+  }
   return 0;
 }
 
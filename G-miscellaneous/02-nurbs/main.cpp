@@ -1,5 +1,6 @@
 #define HERMES_REPORT_ALL
 #include "hermes2d.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -22,10 +23,12 @@ const char* mesh_file = "domain-2.mesh";
 //const char* mesh_file = "domain-3.mesh";          
 
 // The following parameters can be also changed:
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Uniform polynomial degree of mesh elements.
-const int P_INIT = 3;                             
+int P_INIT = 3;                             
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 2;                       
+int INIT_REF_NUM = 2;                       
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
@@ -35,6 +38,13 @@ const double const_f = 1.0;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("P_INIT", P_INIT);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -75,11 +85,14 @@ int main(int argc, char* argv[])
   Hermes::Hermes2D::Solution<double>::vector_to_solution(newton.get_sln_vector(), &space, &sln);
   
   // Visualize the solution.
-  Views::ScalarView view("Solution", new Views::WinGeom(0, 0, 800, 350));
-  view.show(&sln);
+  if (HERMES_VISUALIZATION)
+  {
+    Views::ScalarView view("Solution", new Views::WinGeom(0, 0, 800, 350));
+    view.show(&sln);
 
-  // Wait for the view to be closed.
-  Views::View::wait();
+    // Wait for the view to be closed.
+    Views::View::wait();
+  }
 
   return 0;
 }
@@ -1,4 +1,5 @@
 #include "hermes2d.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes;
 using namespace Hermes::Hermes2D;
@@ -15,6 +16,8 @@ using namespace Hermes::Hermes2D::Views;
 //
 // The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Initial uniform mesh refinement.
 int INIT_REF_NUM = 2;      
 // Polynomial degree of mesh elements.
@@ -22,6 +25,13 @@ int P_INIT = 3;
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -34,11 +44,14 @@ int main(int argc, char* argv[])
   HcurlSpace<double> space(&mesh, P_INIT);
 
   // Visualize FE basis.
-  VectorBaseView<double> bview("VectorBaseView", new WinGeom(0, 0, 700, 600));
-  bview.show(&space);
-
-  // Wait for all views to be closed.
-  View::wait();
+  if (HERMES_VISUALIZATION)
+  {
+    VectorBaseView<double> bview("VectorBaseView", new WinGeom(0, 0, 700, 600));
+    bview.show(&space);
+
+    // Wait for all views to be closed.
+    View::wait();
+  }
   return 0;
 }
 
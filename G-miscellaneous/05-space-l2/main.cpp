@@ -1,6 +1,7 @@
 #define HERMES_REPORT_ALL
 #define HERMES_REPORT_FILE "application.log"
 #include "definitions.h"
+#include "tutorial_parameters.h"
 
 using namespace Hermes::Hermes2D::Views;
 
@@ -12,16 +13,25 @@ using namespace Hermes::Hermes2D::Views;
 //
 // The following parameters can be changed:
 
+// Set to "false" to suppress Hermes OpenGL visualization.
+bool HERMES_VISUALIZATION = true;
 // Number of initial uniform mesh refinements.
-const int INIT_REF_NUM = 4;                       
+int INIT_REF_NUM = 4;                       
 // Polynomial degree of mesh elements.
-const int P_INIT = 1;                            
+int P_INIT = 1;                            
 // Matrix solver: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
 // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  
 
 int main(int argc, char* argv[])
 {
+  // Read the runtime parameters (command line or configuration file).
+  TutorialParameters parameters(argc, argv);
+  parameters.get("HERMES_VISUALIZATION", HERMES_VISUALIZATION);
+  parameters.get("INIT_REF_NUM", INIT_REF_NUM);
+  parameters.get("P_INIT", P_INIT);
+  parameters.check_unused();
+
   // Load the mesh.
   Mesh mesh;
   MeshReaderH2D mloader;
@@ -33,11 +43,6 @@ int main(int argc, char* argv[])
   // Create an L2 space with default shapeset.
   L2Space<double> space(&mesh, P_INIT);
 
-  // View basis functions.
-  BaseView<double> bview("BaseView", new WinGeom(0, 0, 600, 500));
-  bview.show(&space);
-  // View::wait(H2DV_WAIT_KEYPRESS);
-
   // Initialize the exact and projected solution.
   Solution<double> sln;
   CustomExactSolution sln_exact(&mesh);
@@ -46,12 +51,18 @@ int main(int argc, char* argv[])
   OGProjection<double> ogProjection;
   ogProjection.project_global(&space, &sln_exact, &sln);
 
-  // Visualize the projection.
-  ScalarView view1("Projection", new WinGeom(610, 0, 600, 500));
-  view1.show(&sln);
+  // View basis functions and the projection (the views are only created
+  // with the visualization, they need a display).
+  if (HERMES_VISUALIZATION)
+  {
+    BaseView<double> bview("BaseView", new WinGeom(0, 0, 600, 500));
+    bview.show(&space);
+    ScalarView view1("Projection", new WinGeom(610, 0, 600, 500));
+    view1.show(&sln);
 
-  // Wait for all views to be closed.
-  View::wait();
+    // Wait for all views to be closed.
+    View::wait();
+  }
   return 0;
 }
 
@@ -16,6 +16,7 @@ macro(SET_COMMON_TARGET_PROPERTIES TRGT HERMES_VERSION)
     SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /openmp")
   endif(MSVC)
 
+	target_link_libraries(${TRGT} hermes_tutorial_common)
 	target_link_libraries(${TRGT} ${HERMES_COMMON_LIBRARY})
 	target_link_libraries(${TRGT} ${HERMES_LIBRARY})
 	# Is empty if WITH_TRILINOS = NO
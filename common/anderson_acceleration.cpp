@@ -0,0 +1,326 @@
+#include "anderson_acceleration.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Anderson acceleration */
+
+AndersonAccelerator::AndersonAccelerator(int ndof, int depth, double beta)
+  : ndof(ndof), depth(depth < 0 ? 0 : depth), beta(beta), max_condition(1e10), max_history(100)
+{
+  if (!(beta > 0 && beta <= 1))
+    throw Hermes::Exceptions::Exception("The mixing factor of the Anderson acceleration must be in (0, 1], %g given.", beta);
+
+  q.resize(this->depth * ndof);
+  dg.resize(this->depth * ndof);
+  r_matrix.resize(this->depth * this->depth);
+  f.resize(ndof);
+  f_previous.resize(ndof);
+  g_previous.resize(ndof);
+  h.resize(this->depth);
+  gamma.resize(this->depth);
+  reset();
+}
+
+void AndersonAccelerator::reset()
+{
+  dg_first = 0;
+  num_columns = 0;
+  has_previous = false;
+}
+
+void AndersonAccelerator::set_max_condition(double max_condition)
+{
+  this->max_condition = max_condition;
+}
+
+void AndersonAccelerator::set_max_history(int max_history)
+{
+  this->max_history = max_history < 0 ? 0 : max_history;
+}
+
+int AndersonAccelerator::get_num_columns() const
+{
+  return num_columns;
+}
+
+const std::vector<double>& AndersonAccelerator::get_coefficient_history() const
+{
+  return coefficient_history;
+}
+
+const std::vector<int>& AndersonAccelerator::get_coefficient_counts() const
+{
+  return coefficient_counts;
+}
+
+double* AndersonAccelerator::get_q(int k)
+{
+  return &q[k * ndof];
+}
+
+double* AndersonAccelerator::get_dg(int k)
+{
+  return &dg[((dg_first + k) % depth) * ndof];
+}
+
+double& AndersonAccelerator::r(int i, int j)
+{
+  return r_matrix[i * depth + j];
+}
+
+void AndersonAccelerator::step(const double* x, const double* g, double* x_new)
+{
+  for (int i = 0; i < ndof; i++)
+    f[i] = g[i] - x[i];
+
+  // New differences.
+  if (has_previous && depth > 0)
+  {
+    if (num_columns == depth)
+      remove_oldest_column();
+
+    double* q_new = get_q(num_columns);
+    double* dg_new = get_dg(num_columns);
+    for (int i = 0; i < ndof; i++)
+    {
+      q_new[i] = f[i] - f_previous[i];
+      dg_new[i] = g[i] - g_previous[i];
+    }
+    if (append_column())
+    {
+      num_columns++;
+      while (num_columns > 1 && get_condition() > max_condition)
+        remove_oldest_column();
+    }
+  }
+
+  // Stored before 'x_new' is written, it may be 'g'.
+  std::copy(f.begin(), f.end(), f_previous.begin());
+  std::copy(g, g + ndof, g_previous.begin());
+  has_previous = true;
+
+  // Coefficient history of the last max_history steps.
+  coefficient_counts.push_back(num_columns);
+  if ((int) coefficient_counts.size() > max_history)
+  {
+    coefficient_history.erase(coefficient_history.begin(), coefficient_history.begin() + coefficient_counts.front());
+    coefficient_counts.erase(coefficient_counts.begin());
+  }
+
+  // No differences: plain fixed-point step.
+  if (num_columns == 0)
+  {
+    std::copy(g_previous.begin(), g_previous.end(), x_new);
+    return;
+  }
+
+  // gamma = R^{-1} Q^T f.
+  for (int k = 0; k < num_columns; k++)
+  {
+    const double* q_k = get_q(k);
+    double dot = 0;
+    for (int i = 0; i < ndof; i++)
+      dot += q_k[i] * f[i];
+    h[k] = dot;
+  }
+  for (int k = num_columns - 1; k >= 0; k--)
+  {
+    double sum = h[k];
+    for (int j = k + 1; j < num_columns; j++)
+      sum -= r(k, j) * gamma[j];
+    gamma[k] = sum / r(k, k);
+  }
+  if (max_history > 0)
+    coefficient_history.insert(coefficient_history.end(), gamma.begin(), gamma.begin() + num_columns);
+
+  // x_new = g - dG gamma - (1 - beta) (f - Q h), since dF gamma = Q h.
+  for (int k = 0; k < num_columns; k++)
+  {
+    const double* q_k = get_q(k);
+    for (int i = 0; i < ndof; i++)
+      f[i] -= h[k] * q_k[i];
+  }
+  for (int i = 0; i < ndof; i++)
+    x_new[i] = g_previous[i] - (1 - beta) * f[i];
+  for (int k = 0; k < num_columns; k++)
+  {
+    const double* dg_k = get_dg(k);
+    for (int i = 0; i < ndof; i++)
+      x_new[i] -= gamma[k] * dg_k[i];
+  }
+}
+
+bool AndersonAccelerator::append_column()
+{
+  int m = num_columns;
+  double* v = get_q(m);
+
+  double norm = 0;
+  for (int i = 0; i < ndof; i++)
+    norm += v[i] * v[i];
+  norm = std::sqrt(norm);
+  if (norm == 0)
+    return false;
+
+  // Modified Gram-Schmidt, twice.
+  for (int k = 0; k < m; k++)
+    r(k, m) = 0;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (int k = 0; k < m; k++)
+    {
+      const double* q_k = get_q(k);
+      double dot = 0;
+      for (int i = 0; i < ndof; i++)
+        dot += q_k[i] * v[i];
+      for (int i = 0; i < ndof; i++)
+        v[i] -= dot * q_k[i];
+      r(k, m) += dot;
+    }
+  }
+
+  double r_mm = 0;
+  for (int i = 0; i < ndof; i++)
+    r_mm += v[i] * v[i];
+  r_mm = std::sqrt(r_mm);
+  if (r_mm <= 1e-14 * norm)
+    return false;
+
+  r(m, m) = r_mm;
+  for (int i = 0; i < ndof; i++)
+    v[i] /= r_mm;
+  return true;
+}
+
+void AndersonAccelerator::remove_oldest_column()
+{
+  int m = num_columns;
+
+  // Without the first column, R is upper Hessenberg.
+  for (int j = 0; j < m - 1; j++)
+    for (int i = 0; i <= j + 1; i++)
+      r(i, j) = r(i, j + 1);
+
+  // Givens rotations of the rows j, j + 1 of R and the columns j, j + 1 of Q
+  // restore the triangular form, the last column of Q is no longer needed.
+  for (int j = 0; j < m - 1; j++)
+  {
+    double a = r(j, j), b = r(j + 1, j);
+    double rho = std::sqrt(a * a + b * b);
+    if (rho == 0)
+      continue;
+    double c = a / rho, s = b / rho;
+
+    for (int k = j; k < m - 1; k++)
+    {
+      double t1 = c * r(j, k) + s * r(j + 1, k);
+      double t2 = -s * r(j, k) + c * r(j + 1, k);
+      r(j, k) = t1;
+      r(j + 1, k) = t2;
+    }
+
+    double* q_j = get_q(j);
+    double* q_j1 = get_q(j + 1);
+    for (int i = 0; i < ndof; i++)
+    {
+      double t1 = c * q_j[i] + s * q_j1[i];
+      double t2 = -s * q_j[i] + c * q_j1[i];
+      q_j[i] = t1;
+      q_j1[i] = t2;
+    }
+  }
+
+  dg_first = (dg_first + 1) % depth;
+  num_columns--;
+}
+
+double AndersonAccelerator::get_condition()
+{
+  double r_min = std::fabs(r(0, 0)), r_max = r_min;
+  for (int k = 1; k < num_columns; k++)
+  {
+    r_min = std::min(r_min, std::fabs(r(k, k)));
+    r_max = std::max(r_max, std::fabs(r(k, k)));
+  }
+  return r_max / r_min;
+}
+
+/* Picard's method with Anderson acceleration */
+
+AndersonPicardSolver::AndersonPicardSolver(DiscreteProblem<double>* dp, int depth, double beta)
+  : dp(dp), depth(depth), beta(beta), tol(1e-8), max_iter(100), num_iters(0), accelerator(NULL)
+{
+}
+
+AndersonPicardSolver::~AndersonPicardSolver()
+{
+  delete accelerator;
+}
+
+void AndersonPicardSolver::set_tol(double tol)
+{
+  this->tol = tol;
+}
+
+void AndersonPicardSolver::set_max_iter(int max_iter)
+{
+  this->max_iter = max_iter;
+}
+
+int AndersonPicardSolver::get_num_iters() const
+{
+  return num_iters;
+}
+
+const AndersonAccelerator* AndersonPicardSolver::get_accelerator() const
+{
+  return accelerator;
+}
+
+bool AndersonPicardSolver::solve(double* coeff_vec)
+{
+  int ndof = dp->get_num_dofs();
+  delete accelerator;
+  accelerator = new AndersonAccelerator(ndof, depth, beta);
+
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  Hermes::Solvers::LinearMatrixSolver<double>* solver = Hermes::Solvers::create_linear_solver<double>(matrix, rhs);
+  std::vector<double> g(ndof);
+
+  bool converged = false;
+  for (num_iters = 1; num_iters <= max_iter; num_iters++)
+  {
+    // Image of the previous iterate.
+    dp->assemble(coeff_vec, matrix, rhs);
+    if (num_iters > 1)
+      solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_MATRIX_REORDERING);
+    if (!solver->solve())
+      throw Hermes::Exceptions::Exception("Matrix solver failed in the Picard's iteration %d.", num_iters);
+    std::copy(solver->get_sln_vector(), solver->get_sln_vector() + ndof, g.begin());
+
+    double change = 0, norm = 0;
+    for (int i = 0; i < ndof; i++)
+    {
+      change += (g[i] - coeff_vec[i]) * (g[i] - coeff_vec[i]);
+      norm += g[i] * g[i];
+    }
+    double rel_change = (norm > 0) ? std::sqrt(change / norm) : std::sqrt(change);
+    this->info("Picard's iteration %d, relative change %g, %d previous iterates used.",
+               num_iters, rel_change, accelerator->get_num_columns());
+
+    if (rel_change < tol)
+    {
+      std::copy(g.begin(), g.end(), coeff_vec);
+      converged = true;
+      break;
+    }
+    accelerator->step(coeff_vec, &g[0], coeff_vec);
+  }
+
+  delete solver;
+  delete matrix;
+  delete rhs;
+  return converged;
+}
@@ -0,0 +1,139 @@
+#ifndef __HERMES_TUTORIAL_ANDERSON_ACCELERATION_H
+#define __HERMES_TUTORIAL_ANDERSON_ACCELERATION_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Anderson acceleration */
+
+// Anderson acceleration of a fixed-point iteration x -> G(x). With the
+// residuals f_k = G(x_k) - x_k and the differences dF, dG of the last 'depth'
+// residuals and images, the next iterate is
+//
+//   x_{k+1} = G(x_k) - dG gamma - (1 - beta) (f_k - dF gamma),
+//
+// where gamma minimizes |f_k - dF gamma| and 0 < beta <= 1 is the mixing
+// factor (beta = 1: no mixing). Without differences (the first iteration,
+// depth 0, or all differences dropped) the step is the plain fixed-point
+// step x_{k+1} = G(x_k). Instead of storing the iterates and
+// solving the least-squares problem anew, the QR factorization dF = Q R is
+// updated: a new difference is orthogonalized against Q (Gram-Schmidt with
+// reorthogonalization), the oldest one is removed by Givens rotations. Both
+// cost O(depth * ndof), as does the computation of the next iterate. The
+// differences of the images are kept in a circular buffer, the columns of Q
+// stay in place (the rotations free the last one), so no memory is allocated
+// after the construction except for the coefficient history, which keeps
+// the last 100 steps by default (set_max_history()).
+//
+// Old differences are also removed while the condition number of R (estimated
+// from its diagonal) exceeds the given maximum.
+
+class AndersonAccelerator
+{
+public:
+  /// 'depth' is the number of differences used, 0 means the plain
+  /// fixed-point iteration. 0 < beta <= 1 is the mixing factor, an exception
+  /// is thrown for other values.
+  AndersonAccelerator(int ndof, int depth, double beta = 1.0);
+
+  /// Computes the next iterate from the iterate 'x' and its image 'g'.
+  /// 'x_new' may be the same array as 'x' or 'g'.
+  void step(const double* x, const double* g, double* x_new);
+
+  /// Forgets all differences (e.g. after the problem has changed).
+  void reset();
+
+  void set_max_condition(double max_condition);
+
+  /// Number of last steps kept in the coefficient history.
+  void set_max_history(int max_history);
+
+  /// Number of differences currently used.
+  int get_num_columns() const;
+
+  /// Coefficients gamma of the last steps, one after another, oldest
+  /// difference first; get_coefficient_counts()[k] is the number of
+  /// coefficients of the k-th step kept.
+  const std::vector<double>& get_coefficient_history() const;
+  const std::vector<int>& get_coefficient_counts() const;
+
+protected:
+  /// Adds the difference stored in the column 'num_columns' of Q to the
+  /// factorization, returns false if it is (numerically) linearly dependent
+  /// on the others.
+  bool append_column();
+
+  /// Removes the oldest difference.
+  void remove_oldest_column();
+
+  /// Condition number of R estimated from its diagonal.
+  double get_condition();
+
+  double* get_q(int k);
+  double* get_dg(int k);
+  double& r(int i, int j);
+
+  int ndof;
+  int depth;
+  double beta;
+  double max_condition;
+  int max_history;
+
+  // Q (ndof x depth) and the differences of the images, by columns.
+  std::vector<double> q;
+  std::vector<double> dg;
+  // Upper triangular R (depth x depth), by rows.
+  std::vector<double> r_matrix;
+  // Column of dg holding the oldest difference.
+  int dg_first;
+  int num_columns;
+
+  bool has_previous;
+  std::vector<double> f;
+  std::vector<double> f_previous;
+  std::vector<double> g_previous;
+  std::vector<double> h;
+  std::vector<double> gamma;
+
+  std::vector<double> coefficient_history;
+  std::vector<int> coefficient_counts;
+};
+
+/* Picard's method with Anderson acceleration */
+
+// Picard's iteration for a linearized problem: in every iteration the system
+// assembled at the previous iterate (passed as u_ext to the forms) is solved,
+// and the solution is passed to the AndersonAccelerator. The matrix solver is
+// kept and reuses the matrix reordering from the first iteration.
+
+class AndersonPicardSolver : public Hermes::Mixins::Loggable
+{
+public:
+  /// 'dp' assembles the linear system of the Picard's linearization.
+  AndersonPicardSolver(DiscreteProblem<double>* dp, int depth, double beta = 1.0);
+  ~AndersonPicardSolver();
+
+  /// Relative change of two consecutive iterations to stop at.
+  void set_tol(double tol);
+  void set_max_iter(int max_iter);
+
+  /// Iterates from 'coeff_vec', which receives the result. Returns false if
+  /// the iteration did not converge.
+  bool solve(double* coeff_vec);
+
+  int get_num_iters() const;
+  const AndersonAccelerator* get_accelerator() const;
+
+protected:
+  DiscreteProblem<double>* dp;
+  int depth;
+  double beta;
+  double tol;
+  int max_iter;
+  int num_iters;
+  AndersonAccelerator* accelerator;
+};
+
+#endif
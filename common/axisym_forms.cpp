@@ -0,0 +1,124 @@
+#include "axisym_forms.h"
+
+/* Radius of the integration points */
+
+const double* AxisymmetricWeights::get_radius(const Geom<double>* e, GeomType axisym)
+{
+  return (axisym == HERMES_AXISYM_X) ? e->y : e->x;
+}
+
+Ord AxisymmetricWeights::get_ord(const Geom<Ord>* e, GeomType axisym)
+{
+  return (axisym == HERMES_AXISYM_X) ? e->y[0] : e->x[0];
+}
+
+/* Weak forms */
+
+AxisymJacobianDiffusion::AxisymJacobianDiffusion(int i, int j, std::string area, double lambda, GeomType axisym)
+  : MatrixFormVol<double>(i, j), lambda(lambda), axisym(axisym)
+{
+  this->set_area(area);
+  this->setSymFlag(HERMES_SYM);
+}
+
+double AxisymJacobianDiffusion::value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                                      Func<double> *v, Geom<double> *e, Func<double> **ext) const
+{
+  const double* r = AxisymmetricWeights::get_radius(e, axisym);
+  double result = 0;
+  for (int i = 0; i < n; i++)
+    result += wt[i] * r[i] * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]);
+  return lambda * result;
+}
+
+Ord AxisymJacobianDiffusion::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                                 Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return (u->dx[0] * v->dx[0] + u->dy[0] * v->dy[0]) * AxisymmetricWeights::get_ord(e, axisym);
+}
+
+MatrixFormVol<double>* AxisymJacobianDiffusion::clone() const
+{
+  return new AxisymJacobianDiffusion(*this);
+}
+
+AxisymResidualDiffusion::AxisymResidualDiffusion(int i, std::string area, double lambda, GeomType axisym)
+  : VectorFormVol<double>(i), lambda(lambda), axisym(axisym)
+{
+  this->set_area(area);
+}
+
+double AxisymResidualDiffusion::value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                                      Geom<double> *e, Func<double> **ext) const
+{
+  const double* r = AxisymmetricWeights::get_radius(e, axisym);
+  double result = 0;
+  for (int i = 0; i < n; i++)
+    result += wt[i] * r[i] * (u_ext[this->i]->dx[i] * v->dx[i] + u_ext[this->i]->dy[i] * v->dy[i]);
+  return lambda * result;
+}
+
+Ord AxisymResidualDiffusion::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                                 Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return (u_ext[this->i]->dx[0] * v->dx[0] + u_ext[this->i]->dy[0] * v->dy[0]) * AxisymmetricWeights::get_ord(e, axisym);
+}
+
+VectorFormVol<double>* AxisymResidualDiffusion::clone() const
+{
+  return new AxisymResidualDiffusion(*this);
+}
+
+AxisymMatrixFormSurf::AxisymMatrixFormSurf(int i, int j, std::string area, double alpha, GeomType axisym)
+  : MatrixFormSurf<double>(i, j), alpha(alpha), axisym(axisym)
+{
+  this->set_area(area);
+}
+
+double AxisymMatrixFormSurf::value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                                   Func<double> *v, Geom<double> *e, Func<double> **ext) const
+{
+  const double* r = AxisymmetricWeights::get_radius(e, axisym);
+  double result = 0;
+  for (int i = 0; i < n; i++)
+    result += wt[i] * r[i] * u->val[i] * v->val[i];
+  return alpha * result;
+}
+
+Ord AxisymMatrixFormSurf::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                              Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return u->val[0] * v->val[0] * AxisymmetricWeights::get_ord(e, axisym);
+}
+
+MatrixFormSurf<double>* AxisymMatrixFormSurf::clone() const
+{
+  return new AxisymMatrixFormSurf(*this);
+}
+
+AxisymResidualSurf::AxisymResidualSurf(int i, std::string area, double alpha, double c, GeomType axisym)
+  : VectorFormSurf<double>(i), alpha(alpha), c(c), axisym(axisym)
+{
+  this->set_area(area);
+}
+
+double AxisymResidualSurf::value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                                 Geom<double> *e, Func<double> **ext) const
+{
+  const double* r = AxisymmetricWeights::get_radius(e, axisym);
+  double result = 0;
+  for (int i = 0; i < n; i++)
+    result += wt[i] * r[i] * (alpha * u_ext[this->i]->val[i] + c) * v->val[i];
+  return result;
+}
+
+Ord AxisymResidualSurf::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                            Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return u_ext[this->i]->val[0] * v->val[0] * AxisymmetricWeights::get_ord(e, axisym);
+}
+
+VectorFormSurf<double>* AxisymResidualSurf::clone() const
+{
+  return new AxisymResidualSurf(*this);
+}
@@ -0,0 +1,109 @@
+#ifndef __HERMES_TUTORIAL_AXISYM_FORMS_H
+#define __HERMES_TUTORIAL_AXISYM_FORMS_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Radius of the integration points */
+
+// In axisymmetric problems every integrand is multiplied by the radius. The
+// default forms with the parameter HERMES_AXISYM_X/Y select the radius by a
+// branch in every integration point. The forms below select the coordinate
+// array once per call and multiply the weights by the radius inline, in the
+// same loop as the integrand, so no weights are kept between calls.
+
+class AxisymmetricWeights
+{
+public:
+  /// The distances r[i] of the integration points from the axis of symmetry
+  /// (HERMES_AXISYM_X: the y coordinates, HERMES_AXISYM_Y: the x ones).
+  static const double* get_radius(const Geom<double>* e, GeomType axisym);
+
+  /// The radius in the integration order of a form.
+  static Ord get_ord(const Geom<Ord>* e, GeomType axisym);
+};
+
+/* Weak forms */
+
+// Axisymmetric counterparts of the default forms with constant coefficients.
+
+/// lambda * grad u . grad v * r
+class AxisymJacobianDiffusion : public MatrixFormVol<double>
+{
+public:
+  AxisymJacobianDiffusion(int i, int j, std::string area, double lambda, GeomType axisym);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                       Func<double> *v, Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  MatrixFormVol<double>* clone() const;
+
+protected:
+  double lambda;
+  GeomType axisym;
+};
+
+/// lambda * grad u_ext . grad v * r
+class AxisymResidualDiffusion : public VectorFormVol<double>
+{
+public:
+  AxisymResidualDiffusion(int i, std::string area, double lambda, GeomType axisym);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                       Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  VectorFormVol<double>* clone() const;
+
+protected:
+  double lambda;
+  GeomType axisym;
+};
+
+/// alpha * u * v * r on the boundary
+class AxisymMatrixFormSurf : public MatrixFormSurf<double>
+{
+public:
+  AxisymMatrixFormSurf(int i, int j, std::string area, double alpha, GeomType axisym);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                       Func<double> *v, Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  MatrixFormSurf<double>* clone() const;
+
+protected:
+  double alpha;
+  GeomType axisym;
+};
+
+/// (alpha * u_ext + c) * v * r on the boundary (the surface residual and the
+/// constant surface vector form in one).
+class AxisymResidualSurf : public VectorFormSurf<double>
+{
+public:
+  AxisymResidualSurf(int i, std::string area, double alpha, double c, GeomType axisym);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                       Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  VectorFormSurf<double>* clone() const;
+
+protected:
+  double alpha, c;
+  GeomType axisym;
+};
+
+#endif
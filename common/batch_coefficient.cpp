@@ -0,0 +1,21 @@
+#include "batch_coefficient.h"
+
+ConstantBatchCoefficient::ConstantBatchCoefficient(double value) : value(value)
+{
+}
+
+void ConstantBatchCoefficient::eval(int n, const double* x, const double* y, double* out) const
+{
+  for (int i = 0; i < n; i++)
+    out[i] = value;
+}
+
+PointwiseBatchCoefficient::PointwiseBatchCoefficient(double (*fn)(double x, double y)) : fn(fn)
+{
+}
+
+void PointwiseBatchCoefficient::eval(int n, const double* x, const double* y, double* out) const
+{
+  for (int i = 0; i < n; i++)
+    out[i] = fn(x[i], y[i]);
+}
@@ -0,0 +1,50 @@
+#ifndef __HERMES_TUTORIAL_BATCH_COEFFICIENT_H
+#define __HERMES_TUTORIAL_BATCH_COEFFICIENT_H
+
+/* Batched coefficients */
+
+// Non-constant equation coefficient evaluated in all integration points of
+// an element at once, instead of one function call per point. This keeps the
+// call overhead out of the quadrature loop and lets the implementation write
+// its loop so that the compiler can vectorize it (no calls, selects instead
+// of branches).
+
+/// Forms evaluate coefficients in chunks of at most this many points, so
+/// that the values fit into arrays on the stack.
+const int COEFFICIENT_BATCH_SIZE = 64;
+
+class BatchCoefficient
+{
+public:
+  virtual ~BatchCoefficient() {}
+
+  /// Evaluates the coefficient in the points (x[i], y[i]), i = 0 ... n-1.
+  virtual void eval(int n, const double* x, const double* y, double* out) const = 0;
+};
+
+/// Constant coefficient.
+class ConstantBatchCoefficient : public BatchCoefficient
+{
+public:
+  ConstantBatchCoefficient(double value);
+
+  virtual void eval(int n, const double* x, const double* y, double* out) const;
+
+protected:
+  double value;
+};
+
+/// Adapter for an existing pointwise function, no faster than calling the
+/// function directly.
+class PointwiseBatchCoefficient : public BatchCoefficient
+{
+public:
+  PointwiseBatchCoefficient(double (*fn)(double x, double y));
+
+  virtual void eval(int n, const double* x, const double* y, double* out) const;
+
+protected:
+  double (*fn)(double x, double y);
+};
+
+#endif
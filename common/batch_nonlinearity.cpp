@@ -0,0 +1,108 @@
+#include "batch_nonlinearity.h"
+
+#include <algorithm>
+
+/* Batched nonlinearities */
+
+BatchNonlinearity::BatchNonlinearity() : Hermes1DFunction<double>()
+{
+  this->is_const = false;
+}
+
+void BatchNonlinearity::values(int n, const double* u, double* value) const
+{
+  for (int i = 0; i < n; i++)
+    value[i] = this->value(u[i]);
+}
+
+/* Weak forms */
+
+BatchJacobianDiffusion::BatchJacobianDiffusion(int i, int j, std::string area, const BatchNonlinearity* lambda)
+  : MatrixFormVol<double>(i, j), lambda(lambda)
+{
+  this->set_area(area);
+}
+
+double BatchJacobianDiffusion::value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                                     Func<double> *v, Geom<double> *e, Func<double> **ext) const
+{
+  // Nonlinearity in a chunk of integration points.
+  double val[COEFFICIENT_BATCH_SIZE], der[COEFFICIENT_BATCH_SIZE];
+
+  double result = 0;
+  for (int start = 0; start < n; start += COEFFICIENT_BATCH_SIZE)
+  {
+    int m = std::min(COEFFICIENT_BATCH_SIZE, n - start);
+    lambda->value_and_derivative(m, u_ext[0]->val + start, val, der);
+
+    const double *w = wt + start,
+                 *u_prev_dx = u_ext[0]->dx + start, *u_prev_dy = u_ext[0]->dy + start,
+                 *u_val = u->val + start, *u_dx = u->dx + start, *u_dy = u->dy + start,
+                 *v_dx = v->dx + start, *v_dy = v->dy + start;
+    for (int i = 0; i < m; i++)
+      result += w[i] * (der[i] * u_val[i] * (u_prev_dx[i] * v_dx[i] + u_prev_dy[i] * v_dy[i])
+                        + val[i] * (u_dx[i] * v_dx[i] + u_dy[i] * v_dy[i]));
+  }
+  return result;
+}
+
+Ord BatchJacobianDiffusion::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                                Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return lambda->derivative(u_ext[0]->val[0]) * u->val[0] * (u_ext[0]->dx[0] * v->dx[0] + u_ext[0]->dy[0] * v->dy[0])
+         + lambda->value(u_ext[0]->val[0]) * (u->dx[0] * v->dx[0] + u->dy[0] * v->dy[0]);
+}
+
+MatrixFormVol<double>* BatchJacobianDiffusion::clone() const
+{
+  return new BatchJacobianDiffusion(*this);
+}
+
+BatchResidualDiffusion::BatchResidualDiffusion(int i, std::string area, const BatchNonlinearity* lambda)
+  : VectorFormVol<double>(i), lambda(lambda)
+{
+  this->set_area(area);
+}
+
+double BatchResidualDiffusion::value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                                     Geom<double> *e, Func<double> **ext) const
+{
+  // Nonlinearity in a chunk of integration points.
+  double val[COEFFICIENT_BATCH_SIZE];
+
+  double result = 0;
+  for (int start = 0; start < n; start += COEFFICIENT_BATCH_SIZE)
+  {
+    int m = std::min(COEFFICIENT_BATCH_SIZE, n - start);
+    lambda->values(m, u_ext[0]->val + start, val);
+
+    const double *w = wt + start,
+                 *u_prev_dx = u_ext[0]->dx + start, *u_prev_dy = u_ext[0]->dy + start,
+                 *v_dx = v->dx + start, *v_dy = v->dy + start;
+    for (int i = 0; i < m; i++)
+      result += w[i] * val[i] * (u_prev_dx[i] * v_dx[i] + u_prev_dy[i] * v_dy[i]);
+  }
+  return result;
+}
+
+Ord BatchResidualDiffusion::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                                Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return lambda->value(u_ext[0]->val[0]) * (u_ext[0]->dx[0] * v->dx[0] + u_ext[0]->dy[0] * v->dy[0]);
+}
+
+VectorFormVol<double>* BatchResidualDiffusion::clone() const
+{
+  return new BatchResidualDiffusion(*this);
+}
+
+BatchWeakFormPoisson::BatchWeakFormPoisson(std::string area, const BatchNonlinearity* lambda,
+                                           Hermes2DFunction<double>* f) : WeakForm<double>(1)
+{
+  // Jacobian.
+  add_matrix_form(new BatchJacobianDiffusion(0, 0, area, lambda));
+
+  // Residual.
+  add_vector_form(new BatchResidualDiffusion(0, area, lambda));
+  add_vector_form(new WeakFormsH1::DefaultVectorFormVol<double>(0, area, f));
+}
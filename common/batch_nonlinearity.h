@@ -0,0 +1,76 @@
+#ifndef __HERMES_TUTORIAL_BATCH_NONLINEARITY_H
+#define __HERMES_TUTORIAL_BATCH_NONLINEARITY_H
+
+#include "hermes2d.h"
+#include "batch_coefficient.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Batched nonlinearities */
+
+// Nonlinearity lambda(u) whose value and derivative are evaluated together in
+// all integration points of a chunk at once, instead of two virtual calls per
+// point (see also batch_coefficient.h). Implemented by the power laws of
+// power_law.h and by UniformCubicSpline (uniform_cubic_spline.h).
+
+class BatchNonlinearity : public Hermes1DFunction<double>
+{
+public:
+  BatchNonlinearity();
+
+  /// lambda(u[i]) and lambda'(u[i]) for i = 0 ... n-1.
+  virtual void value_and_derivative(int n, const double* u, double* value, double* derivative) const = 0;
+
+  /// lambda(u[i]) only, for the residual. The default calls value().
+  virtual void values(int n, const double* u, double* value) const;
+};
+
+/* Weak forms */
+
+// The forms of DefaultWeakFormPoisson (Newton's method for
+// -div(lambda(u) grad u) + f = 0) with the nonlinearity evaluated in chunks
+// of COEFFICIENT_BATCH_SIZE points. The residual needs only lambda(u).
+
+class BatchJacobianDiffusion : public MatrixFormVol<double>
+{
+public:
+  BatchJacobianDiffusion(int i, int j, std::string area, const BatchNonlinearity* lambda);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                       Func<double> *v, Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  virtual MatrixFormVol<double>* clone() const;
+
+protected:
+  const BatchNonlinearity* lambda;
+};
+
+class BatchResidualDiffusion : public VectorFormVol<double>
+{
+public:
+  BatchResidualDiffusion(int i, std::string area, const BatchNonlinearity* lambda);
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                       Geom<double> *e, Func<double> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  virtual VectorFormVol<double>* clone() const;
+
+protected:
+  const BatchNonlinearity* lambda;
+};
+
+/// Replaces DefaultWeakFormPoisson(area, lambda, f).
+class BatchWeakFormPoisson : public WeakForm<double>
+{
+public:
+  BatchWeakFormPoisson(std::string area, const BatchNonlinearity* lambda, Hermes2DFunction<double>* f);
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include "block_sparse_matrix.h"
+#include "hermes2d.h"
+
+#include <algorithm>
+#include <cmath>
+
+BlockSparseMatrix::BlockSparseMatrix() : block_size(0), n(0)
+{
+}
+
+void BlockSparseMatrix::create_from_csc(int block_size, int size, const int* Ap, const int* Ai, const double* Ax)
+{
+  if (block_size < 1 || size % block_size != 0)
+    throw Hermes::Exceptions::Exception("A matrix of size %d cannot be split into blocks of size %d.", size, block_size);
+
+  this->block_size = block_size;
+  this->n = size / block_size;
+  int bb = block_size * block_size;
+  int nnz = Ap[size];
+
+  // Sort the scalar entries by block row (counting sort), remembering the
+  // block column, the position within the block and the value.
+  std::vector<int> entry_ptr(n + 1, 0);
+  for (int k = 0; k < nnz; k++)
+    entry_ptr[Ai[k] % n + 1]++;
+  for (int r = 0; r < n; r++)
+    entry_ptr[r + 1] += entry_ptr[r];
+
+  std::vector<int> entry_col(nnz), entry_pos(nnz);
+  std::vector<double> entry_val(nnz);
+  std::vector<int> next(entry_ptr.begin(), entry_ptr.end() - 1);
+  for (int c = 0; c < size; c++)
+  {
+    int block_col = c % n, comp_col = c / n;
+    for (int k = Ap[c]; k < Ap[c + 1]; k++)
+    {
+      int r = Ai[k];
+      int dest = next[r % n]++;
+      entry_col[dest] = block_col;
+      entry_pos[dest] = (r / n) * block_size + comp_col;
+      entry_val[dest] = Ax[k];
+    }
+  }
+
+  // Block pattern: the distinct block columns of every block row, sorted.
+  // 'slot' maps a block column to its block within the current row.
+  std::vector<int> slot(n, -1);
+  row_ptr.assign(n + 1, 0);
+  col_idx.clear();
+  values.clear();
+  for (int r = 0; r < n; r++)
+  {
+    int first = col_idx.size();
+    for (int k = entry_ptr[r]; k < entry_ptr[r + 1]; k++)
+    {
+      if (slot[entry_col[k]] < 0)
+      {
+        slot[entry_col[k]] = 1;
+        col_idx.push_back(entry_col[k]);
+      }
+    }
+    std::sort(col_idx.begin() + first, col_idx.end());
+    for (unsigned int k = first; k < col_idx.size(); k++)
+      slot[col_idx[k]] = k;
+
+    values.resize(col_idx.size() * bb, 0.0);
+    for (int k = entry_ptr[r]; k < entry_ptr[r + 1]; k++)
+      values[slot[entry_col[k]] * bb + entry_pos[k]] += entry_val[k];
+
+    for (unsigned int k = first; k < col_idx.size(); k++)
+      slot[col_idx[k]] = -1;
+    row_ptr[r + 1] = col_idx.size();
+  }
+}
+
+void BlockSparseMatrix::multiply(const double* x, double* y) const
+{
+  if (block_size == 2)
+  {
+    // All four couplings of a pair of basis functions in one pass.
+    const double* x0 = x;
+    const double* x1 = x + n;
+    for (int r = 0; r < n; r++)
+    {
+      double y0 = 0, y1 = 0;
+      for (int k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+      {
+        const double* b = &values[4 * k];
+        int c = col_idx[k];
+        y0 += b[0] * x0[c] + b[1] * x1[c];
+        y1 += b[2] * x0[c] + b[3] * x1[c];
+      }
+      y[r] = y0;
+      y[n + r] = y1;
+    }
+    return;
+  }
+
+  int bb = block_size * block_size;
+  std::vector<double> sum(block_size);
+  for (int r = 0; r < n; r++)
+  {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    for (int k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+    {
+      const double* b = &values[bb * k];
+      int c = col_idx[k];
+      for (int i = 0; i < block_size; i++)
+        for (int j = 0; j < block_size; j++)
+          sum[i] += b[i * block_size + j] * x[j * n + c];
+    }
+    for (int i = 0; i < block_size; i++)
+      y[i * n + r] = sum[i];
+  }
+}
+
+void BlockSparseMatrix::invert_diagonal_blocks(std::vector<double>& inverses) const
+{
+  int bb = block_size * block_size;
+  inverses.assign(n * bb, 0.0);
+  std::vector<double> a(bb);
+  for (int r = 0; r < n; r++)
+  {
+    double* inv = &inverses[r * bb];
+    for (int i = 0; i < block_size; i++)
+      inv[i * block_size + i] = 1.0;
+
+    double d = get(r, r, 0, 0);
+    std::fill(a.begin(), a.end(), 0.0);
+    for (int i = 0; i < block_size; i++)
+      for (int j = 0; j < block_size; j++)
+        a[i * block_size + j] = get(r, r, i, j);
+
+    // Gauss-Jordan elimination without pivoting (the blocks of a symmetric
+    // positive definite matrix are symmetric positive definite).
+    bool singular = false;
+    for (int k = 0; k < block_size && !singular; k++)
+    {
+      double pivot = a[k * block_size + k];
+      if (std::abs(pivot) <= 1e-14 * std::abs(d))
+      {
+        singular = true;
+        break;
+      }
+      for (int j = 0; j < block_size; j++)
+      {
+        a[k * block_size + j] /= pivot;
+        inv[k * block_size + j] /= pivot;
+      }
+      for (int i = 0; i < block_size; i++)
+      {
+        if (i == k)
+          continue;
+        double f = a[i * block_size + k];
+        for (int j = 0; j < block_size; j++)
+        {
+          a[i * block_size + j] -= f * a[k * block_size + j];
+          inv[i * block_size + j] -= f * inv[k * block_size + j];
+        }
+      }
+    }
+
+    if (singular)
+    {
+      std::fill(inv, inv + bb, 0.0);
+      for (int i = 0; i < block_size; i++)
+        inv[i * block_size + i] = 1.0;
+    }
+  }
+}
+
+int BlockSparseMatrix::solve_cg(const double* b, double* x, double tol, int max_iter) const
+{
+  int size = n * block_size;
+  int bb = block_size * block_size;
+  std::vector<double> inverses;
+  invert_diagonal_blocks(inverses);
+
+  std::vector<double> r(size), z(size), p(size), q(size);
+  multiply(x, &q[0]);
+  double b_norm = 0;
+  for (int i = 0; i < size; i++)
+  {
+    r[i] = b[i] - q[i];
+    b_norm += b[i] * b[i];
+  }
+  b_norm = std::sqrt(b_norm);
+  if (b_norm == 0)
+    b_norm = 1;
+
+  double rz_old = 0;
+  for (int iter = 0; iter <= max_iter; iter++)
+  {
+    double r_norm = 0;
+    for (int i = 0; i < size; i++)
+      r_norm += r[i] * r[i];
+    if (std::sqrt(r_norm) <= tol * b_norm)
+      return iter;
+    if (iter == max_iter)
+      break;
+
+    // z = M^{-1} r, the components of a block row are strided by n.
+    for (int k = 0; k < n; k++)
+    {
+      const double* inv = &inverses[k * bb];
+      for (int i = 0; i < block_size; i++)
+      {
+        double sum = 0;
+        for (int j = 0; j < block_size; j++)
+          sum += inv[i * block_size + j] * r[j * n + k];
+        z[i * n + k] = sum;
+      }
+    }
+
+    double rz = 0;
+    for (int i = 0; i < size; i++)
+      rz += r[i] * z[i];
+    if (iter == 0)
+      p = z;
+    else
+      for (int i = 0; i < size; i++)
+        p[i] = z[i] + (rz / rz_old) * p[i];
+    rz_old = rz;
+
+    multiply(&p[0], &q[0]);
+    double pq = 0;
+    for (int i = 0; i < size; i++)
+      pq += p[i] * q[i];
+    double alpha = rz / pq;
+    for (int i = 0; i < size; i++)
+    {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+  }
+  return -1;
+}
+
+int BlockSparseMatrix::get_num_block_rows() const
+{
+  return n;
+}
+
+int BlockSparseMatrix::get_num_blocks() const
+{
+  return col_idx.size();
+}
+
+int BlockSparseMatrix::get_block_size() const
+{
+  return block_size;
+}
+
+size_t BlockSparseMatrix::get_memory_size() const
+{
+  return row_ptr.size() * sizeof(int) + col_idx.size() * sizeof(int) + values.size() * sizeof(double);
+}
+
+double BlockSparseMatrix::get(int row, int col, int i, int j) const
+{
+  const int* begin = col_idx.empty() ? NULL : &col_idx[0] + row_ptr[row];
+  const int* end = col_idx.empty() ? NULL : &col_idx[0] + row_ptr[row + 1];
+  const int* it = std::lower_bound(begin, end, col);
+  if (it == end || *it != col)
+    return 0.0;
+  return values[(it - &col_idx[0]) * block_size * block_size + i * block_size + j];
+}
+
+size_t get_scalar_sparse_memory_size(int size, int nnz)
+{
+  return (size + 1) * sizeof(int) + nnz * (sizeof(int) + sizeof(double));
+}
@@ -0,0 +1,70 @@
+#ifndef __HERMES_TUTORIAL_BLOCK_SPARSE_MATRIX_H
+#define __HERMES_TUTORIAL_BLOCK_SPARSE_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+/* Block sparse matrix */
+
+// Matrix of a system of 'block_size' equations discretized by identical
+// spaces (e.g. the displacement components in elasticity), stored in the
+// block compressed sparse row format (BSR): one dense block per pair of
+// basis functions, holding the couplings of all components. Compared to the
+// scalar format, the column index is stored once per block instead of once
+// per entry and the matrix-vector product reads every block contiguously.
+//
+// Hermes numbers the unknowns component by component: with n unknowns per
+// component, the unknown k of component c has the index c * n + k. The block
+// row/column k collects the unknowns k, n + k, ... of all components. All
+// vectors passed to the matrix use this (Hermes) numbering.
+
+class BlockSparseMatrix
+{
+public:
+  BlockSparseMatrix();
+
+  /// Builds the matrix from a scalar matrix in the compressed sparse column
+  /// format (as used by UMFPACK) of size block_size * n. Entries missing in
+  /// the scalar matrix are stored as zeros in the blocks. Throws an exception
+  /// if the size is not a multiple of the block size. Replaces the previous
+  /// contents. The scalar matrix stays alive during the conversion, so the
+  /// peak memory is that of both formats.
+  void create_from_csc(int block_size, int size, const int* Ap, const int* Ai, const double* Ax);
+
+  /// y = A x.
+  void multiply(const double* x, double* y) const;
+
+  /// Solves A x = b by the conjugate gradient method with the block Jacobi
+  /// preconditioner (A symmetric positive definite), 'x' holds the initial
+  /// guess. Stops when the residual drops below 'tol' times the norm of b.
+  /// Returns the number of iterations, or -1 if it did not converge.
+  int solve_cg(const double* b, double* x, double tol = 1e-10, int max_iter = 10000) const;
+
+  /// Number of block rows (unknowns per component).
+  int get_num_block_rows() const;
+  /// Number of stored blocks.
+  int get_num_blocks() const;
+  int get_block_size() const;
+  /// Memory used by the matrix data (bytes).
+  size_t get_memory_size() const;
+
+  /// Block (row, col) of the component pair (i, j), 0 if not stored.
+  double get(int row, int col, int i, int j) const;
+
+protected:
+  /// Inverses of the diagonal blocks (identity where a block is singular).
+  void invert_diagonal_blocks(std::vector<double>& inverses) const;
+
+  int block_size;
+  int n;
+  // Block row pointers (n + 1), block column indices and the blocks,
+  // each stored row by row (block_size * block_size values).
+  std::vector<int> row_ptr;
+  std::vector<int> col_idx;
+  std::vector<double> values;
+};
+
+/// Memory used by a scalar CSC/CSR matrix (bytes), for comparison.
+size_t get_scalar_sparse_memory_size(int size, int nnz);
+
+#endif
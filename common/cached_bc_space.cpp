@@ -0,0 +1,158 @@
+#include "cached_bc_space.h"
+
+#include <map>
+
+// Boundary condition, order and geometry of an edge projection.
+struct BCProjectionKey
+{
+  const EssentialBoundaryCondition<double>* bc;
+  int order;
+  double time;
+  double x1, y1, x2, y2, lo, hi;
+
+  bool operator<(const BCProjectionKey& other) const
+  {
+    if (bc != other.bc) return bc < other.bc;
+    if (order != other.order) return order < other.order;
+    const double a[7] = { time, x1, y1, x2, y2, lo, hi };
+    const double b[7] = { other.time, other.x1, other.y1, other.x2, other.y2, other.lo, other.hi };
+    for (int i = 0; i < 7; i++)
+      if (a[i] != b[i])
+        return a[i] < b[i];
+    return false;
+  }
+};
+
+// Projections of one space and its copies. H1Space::get_bc_projection()
+// returns order + 1 coefficients (vertex values and edge functions),
+// allocated by new[].
+struct BCProjectionCache
+{
+  BCProjectionCache() : num_spaces(1), hits(0), misses(0)
+  {
+  }
+
+  /// Drops the projections of 'bc' if they were computed at another time.
+  void set_time(const EssentialBoundaryCondition<double>* bc, double time)
+  {
+    std::map<const EssentialBoundaryCondition<double>*, double>::iterator it = times.find(bc);
+    if (it == times.end())
+    {
+      times[bc] = time;
+      return;
+    }
+    if (it->second == time)
+      return;
+    it->second = time;
+
+    std::map<BCProjectionKey, std::vector<double> >::iterator p = projections.begin();
+    while (p != projections.end())
+    {
+      if (p->first.bc == bc)
+        projections.erase(p++);
+      else
+        ++p;
+    }
+  }
+
+  std::map<BCProjectionKey, std::vector<double> > projections;
+  // Current time of every condition met so far.
+  std::map<const EssentialBoundaryCondition<double>*, double> times;
+  int num_spaces;
+  int hits, misses;
+};
+
+CachedBCH1Space::CachedBCH1Space(Mesh* mesh, EssentialBCs<double>* essential_bcs, int p_init, Shapeset* shapeset)
+  : H1Space<double>(mesh, essential_bcs, p_init, shapeset), bc_cache(new BCProjectionCache)
+{
+}
+
+CachedBCH1Space::CachedBCH1Space(Mesh* mesh, EssentialBCs<double>* essential_bcs, Shapeset* shapeset,
+                                 BCProjectionCache* bc_cache)
+  : H1Space<double>(mesh, essential_bcs, 1, shapeset), bc_cache(bc_cache)
+{
+#pragma omp critical (cached_bc_space)
+  bc_cache->num_spaces++;
+}
+
+CachedBCH1Space::~CachedBCH1Space()
+{
+  bool last = false;
+#pragma omp critical (cached_bc_space)
+  last = (--bc_cache->num_spaces == 0);
+  if (last)
+    delete bc_cache;
+}
+
+Space<double>* CachedBCH1Space::dup(Mesh* mesh, int order_increase) const
+{
+  CachedBCH1Space* space = new CachedBCH1Space(mesh, this->essential_bcs, this->shapeset, this->bc_cache);
+  space->copy_orders(this, order_increase);
+  return space;
+}
+
+void CachedBCH1Space::invalidate_bc_cache()
+{
+#pragma omp critical (cached_bc_space)
+  {
+    bc_cache->projections.clear();
+    bc_cache->times.clear();
+    bc_cache->hits = 0;
+    bc_cache->misses = 0;
+  }
+}
+
+void CachedBCH1Space::get_bc_cache_statistics(int& hits, int& misses) const
+{
+#pragma omp critical (cached_bc_space)
+  {
+    hits = bc_cache->hits;
+    misses = bc_cache->misses;
+  }
+}
+
+double* CachedBCH1Space::get_bc_projection(SurfPos* surf_pos, int order, EssentialBoundaryCondition<double>* bc)
+{
+  Element* base = surf_pos->base;
+  if (base->is_curved())
+    return H1Space<double>::get_bc_projection(surf_pos, order, bc);
+
+  Node* v1 = base->vn[surf_pos->surf_num];
+  Node* v2 = base->vn[base->next_vert(surf_pos->surf_num)];
+  BCProjectionKey key;
+  key.bc = bc;
+  key.order = order;
+  key.time = bc->get_current_time();
+  key.x1 = v1->x;
+  key.y1 = v1->y;
+  key.x2 = v2->x;
+  key.y2 = v2->y;
+  key.lo = surf_pos->lo;
+  key.hi = surf_pos->hi;
+
+  double* proj = NULL;
+#pragma omp critical (cached_bc_space)
+  {
+    bc_cache->set_time(bc, key.time);
+    std::map<BCProjectionKey, std::vector<double> >::const_iterator it = bc_cache->projections.find(key);
+    if (it != bc_cache->projections.end())
+    {
+      proj = new double[order + 1];
+      std::copy(it->second.begin(), it->second.end(), proj);
+      bc_cache->hits++;
+    }
+  }
+  if (proj != NULL)
+    return proj;
+
+  // Computed outside of the critical section, other threads may do the same.
+  proj = H1Space<double>::get_bc_projection(surf_pos, order, bc);
+#pragma omp critical (cached_bc_space)
+  {
+    // Only if no other thread moved the condition to a new time meanwhile.
+    if (bc_cache->times[bc] == key.time)
+      bc_cache->projections[key] = std::vector<double>(proj, proj + order + 1);
+    bc_cache->misses++;
+  }
+  return proj;
+}
@@ -0,0 +1,61 @@
+#ifndef __HERMES_TUTORIAL_CACHED_BC_SPACE_H
+#define __HERMES_TUTORIAL_CACHED_BC_SPACE_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Cached projections of essential boundary conditions */
+
+// H1 space which memoizes the projections of the Dirichlet lift onto the
+// boundary edges. The projection of an edge depends only on the boundary
+// condition (and its current time), the polynomial order and the geometry of
+// the edge, so it is stored under these keys and reused whenever the same
+// edge is met again: when the DOFs are reassigned, in every copy of the space
+// (reference spaces in adaptivity are created by dup() and keep the cache),
+// and in spaces on refined meshes for all edges the refinement did not touch.
+// The edge geometry is identified by the coordinates of the base edge and the
+// part of it covered by the element edge, so the cache is valid across
+// meshes. Curved edges are always projected anew.
+//
+// The cache belongs to the space and is shared with the copies made by dup();
+// it is released together with the last of them. When a condition is met at
+// a new current time, its projections at the previous time are dropped, so
+// a transient problem only keeps one time level. If a condition changes in
+// any other way, invalidate_bc_cache() has to be called.
+
+struct BCProjectionCache;
+
+class CachedBCH1Space : public H1Space<double>
+{
+public:
+  CachedBCH1Space(Mesh* mesh, EssentialBCs<double>* essential_bcs, int p_init = 1,
+                  Shapeset* shapeset = NULL);
+  virtual ~CachedBCH1Space();
+
+  /// The copy shares the cache of this space.
+  virtual Space<double>* dup(Mesh* mesh, int order_increase = 0) const;
+
+  /// Releases all cached projections (also for the copies sharing them).
+  void invalidate_bc_cache();
+
+  /// Number of projections taken from the cache and computed, respectively.
+  void get_bc_cache_statistics(int& hits, int& misses) const;
+
+protected:
+  /// A space using the cache 'bc_cache'.
+  CachedBCH1Space(Mesh* mesh, EssentialBCs<double>* essential_bcs, Shapeset* shapeset,
+                  BCProjectionCache* bc_cache);
+
+  virtual double* get_bc_projection(SurfPos* surf_pos, int order, EssentialBoundaryCondition<double>* bc);
+
+  // Shared with the copies, reference counted.
+  BCProjectionCache* bc_cache;
+
+private:
+  CachedBCH1Space(const CachedBCH1Space&);
+  CachedBCH1Space& operator=(const CachedBCH1Space&);
+};
+
+#endif
@@ -0,0 +1,399 @@
+#include "chord_newton.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Chord Newton's method */
+
+// Trust region radii tried in one iteration (each rejection shrinks the
+// radius at least 4 times).
+static const int MAX_TRUST_REGION_ATTEMPTS = 15;
+
+ChordNewtonSolver::ChordNewtonSolver(DiscreteProblem<double>* dp)
+  : dp(dp), tol(1e-8), max_iter(100), max_contraction(0.5), max_reuse(0),
+    gamma(0.9), eta_min(1e-10), eta_max(0.9), globalization(FULL_STEP),
+    min_step_length(1e-4), trust_radius(0), initial_trust_radius(0), residual(NULL),
+    num_iters(0), num_jacobian_assemblies(0), num_assemblies_avoided(0), num_residual_assemblies(0), num_rejected_steps(0)
+{
+}
+
+ChordNewtonSolver::~ChordNewtonSolver()
+{
+}
+
+void ChordNewtonSolver::set_tol(double tol)
+{
+  this->tol = tol;
+}
+
+void ChordNewtonSolver::set_max_iter(int max_iter)
+{
+  this->max_iter = max_iter;
+}
+
+void ChordNewtonSolver::set_max_contraction(double max_contraction)
+{
+  if (max_contraction < 0 || max_contraction >= 1)
+    throw Hermes::Exceptions::Exception("ChordNewtonSolver: max_contraction has to be in [0, 1).");
+  this->max_contraction = max_contraction;
+}
+
+void ChordNewtonSolver::set_max_reuse(int max_reuse)
+{
+  this->max_reuse = max_reuse;
+}
+
+void ChordNewtonSolver::set_forcing_parameters(double gamma, double eta_min, double eta_max)
+{
+  this->gamma = gamma;
+  this->eta_min = eta_min;
+  this->eta_max = eta_max;
+}
+
+void ChordNewtonSolver::set_globalization(Globalization globalization)
+{
+  this->globalization = globalization;
+}
+
+void ChordNewtonSolver::set_min_step_length(double min_step_length)
+{
+  this->min_step_length = min_step_length;
+}
+
+void ChordNewtonSolver::set_initial_trust_radius(double trust_radius)
+{
+  this->initial_trust_radius = trust_radius;
+}
+
+int ChordNewtonSolver::get_num_iters() const
+{
+  return num_iters;
+}
+
+int ChordNewtonSolver::get_num_jacobian_assemblies() const
+{
+  return num_jacobian_assemblies;
+}
+
+int ChordNewtonSolver::get_num_residual_assemblies() const
+{
+  return num_residual_assemblies;
+}
+
+int ChordNewtonSolver::get_num_assemblies_avoided() const
+{
+  return num_assemblies_avoided;
+}
+
+int ChordNewtonSolver::get_num_rejected_steps() const
+{
+  return num_rejected_steps;
+}
+
+bool ChordNewtonSolver::solve(double* coeff_vec)
+{
+  int ndof = dp->get_num_dofs();
+  num_iters = num_jacobian_assemblies = num_assemblies_avoided = num_rejected_steps = 0;
+  trust_radius = initial_trust_radius;
+  trial.resize(ndof);
+
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  residual = new ResidualAssembler(dp);
+  Hermes::Algebra::Vector<double>* rhs = residual->get_vector();
+  Hermes::Solvers::LinearMatrixSolver<double>* solver = Hermes::Solvers::create_linear_solver<double>(matrix, rhs);
+  Hermes::Solvers::IterSolver<double>* iter_solver = dynamic_cast<Hermes::Solvers::IterSolver<double>*>(solver);
+
+  // Residual at the current iterate and the Newton step.
+  std::vector<double> f(ndof), dx(ndof);
+
+  // Steps performed with the current Jacobian, -1 before the first one.
+  int jacobian_age = -1;
+  double norm = residual->assemble(coeff_vec);
+  double norm_previous = 0;
+  double eta = eta_max;
+  bool converged = false;
+  while (true)
+  {
+    double contraction = (num_iters > 0) ? norm / norm_previous : 1.0;
+    if (num_iters == 0)
+      this->info("Chord Newton initial residual norm: %g", norm);
+    else
+      this->info("Chord Newton iter %d, residual norm: %g, contraction: %g", num_iters, norm, contraction);
+
+    if (norm < tol)
+    {
+      converged = true;
+      break;
+    }
+    if (num_iters == max_iter)
+      break;
+    if (!(norm == norm))
+      throw Hermes::Exceptions::Exception("Chord Newton: residual norm is NaN in the iteration %d.", num_iters);
+    std::copy(residual->get_residual(), residual->get_residual() + ndof, f.begin());
+
+    // The Jacobian at the current iterate if the old one does not contract
+    // well enough (or is too old).
+    bool refresh = (jacobian_age < 0 || contraction > max_contraction || (max_reuse > 0 && jacobian_age >= max_reuse));
+
+    // Eisenstat-Walker forcing term, once per iteration (a retry with a
+    // refreshed Jacobian keeps it).
+    if (iter_solver != NULL)
+    {
+      if (num_iters > 0)
+      {
+        double eta_new = gamma * contraction * contraction;
+        double safeguard = gamma * eta * eta;
+        if (safeguard > 0.1)
+          eta_new = std::max(eta_new, safeguard);
+        eta = std::max(eta_min, std::min(eta_max, eta_new));
+      }
+      iter_solver->set_tolerance(eta);
+    }
+
+    bool accepted = false;
+    while (!accepted)
+    {
+      if (refresh)
+      {
+        dp->assemble(coeff_vec, matrix);
+        num_jacobian_assemblies++;
+        solver->set_factorization_scheme(num_jacobian_assemblies > 1 ? Hermes::Solvers::HERMES_REUSE_MATRIX_REORDERING
+                                                                      : Hermes::Solvers::HERMES_FACTORIZE_FROM_SCRATCH);
+        jacobian_age = 0;
+      }
+      else
+        solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_FACTORIZATION_COMPLETELY);
+
+      // J dx = -F, the right-hand side may hold the residual of a rejected
+      // trial point.
+      for (int i = 0; i < ndof; i++)
+        rhs->set(i, -f[i]);
+      if (!solver->solve())
+        throw Hermes::Exceptions::Exception("Matrix solver failed in the chord Newton iteration %d.", num_iters + 1);
+      std::copy(solver->get_sln_vector(), solver->get_sln_vector() + ndof, dx.begin());
+
+      double norm_new = norm;
+      if (globalization == LINE_SEARCH)
+        accepted = line_search(coeff_vec, &dx[0], norm_new);
+      else if (globalization == TRUST_REGION)
+        accepted = trust_region_step(coeff_vec, &dx[0], &f[0], matrix, norm_new);
+      else
+      {
+        for (int i = 0; i < ndof; i++)
+          coeff_vec[i] += dx[i];
+        norm_new = residual->assemble(coeff_vec);
+        accepted = true;
+      }
+
+      if (accepted)
+      {
+        norm_previous = norm;
+        norm = norm_new;
+        if (!refresh)
+          num_assemblies_avoided++;
+      }
+      else if (jacobian_age > 0)
+      {
+        this->info("Chord Newton: step rejected with an old Jacobian, refreshing it.");
+        refresh = true;
+      }
+      else
+        break;
+    }
+    if (!accepted)
+    {
+      this->info("Chord Newton: no acceptable step in the iteration %d.", num_iters + 1);
+      break;
+    }
+    jacobian_age++;
+    num_iters++;
+  }
+
+  num_residual_assemblies = residual->get_num_assemblies();
+  this->info("Chord Newton: %d iterations, %d Jacobian assemblies (%d avoided), %d residual assemblies, %d rejected steps.",
+             num_iters, num_jacobian_assemblies, get_num_assemblies_avoided(), num_residual_assemblies, num_rejected_steps);
+
+  delete solver;
+  delete matrix;
+  delete residual;
+  residual = NULL;
+  return converged;
+}
+
+bool ChordNewtonSolver::line_search(double* coeff_vec, const double* dx, double& norm)
+{
+  // Sufficient decrease parameter.
+  const double c = 1e-4;
+
+  int ndof = trial.size();
+  for (double t = 1.0; t >= min_step_length; t *= 0.5)
+  {
+    for (int i = 0; i < ndof; i++)
+      trial[i] = coeff_vec[i] + t * dx[i];
+    double norm_trial = residual->assemble(&trial[0]);
+    if (norm_trial <= (1 - c * t) * norm)
+    {
+      if (t < 1.0)
+        this->info("Chord Newton: line search step length %g.", t);
+      std::copy(trial.begin(), trial.end(), coeff_vec);
+      norm = norm_trial;
+      return true;
+    }
+    num_rejected_steps++;
+  }
+  return false;
+}
+
+bool ChordNewtonSolver::trust_region_step(double* coeff_vec, const double* dx, const double* f,
+                                          Hermes::Algebra::SparseMatrix<double>* matrix, double& norm)
+{
+  // Acceptance threshold and the limits for shrinking and growing Delta.
+  const double rho_accept = 1e-4, rho_shrink = 0.25, rho_grow = 0.75;
+
+  int ndof = trial.size();
+  double newton_length = 0;
+  for (int i = 0; i < ndof; i++)
+    newton_length += dx[i] * dx[i];
+  newton_length = std::sqrt(newton_length);
+  if (trust_radius <= 0)
+    trust_radius = newton_length;
+
+  // Gradient g = J^T F of |F + J p|^2 / 2 at p = 0, the Cauchy point
+  // -(|g|^2 / |J g|^2) g and J applied to both (CSC matrices only).
+  Hermes::Algebra::CSCMatrix<double>* csc = dynamic_cast<Hermes::Algebra::CSCMatrix<double>*>(matrix);
+  std::vector<double> g, jg, cauchy, j_cauchy, j_dx;
+  double g_norm = 0;
+  if (csc != NULL)
+  {
+    const int* ap = csc->get_Ap();
+    const int* ai = csc->get_Ai();
+    const double* ax = csc->get_Ax();
+    g.assign(ndof, 0.0);
+    jg.assign(ndof, 0.0);
+    j_dx.assign(ndof, 0.0);
+    for (int col = 0; col < ndof; col++)
+      for (int k = ap[col]; k < ap[col + 1]; k++)
+        g[col] += ax[k] * f[ai[k]];
+    for (int col = 0; col < ndof; col++)
+      for (int k = ap[col]; k < ap[col + 1]; k++)
+      {
+        jg[ai[k]] += ax[k] * g[col];
+        j_dx[ai[k]] += ax[k] * dx[col];
+      }
+
+    double jg_norm2 = 0;
+    for (int i = 0; i < ndof; i++)
+    {
+      g_norm += g[i] * g[i];
+      jg_norm2 += jg[i] * jg[i];
+    }
+    if (jg_norm2 > 0)
+    {
+      double tau = g_norm / jg_norm2;
+      cauchy.resize(ndof);
+      j_cauchy.resize(ndof);
+      for (int i = 0; i < ndof; i++)
+      {
+        cauchy[i] = -tau * g[i];
+        j_cauchy[i] = -tau * jg[i];
+      }
+    }
+    g_norm = std::sqrt(g_norm);
+  }
+
+  // On failure the radius is restored for a step with a new Jacobian.
+  double initial_radius = trust_radius;
+  std::vector<double> step(ndof), j_step(ndof);
+  for (int attempt = 0; attempt < MAX_TRUST_REGION_ATTEMPTS; attempt++)
+  {
+    // Dogleg step and J times it, for the predicted residual F + J p.
+    double step_length;
+    if (newton_length <= trust_radius)
+    {
+      step_length = newton_length;
+      for (int i = 0; i < ndof; i++)
+        step[i] = dx[i];
+      if (csc != NULL)
+        j_step = j_dx;
+    }
+    else if (cauchy.empty())
+    {
+      // Newton direction only.
+      step_length = trust_radius;
+      double s = trust_radius / newton_length;
+      for (int i = 0; i < ndof; i++)
+        step[i] = s * dx[i];
+      if (csc != NULL)
+        for (int i = 0; i < ndof; i++)
+          j_step[i] = s * j_dx[i];
+    }
+    else
+    {
+      double cauchy_length = 0;
+      for (int i = 0; i < ndof; i++)
+        cauchy_length += cauchy[i] * cauchy[i];
+      cauchy_length = std::sqrt(cauchy_length);
+      step_length = trust_radius;
+      if (cauchy_length >= trust_radius)
+      {
+        double s = trust_radius / cauchy_length;
+        for (int i = 0; i < ndof; i++)
+        {
+          step[i] = s * cauchy[i];
+          j_step[i] = s * j_cauchy[i];
+        }
+      }
+      else
+      {
+        // |cauchy + tau (dx - cauchy)| = Delta, 0 < tau < 1.
+        double a = 0, b = 0, c = cauchy_length * cauchy_length - trust_radius * trust_radius;
+        for (int i = 0; i < ndof; i++)
+        {
+          double d = dx[i] - cauchy[i];
+          a += d * d;
+          b += 2 * cauchy[i] * d;
+        }
+        double tau = (-b + std::sqrt(b * b - 4 * a * c)) / (2 * a);
+        for (int i = 0; i < ndof; i++)
+        {
+          step[i] = cauchy[i] + tau * (dx[i] - cauchy[i]);
+          j_step[i] = j_cauchy[i] + tau * (j_dx[i] - j_cauchy[i]);
+        }
+      }
+    }
+
+    // Decrease of |F| predicted by the linear model; without J, the Newton
+    // direction scaled by s predicts (1 - s) |F|.
+    double predicted;
+    if (csc != NULL)
+    {
+      double model = 0;
+      for (int i = 0; i < ndof; i++)
+        model += (f[i] + j_step[i]) * (f[i] + j_step[i]);
+      predicted = norm - std::sqrt(model);
+    }
+    else
+      predicted = norm * step_length / newton_length;
+
+    for (int i = 0; i < ndof; i++)
+      trial[i] = coeff_vec[i] + step[i];
+    double norm_trial = residual->assemble(&trial[0]);
+    double rho = (predicted > 0) ? (norm - norm_trial) / predicted : -1.0;
+
+    if (rho < rho_shrink)
+      trust_radius = 0.25 * step_length;
+    else if (rho > rho_grow && step_length >= 0.99 * trust_radius)
+      trust_radius = 2 * trust_radius;
+
+    if (rho > rho_accept)
+    {
+      std::copy(trial.begin(), trial.end(), coeff_vec);
+      norm = norm_trial;
+      return true;
+    }
+    num_rejected_steps++;
+    this->info("Chord Newton: trust region step rejected, radius %g.", trust_radius);
+  }
+  trust_radius = initial_radius;
+  return false;
+}
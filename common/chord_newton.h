@@ -0,0 +1,137 @@
+#ifndef __HERMES_TUTORIAL_CHORD_NEWTON_H
+#define __HERMES_TUTORIAL_CHORD_NEWTON_H
+
+#include "hermes2d.h"
+#include "residual_assembler.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Chord Newton's method */
+
+// Newton's method that keeps the Jacobian matrix (and its factorization) as
+// long as it is good enough (chord method, or Shamanskii's method with a fixed
+// refresh period). After every step only the residual is assembled (by a
+// ResidualAssembler), and the step uses the old factorization via
+// HERMES_REUSE_FACTORIZATION_COMPLETELY. The Jacobian is assembled and
+// factorized again at the current iterate when
+//
+//   - the residual norm dropped by less than the factor 'max_contraction'
+//     (|F(x_k)| > max_contraction |F(x_{k-1})|), or
+//   - the Jacobian has been used for 'max_reuse' steps (if max_reuse > 0).
+//
+// With max_contraction = 0 this is the plain Newton's method. As
+// NewtonSolver, the iteration stops when the l2 norm of the residual drops
+// below the tolerance.
+//
+// With an iterative matrix solver (Hermes::Solvers::IterSolver) the linear
+// systems are solved inexactly, with the relative tolerance eta_k chosen
+// by Eisenstat and Walker (choice 2):
+//
+//   eta_k = gamma (|F(x_k)| / |F(x_{k-1})|)^2,
+//
+// safeguarded by gamma eta_{k-1}^2 when that is above 0.1, and clipped to
+// [eta_min, eta_max].
+//
+// Far from the solution the full step may increase the residual. Two
+// globalizations accept only steps that decrease |F| (both need residuals
+// only, assembled by the ResidualAssembler):
+//
+//   - LINE_SEARCH: Armijo backtracking, the step t dx with the largest
+//     t = 1, 1/2, 1/4, ... such that |F(x + t dx)| <= (1 - c t) |F(x)|.
+//   - TRUST_REGION: Powell's dogleg step of length at most Delta, between the
+//     Cauchy point of |F + J p|^2 and the Newton step. The step is accepted
+//     if the actual decrease of |F| is at least a fraction of the decrease
+//     predicted by |F + J p|; Delta shrinks or grows with their ratio. The
+//     Cauchy point needs J and J^T F from the matrix in the compressed column
+//     format (CSCMatrix, e.g. UMFPack); for other matrices the Newton
+//     direction is scaled to the trust region instead.
+//
+// If a step is rejected with an old Jacobian, the Jacobian is refreshed and
+// the step computed again.
+
+class ChordNewtonSolver : public Hermes::Mixins::Loggable
+{
+public:
+  enum Globalization
+  {
+    FULL_STEP,
+    LINE_SEARCH,
+    TRUST_REGION
+  };
+
+  ChordNewtonSolver(DiscreteProblem<double>* dp);
+  ~ChordNewtonSolver();
+
+  /// Residual norm to stop at.
+  void set_tol(double tol);
+  void set_max_iter(int max_iter);
+
+  /// Contraction of the residual norm below which the Jacobian is kept,
+  /// 0 <= max_contraction < 1.
+  void set_max_contraction(double max_contraction);
+
+  /// Maximum number of steps with the same Jacobian, 0 means no limit.
+  void set_max_reuse(int max_reuse);
+
+  /// Parameters of the forcing terms of iterative matrix solvers.
+  void set_forcing_parameters(double gamma, double eta_min, double eta_max);
+
+  /// FULL_STEP by default.
+  void set_globalization(Globalization globalization);
+
+  /// Smallest step length of the line search.
+  void set_min_step_length(double min_step_length);
+
+  /// Initial trust region radius (l2 norm of the coefficient vector); 0, the
+  /// default, means the length of the first Newton step.
+  void set_initial_trust_radius(double trust_radius);
+
+  /// Iterates from 'coeff_vec', which receives the result. Returns false if
+  /// the iteration did not converge.
+  bool solve(double* coeff_vec);
+
+  int get_num_iters() const;
+  int get_num_jacobian_assemblies() const;
+  int get_num_residual_assemblies() const;
+
+  /// Jacobian assemblies (and factorizations) the Newton's method would
+  /// have performed in addition: the accepted steps made with a reused
+  /// Jacobian.
+  int get_num_assemblies_avoided() const;
+
+  /// Steps rejected (line search or trust region).
+  int get_num_rejected_steps() const;
+
+protected:
+  /// Armijo backtracking from coeff_vec along dx. On success coeff_vec is
+  /// the new iterate, 'norm' its residual norm, and the ResidualAssembler
+  /// holds its residual.
+  bool line_search(double* coeff_vec, const double* dx, double& norm);
+
+  /// Dogleg step from coeff_vec. 'f' is the residual at coeff_vec, 'dx' the
+  /// Newton step, 'matrix' the Jacobian. As line_search().
+  bool trust_region_step(double* coeff_vec, const double* dx, const double* f,
+                         Hermes::Algebra::SparseMatrix<double>* matrix, double& norm);
+
+  DiscreteProblem<double>* dp;
+  double tol;
+  int max_iter;
+  double max_contraction;
+  int max_reuse;
+  double gamma, eta_min, eta_max;
+  Globalization globalization;
+  double min_step_length;
+  double trust_radius, initial_trust_radius;
+
+  ResidualAssembler* residual;
+  std::vector<double> trial;
+
+  int num_iters;
+  int num_jacobian_assemblies;
+  int num_assemblies_avoided;
+  int num_residual_assemblies;
+  int num_rejected_steps;
+};
+
+#endif
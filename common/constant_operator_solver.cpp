@@ -0,0 +1,87 @@
+#include "constant_operator_solver.h"
+
+#include <algorithm>
+
+/* Time stepping with a constant operator */
+
+ConstantOperatorSolver::ConstantOperatorSolver(WeakForm<double>* wf, WeakForm<double>* wf_load, const Space<double>* space)
+  : wf(wf), wf_load(wf_load), space(space), dp_load(NULL), matrix(NULL), rhs(NULL), load(NULL), solver(NULL),
+    ndof(0), num_steps(0)
+{
+}
+
+ConstantOperatorSolver::~ConstantOperatorSolver()
+{
+  delete solver;
+  delete matrix;
+  delete rhs;
+  delete load;
+  delete dp_load;
+}
+
+void ConstantOperatorSolver::prepare()
+{
+  delete solver;
+  delete matrix;
+  delete rhs;
+  delete load;
+  delete dp_load;
+
+  ndof = space->get_num_dofs();
+  std::vector<double> zero(ndof, 0.0);
+
+  // The matrix and F(0).
+  DiscreteProblem<double> dp(wf, space);
+  matrix = Hermes::Algebra::create_matrix<double>();
+  rhs = Hermes::Algebra::create_vector<double>();
+  dp.assemble(&zero[0], matrix, rhs);
+  solver = Hermes::Solvers::create_linear_solver<double>(matrix, rhs);
+
+  // r_0 = F(0) - F_load(0).
+  dp_load = new DiscreteProblem<double>(wf_load, space);
+  load = Hermes::Algebra::create_vector<double>();
+  dp_load->assemble(&zero[0], load);
+  constant_residual.resize(ndof);
+  load_residual.resize(ndof);
+  if (ndof > 0)
+  {
+    rhs->extract(&constant_residual[0]);
+    load->extract(&load_residual[0]);
+  }
+  for (int i = 0; i < ndof; i++)
+    constant_residual[i] -= load_residual[i];
+
+  // The first solve() factorizes the matrix, all others reuse the factors.
+  num_steps = 0;
+  this->info("Constant operator: matrix assembled, ndof = %d.", ndof);
+}
+
+void ConstantOperatorSolver::solve(double* coeff_vec)
+{
+  if (solver == NULL)
+    prepare();
+
+  std::vector<double> zero(ndof, 0.0);
+  dp_load->assemble(&zero[0], load);
+  if (ndof > 0)
+    load->extract(&load_residual[0]);
+  for (int i = 0; i < ndof; i++)
+    rhs->set(i, -(constant_residual[i] + load_residual[i]));
+
+  if (num_steps > 0)
+    solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_FACTORIZATION_COMPLETELY);
+  if (!solver->solve())
+    throw Hermes::Exceptions::Exception("Matrix solver failed in the step %d.", num_steps + 1);
+  std::copy(solver->get_sln_vector(), solver->get_sln_vector() + ndof, coeff_vec);
+  num_steps++;
+}
+
+int ConstantOperatorSolver::get_num_dofs() const
+{
+  return ndof;
+}
+
+int ConstantOperatorSolver::get_num_steps() const
+{
+  return num_steps;
+}
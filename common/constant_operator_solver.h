@@ -0,0 +1,61 @@
+#ifndef __HERMES_TUTORIAL_CONSTANT_OPERATOR_SOLVER_H
+#define __HERMES_TUTORIAL_CONSTANT_OPERATOR_SOLVER_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Time stepping with a constant operator */
+
+// Implicit time stepping of a linear problem whose matrix does not change
+// from step to step (fixed time step, coefficients independent of time).
+// The residual of 'wf' at a coefficient vector x is
+//
+//   F(x) = A x + r_0 + F_load,
+//
+// where F_load are the residual forms that change between the steps (e.g.
+// the previous time level solution, a time-dependent boundary condition),
+// given by the separate weak form 'wf_load'. prepare() assembles and
+// factorizes A once and stores the constant part r_0 = F(0) - F_load(0) (the
+// other residual forms applied to the Dirichlet lift). Every step then
+// assembles only 'wf_load' and solves A x = -(r_0 + F_load) with the stored
+// factorization, i.e. one forward and back substitution instead of a Newton
+// iteration with a full residual assembly.
+
+class ConstantOperatorSolver : public Hermes::Mixins::Loggable
+{
+public:
+  /// 'wf' is the full weak form, 'wf_load' contains the vector forms of
+  /// 'wf' that change between the steps.
+  ConstantOperatorSolver(WeakForm<double>* wf, WeakForm<double>* wf_load, const Space<double>* space);
+  ~ConstantOperatorSolver();
+
+  /// Assembles and factorizes the matrix, assembles r_0. Called by the first
+  /// solve() if not before; call again if the matrix has changed.
+  void prepare();
+
+  /// Solution of the current step into 'coeff_vec'.
+  void solve(double* coeff_vec);
+
+  int get_num_dofs() const;
+  int get_num_steps() const;
+
+protected:
+  WeakForm<double>* wf;
+  WeakForm<double>* wf_load;
+  const Space<double>* space;
+
+  DiscreteProblem<double>* dp_load;
+  Hermes::Algebra::SparseMatrix<double>* matrix;
+  Hermes::Algebra::Vector<double>* rhs;
+  Hermes::Algebra::Vector<double>* load;
+  Hermes::Solvers::LinearMatrixSolver<double>* solver;
+
+  int ndof;
+  std::vector<double> constant_residual;
+  std::vector<double> load_residual;
+  int num_steps;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "load_case_solver.h"
+
+LoadCaseSolver::LoadCaseSolver(WeakForm<double>* wf, Hermes::vector<const Space<double>*> spaces)
+  : wf(wf), spaces(spaces), ndof(0)
+{
+}
+
+int LoadCaseSolver::add_unit_load(WeakForm<double>* load_wf)
+{
+  unit_loads.push_back(load_wf);
+  return unit_loads.size() - 1;
+}
+
+void LoadCaseSolver::check_dirichlet_data() const
+{
+  for (unsigned int s = 0; s < spaces.size(); s++)
+  {
+    EssentialBCs<double>* bcs = spaces[s]->get_essential_bcs();
+    if (bcs == NULL)
+      continue;
+    for (Hermes::vector<EssentialBoundaryCondition<double>*>::const_iterator it = bcs->begin(); it != bcs->end(); ++it)
+    {
+      if ((*it)->get_value_type() == EssentialBoundaryCondition<double>::BC_CONST)
+      {
+        if ((*it)->value_const != 0.0)
+          throw Hermes::Exceptions::Exception("Load cases need homogeneous Dirichlet data, space %d prescribes the value %g.",
+            s, (*it)->value_const);
+      }
+      else
+        this->warn("Space %d has an essential condition given by a function, the load cases are only valid if it is zero.", s);
+    }
+  }
+}
+
+void LoadCaseSolver::prepare()
+{
+  check_dirichlet_data();
+
+  ndof = Space<double>::get_num_dofs(spaces);
+  std::vector<double> zero(ndof, 0.0);
+
+  // The matrix, assembled once.
+  DiscreteProblem<double> dp(wf, spaces);
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  dp.assemble(&zero[0], matrix, rhs);
+  Hermes::Solvers::LinearMatrixSolver<double>* solver = Hermes::Solvers::create_linear_solver<double>(matrix, rhs);
+
+  // Unit responses: assemble the right-hand side only, the first solve
+  // factorizes the matrix, all others only perform the triangular solves.
+  Hermes::Algebra::Vector<double>* load_rhs = Hermes::Algebra::create_vector<double>();
+  responses.resize(unit_loads.size() * ndof);
+  for (unsigned int k = 0; k < unit_loads.size(); k++)
+  {
+    DiscreteProblem<double> load_dp(unit_loads[k], spaces);
+    load_dp.assemble(&zero[0], load_rhs);
+
+    // The solution is the Newton step from zero.
+    rhs->zero();
+    for (int i = 0; i < ndof; i++)
+      rhs->set(i, -load_rhs->get(i));
+
+    if (k > 0)
+      solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_FACTORIZATION_COMPLETELY);
+    if (!solver->solve())
+      throw Hermes::Exceptions::Exception("Solving for the unit load %d failed.", k);
+    std::copy(solver->get_sln_vector(), solver->get_sln_vector() + ndof, responses.begin() + k * ndof);
+  }
+  this->info("Matrix factorized once, %d unit loads solved.", (int) unit_loads.size());
+
+  delete load_rhs;
+  delete solver;
+  delete matrix;
+  delete rhs;
+}
+
+void LoadCaseSolver::solve(const double* factors, double* sln_vector) const
+{
+  if (responses.empty() && !unit_loads.empty())
+    throw Hermes::Exceptions::Exception("LoadCaseSolver::prepare() has to be called first.");
+
+  std::fill(sln_vector, sln_vector + ndof, 0.0);
+  for (unsigned int k = 0; k < unit_loads.size(); k++)
+  {
+    if (factors[k] == 0)
+      continue;
+    const double* response = &responses[k * ndof];
+    for (int i = 0; i < ndof; i++)
+      sln_vector[i] += factors[k] * response[i];
+  }
+}
+
+int LoadCaseSolver::get_num_dofs() const
+{
+  return ndof;
+}
+
+int LoadCaseSolver::get_num_unit_loads() const
+{
+  return unit_loads.size();
+}
@@ -0,0 +1,59 @@
+#ifndef __HERMES_TUTORIAL_LOAD_CASE_SOLVER_H
+#define __HERMES_TUTORIAL_LOAD_CASE_SOLVER_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Load cases */
+
+// Solves a linear problem for many load cases with the same matrix. Every
+// load case is a combination of unit loads (e.g. a unit surface force in one
+// direction on one boundary, unit gravity), each given by a weak form with
+// vector forms only. The matrix is assembled and factorized once, the right-
+// hand side of every unit load is assembled once and solved with the same
+// factorization (triangular solves only). Since the problem is linear, the
+// solution of a load case is the same combination of the unit responses, so
+// a load case costs no assembly and no solve at all.
+//
+// The superposition is valid only for homogeneous Dirichlet data: the unit
+// responses vanish on the Dirichlet boundary, and so does every combination
+// of them. Load cases cannot prescribe essential boundary values of their
+// own, the spaces (and their boundary conditions) are shared by all cases.
+// prepare() throws an exception if a constant essential condition of the
+// spaces is not zero and warns about conditions given by functions.
+
+class LoadCaseSolver : public Hermes::Mixins::Loggable
+{
+public:
+  /// 'wf' contains the matrix forms of the problem.
+  LoadCaseSolver(WeakForm<double>* wf, Hermes::vector<const Space<double>*> spaces);
+
+  /// Adds a unit load (vector forms of the residual). Returns its index.
+  int add_unit_load(WeakForm<double>* load_wf);
+
+  /// Assembles and factorizes the matrix and solves for all unit loads.
+  /// Throws an exception if the Dirichlet data is not homogeneous.
+  void prepare();
+
+  /// Coefficient vector of the load case sum_k factors[k] * (unit load k).
+  void solve(const double* factors, double* sln_vector) const;
+
+  int get_num_dofs() const;
+  int get_num_unit_loads() const;
+
+protected:
+  /// Checks that the essential conditions of all spaces are homogeneous.
+  void check_dirichlet_data() const;
+
+  WeakForm<double>* wf;
+  Hermes::vector<const Space<double>*> spaces;
+  std::vector<WeakForm<double>*> unit_loads;
+
+  int ndof;
+  // Solutions for the unit loads, one after another.
+  std::vector<double> responses;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "marker_table_forms.h"
+
+/* Piecewise constant coefficients */
+
+template<typename Scalar>
+MarkerCoefficientTable<Scalar>::MarkerCoefficientTable(Mesh* mesh, const std::map<std::string, Scalar>& coefficients)
+{
+  for (typename std::map<std::string, Scalar>::const_iterator it = coefficients.begin(); it != coefficients.end(); ++it)
+  {
+    if (!mesh->get_element_markers_conversion().get_internal_marker(it->first).valid)
+      throw Hermes::Exceptions::Exception("Element marker '%s' not found in the mesh.", it->first.c_str());
+    int marker = mesh->get_element_markers_conversion().get_internal_marker(it->first).marker;
+    if (marker >= (int) values.size())
+      values.resize(marker + 1, Scalar(0));
+    values[marker] = it->second;
+  }
+}
+
+/* Weak forms */
+
+template<typename Scalar>
+MarkerTableJacobianDiffusion<Scalar>::MarkerTableJacobianDiffusion(int i, int j, const MarkerCoefficientTable<Scalar>* table) 
+  : MatrixFormVol<Scalar>(i, j), table(table)
+{
+  this->setSymFlag(HERMES_SYM);
+}
+
+template<typename Scalar>
+Scalar MarkerTableJacobianDiffusion<Scalar>::value(int n, double *wt, Func<Scalar> *u_ext[], Func<double> *u, 
+                                                   Func<double> *v, Geom<double> *e, Func<Scalar> **ext) const
+{
+  double result = 0;
+  for (int i = 0; i < n; i++)
+    result += wt[i] * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]);
+  return table->get(e->elem_marker) * result;
+}
+
+template<typename Scalar>
+Ord MarkerTableJacobianDiffusion<Scalar>::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v, 
+                                              Geom<Ord> *e, Func<Ord> **ext) const
+{
+  // The coefficient is constant on every element.
+  return u->dx[0] * v->dx[0] + u->dy[0] * v->dy[0];
+}
+
+template<typename Scalar>
+MatrixFormVol<Scalar>* MarkerTableJacobianDiffusion<Scalar>::clone() const
+{
+  return new MarkerTableJacobianDiffusion<Scalar>(*this);
+}
+
+template<typename Scalar>
+MarkerTableResidualDiffusion<Scalar>::MarkerTableResidualDiffusion(int i, const MarkerCoefficientTable<Scalar>* table) 
+  : VectorFormVol<Scalar>(i), table(table)
+{
+}
+
+template<typename Scalar>
+Scalar MarkerTableResidualDiffusion<Scalar>::value(int n, double *wt, Func<Scalar> *u_ext[], Func<double> *v, 
+                                                   Geom<double> *e, Func<Scalar> **ext) const
+{
+  Scalar result = Scalar(0);
+  for (int i = 0; i < n; i++)
+    result += wt[i] * (u_ext[this->i]->dx[i] * v->dx[i] + u_ext[this->i]->dy[i] * v->dy[i]);
+  return table->get(e->elem_marker) * result;
+}
+
+template<typename Scalar>
+Ord MarkerTableResidualDiffusion<Scalar>::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v, 
+                                              Geom<Ord> *e, Func<Ord> **ext) const
+{
+  return u_ext[this->i]->dx[0] * v->dx[0] + u_ext[this->i]->dy[0] * v->dy[0];
+}
+
+template<typename Scalar>
+VectorFormVol<Scalar>* MarkerTableResidualDiffusion<Scalar>::clone() const
+{
+  return new MarkerTableResidualDiffusion<Scalar>(*this);
+}
+
+template class MarkerCoefficientTable<double>;
+template class MarkerCoefficientTable<std::complex<double> >;
+template class MarkerTableJacobianDiffusion<double>;
+template class MarkerTableJacobianDiffusion<std::complex<double> >;
+template class MarkerTableResidualDiffusion<double>;
+template class MarkerTableResidualDiffusion<std::complex<double> >;
@@ -0,0 +1,85 @@
+#ifndef __HERMES_TUTORIAL_MARKER_TABLE_FORMS_H
+#define __HERMES_TUTORIAL_MARKER_TABLE_FORMS_H
+
+#include "hermes2d.h"
+
+#include <map>
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Piecewise constant coefficients */
+
+// Coefficient given per material (element marker). The user markers are
+// converted to the internal markers of the mesh once, so that during the
+// assembly the coefficient of an element is a single lookup in a flat array
+// indexed by Geom::elem_marker. Meshes created from the mesh by copying or
+// refinement (reference meshes) share its marker numbering.
+
+template<typename Scalar>
+class MarkerCoefficientTable
+{
+public:
+  /// 'coefficients' maps element markers of the mesh to the coefficient.
+  /// Elements with other markers get the coefficient 0.
+  MarkerCoefficientTable(Mesh* mesh, const std::map<std::string, Scalar>& coefficients);
+
+  /// Coefficient of an element with the internal marker 'elem_marker'.
+  inline Scalar get(int elem_marker) const
+  {
+    if (elem_marker < 0 || elem_marker >= (int) values.size())
+      return Scalar(0);
+    return values[elem_marker];
+  }
+
+protected:
+  std::vector<Scalar> values;
+};
+
+/* Weak forms */
+
+// Replacements for a set of DefaultJacobianDiffusion / DefaultResidualDiffusion
+// forms with constant coefficients, one per material. A single form covers all
+// elements (HERMES_ANY), so every element is integrated once regardless of
+// the number of materials and the coefficient is applied to the integral
+// instead of to every integration point.
+
+template<typename Scalar>
+class MarkerTableJacobianDiffusion : public MatrixFormVol<Scalar>
+{
+public:
+  MarkerTableJacobianDiffusion(int i, int j, const MarkerCoefficientTable<Scalar>* table);
+
+  virtual Scalar value(int n, double *wt, Func<Scalar> *u_ext[], Func<double> *u, 
+                       Func<double> *v, Geom<double> *e, Func<Scalar> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v, 
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  MatrixFormVol<Scalar>* clone() const;
+
+protected:
+  // Not owned, shared by the clones.
+  const MarkerCoefficientTable<Scalar>* table;
+};
+
+template<typename Scalar>
+class MarkerTableResidualDiffusion : public VectorFormVol<Scalar>
+{
+public:
+  MarkerTableResidualDiffusion(int i, const MarkerCoefficientTable<Scalar>* table);
+
+  virtual Scalar value(int n, double *wt, Func<Scalar> *u_ext[], Func<double> *v, 
+                       Geom<double> *e, Func<Scalar> **ext) const;
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v, 
+                  Geom<Ord> *e, Func<Ord> **ext) const;
+
+  VectorFormVol<Scalar>* clone() const;
+
+protected:
+  // Not owned, shared by the clones.
+  const MarkerCoefficientTable<Scalar>* table;
+};
+
+#endif
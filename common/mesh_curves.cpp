@@ -0,0 +1,160 @@
+#include "mesh_curves.h"
+
+#include <cstring>
+
+static void attach_to_elements(Mesh* mesh, Nurbs* nurbs, int v1, int v2)
+{
+  Node* en = mesh->peek_edge_node(v1, v2);
+  if(en == NULL)
+  {
+    delete [] nurbs->pt;
+    delete [] nurbs->kv;
+    delete nurbs;
+    throw Hermes::Exceptions::Exception("Curve #%d-%d does not match any edge of the mesh.", v1, v2);
+  }
+
+  for(unsigned int node_i = 0; node_i < 2; node_i++)
+  {
+    Element* e = en->elem[node_i];
+    if(e == NULL)
+      continue;
+
+    if(e->cm == NULL)
+    {
+      e->cm = new CurvMap;
+      memset(e->cm, 0, sizeof(CurvMap));
+      e->cm->toplevel = 1;
+      e->cm->order = 4;
+    }
+
+    int idx = -1;
+    for(unsigned int j = 0; j < e->get_nvert(); j++)
+      if(e->en[j] == en)
+      {
+        idx = j;
+        break;
+      }
+
+    if(e->vn[idx]->id == v1)
+    {
+      e->cm->nurbs[idx] = nurbs;
+      nurbs->ref++;
+    }
+    else
+    {
+      Nurbs* nurbs_rev = reverse_nurbs(nurbs);
+      e->cm->nurbs[idx] = nurbs_rev;
+      nurbs_rev->ref++;
+    }
+  }
+
+  if(nurbs->ref == 0)
+  {
+    delete [] nurbs->pt;
+    delete [] nurbs->kv;
+    delete nurbs;
+  }
+}
+
+void attach_arc(Mesh* mesh, int v1, int v2, double angle)
+{
+  Node* p1 = mesh->get_node(v1);
+  Node* p2 = mesh->get_node(v2);
+
+  // Circular arc: quadratic NURBS with one weighted control point.
+  Nurbs* nurbs = new Nurbs;
+  nurbs->twin = false;
+  nurbs->ref = 0;
+  nurbs->arc = true;
+  nurbs->angle = angle;
+  nurbs->degree = 2;
+  nurbs->np = 3;
+  nurbs->pt = new double3[3];
+  nurbs->pt[0][0] = p1->x; nurbs->pt[0][1] = p1->y; nurbs->pt[0][2] = 1.0;
+  nurbs->pt[2][0] = p2->x; nurbs->pt[2][1] = p2->y; nurbs->pt[2][2] = 1.0;
+
+  double a = (180.0 - angle) / 180.0 * M_PI;
+  double x = 1.0 / std::tan(a * 0.5);
+  nurbs->pt[1][0] = 0.5*((nurbs->pt[2][0] + nurbs->pt[0][0]) + (nurbs->pt[2][1] - nurbs->pt[0][1]) * x);
+  nurbs->pt[1][1] = 0.5*((nurbs->pt[2][1] + nurbs->pt[0][1]) - (nurbs->pt[2][0] - nurbs->pt[0][0]) * x);
+  nurbs->pt[1][2] = std::cos((M_PI - a) * 0.5);
+
+  nurbs->nk = 6;
+  nurbs->kv = new double[6];
+  for(int i = 0; i < 3; i++)
+  {
+    nurbs->kv[i] = 0.0;
+    nurbs->kv[i + 3] = 1.0;
+  }
+
+  attach_to_elements(mesh, nurbs, v1, v2);
+}
+
+void attach_nurbs(Mesh* mesh, int v1, int v2, int degree, int n_inner_points, const double* inner_points,
+                  int n_inner_knots, const double* inner_knots)
+{
+  Node* p1 = mesh->get_node(v1);
+  Node* p2 = mesh->get_node(v2);
+
+  // End points of the curve are the edge vertices.
+  Nurbs* nurbs = new Nurbs;
+  nurbs->twin = false;
+  nurbs->ref = 0;
+  nurbs->arc = false;
+  nurbs->angle = 0.0;
+  nurbs->degree = degree;
+  nurbs->np = n_inner_points + 2;
+  nurbs->pt = new double3[nurbs->np];
+  nurbs->pt[0][0] = p1->x; nurbs->pt[0][1] = p1->y; nurbs->pt[0][2] = 1.0;
+  for(int i = 0; i < n_inner_points; i++)
+    for(int k = 0; k < 3; k++)
+      nurbs->pt[i + 1][k] = inner_points[3*i + k];
+  nurbs->pt[nurbs->np - 1][0] = p2->x; nurbs->pt[nurbs->np - 1][1] = p2->y; nurbs->pt[nurbs->np - 1][2] = 1.0;
+
+  nurbs->nk = degree + 1 + n_inner_knots + degree + 1;
+  nurbs->kv = new double[nurbs->nk];
+  int k = 0;
+  for(int i = 0; i <= degree; i++)
+    nurbs->kv[k++] = 0.0;
+  for(int i = 0; i < n_inner_knots; i++)
+    nurbs->kv[k++] = inner_knots[i];
+  for(int i = 0; i <= degree; i++)
+    nurbs->kv[k++] = 1.0;
+
+  attach_to_elements(mesh, nurbs, v1, v2);
+}
+
+void finalize_curves(Mesh* mesh)
+{
+  Element* e;
+  for_all_base_elements(e, mesh)
+    if(e->cm != NULL)
+      e->cm->update_refmap_coeffs(e);
+}
+
+Nurbs* reverse_nurbs(Nurbs* nurbs)
+{
+  Nurbs* rev = new Nurbs;
+  *rev = *nurbs;
+  rev->twin = true;
+  rev->ref = 0;
+
+  rev->pt = new double3[nurbs->np];
+  for(int i = 0; i < nurbs->np; i++)
+  {
+    rev->pt[nurbs->np - 1 - i][0] = nurbs->pt[i][0];
+    rev->pt[nurbs->np - 1 - i][1] = nurbs->pt[i][1];
+    rev->pt[nurbs->np - 1 - i][2] = nurbs->pt[i][2];
+  }
+
+  rev->kv = new double[nurbs->nk];
+  for(int i = 0; i < nurbs->nk; i++)
+    rev->kv[i] = nurbs->kv[i];
+  for(int i = nurbs->degree + 1; i < nurbs->nk - nurbs->degree - 1; i++)
+    rev->kv[nurbs->nk - 1 - i] = 1.0 - nurbs->kv[i];
+
+  if(rev->arc)
+    rev->angle = -nurbs->angle;
+
+  return rev;
+}
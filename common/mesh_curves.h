@@ -0,0 +1,31 @@
+#ifndef __HERMES_TUTORIAL_MESH_CURVES_H
+#define __HERMES_TUTORIAL_MESH_CURVES_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Curved edges */
+
+// Helpers shared by the mesh readers in this directory that create the
+// mesh through Mesh::create() and attach curved edges afterwards.
+
+/// Creates a circular arc between the vertices v1 and v2 (central angle in
+/// degrees) and attaches it to the elements sharing the edge.
+void attach_arc(Mesh* mesh, int v1, int v2, double angle);
+
+/// Creates a NURBS curve between the vertices v1 and v2 and attaches it to the
+/// elements sharing the edge. The inner control points are given as
+/// (x, y, weight) triples, the knot vector only by its inner knots.
+void attach_nurbs(Mesh* mesh, int v1, int v2, int degree, int n_inner_points, const double* inner_points,
+                  int n_inner_knots, const double* inner_knots);
+
+/// Updates the reference map coefficients of all curved elements, to be called
+/// once after all curves were attached.
+void finalize_curves(Mesh* mesh);
+
+/// Returns a copy of the Nurbs with reversed orientation.
+Nurbs* reverse_nurbs(Nurbs* nurbs);
+
+#endif
@@ -0,0 +1,491 @@
+#include "mesh_reader_h2d_binary.h"
+#include "mesh_curves.h"
+
+#include <map>
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* Binary mesh view */
+
+namespace
+{
+  // Whether 'count' items of 'item_size' bytes at 'offset' (8-byte aligned)
+  // lie within a file of 'size' bytes.
+  bool section_fits(unsigned long long offset, unsigned long long count, unsigned long long item_size, unsigned long long size)
+  {
+    return offset % 8 == 0 && offset <= size && count * item_size <= size - offset;
+  }
+
+  // Whether all 'count' values are in [0, bound).
+  bool indices_valid(const int* values, unsigned long long count, unsigned int bound)
+  {
+    for(unsigned long long i = 0; i < count; i++)
+      if(values[i] < 0 || (unsigned int)values[i] >= bound)
+        return false;
+    return true;
+  }
+}
+
+MeshBinaryView::MeshBinaryView() : header(NULL), vertices(NULL), triangles(NULL), triangle_markers(NULL),
+  quads(NULL), quad_markers(NULL), boundaries(NULL), boundary_markers(NULL), curves(NULL), curve_data(NULL),
+  data(NULL), size(0)
+{
+#ifdef _WIN32
+  file_handle = NULL;
+  mapping_handle = NULL;
+#endif
+}
+
+MeshBinaryView::~MeshBinaryView()
+{
+  close();
+}
+
+void MeshBinaryView::open(const char *filename)
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(file == INVALID_HANDLE_VALUE)
+    throw Hermes::Exceptions::Exception("Could not open the binary mesh file %s.", filename);
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file, &file_size);
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(mapping == NULL)
+  {
+    CloseHandle(file);
+    throw Hermes::Exceptions::Exception("Could not map the binary mesh file %s.", filename);
+  }
+  this->file_handle = file;
+  this->mapping_handle = mapping;
+  this->size = (size_t)file_size.QuadPart;
+  this->data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+  int fd = ::open(filename, O_RDONLY);
+  if(fd < 0)
+    throw Hermes::Exceptions::Exception("Could not open the binary mesh file %s.", filename);
+  struct stat st;
+  if(fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    throw Hermes::Exceptions::Exception("Could not stat the binary mesh file %s.", filename);
+  }
+  this->size = (size_t)st.st_size;
+  void* mapped = this->size > 0 ? mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  this->data = (mapped == MAP_FAILED) ? NULL : (const char*)mapped;
+#endif
+
+  if(this->data == NULL)
+  {
+    close();
+    throw Hermes::Exceptions::Exception("Could not map the binary mesh file %s.", filename);
+  }
+
+  // Validate the header.
+  if(this->size < sizeof(MeshBinaryHeader))
+  {
+    close();
+    throw Hermes::Exceptions::Exception("The file %s is too short to be a binary mesh file.", filename);
+  }
+  this->header = (const MeshBinaryHeader*)this->data;
+  if(strncmp(this->header->magic, H2D_BINARY_MESH_MAGIC, 8) != 0)
+  {
+    close();
+    throw Hermes::Exceptions::Exception("The file %s is not a binary mesh file.", filename);
+  }
+  if(this->header->byte_order != H2D_BINARY_MESH_BYTE_ORDER)
+  {
+    close();
+    throw Hermes::Exceptions::Exception("The binary mesh file %s was written on a machine with different byte order.", filename);
+  }
+  if(this->header->version != H2D_BINARY_MESH_VERSION)
+  {
+    unsigned int version = this->header->version;
+    close();
+    throw Hermes::Exceptions::Exception("Unsupported binary mesh version %u in %s (expected %u).", version, filename, H2D_BINARY_MESH_VERSION);
+  }
+  if(this->header->file_size != this->size || this->header->markers_offset > this->size)
+  {
+    close();
+    throw Hermes::Exceptions::Exception("The binary mesh file %s is truncated.", filename);
+  }
+
+  // Set up the section pointers (no data is read here).
+  const MeshBinaryHeader* h = this->header;
+  this->vertices = (const double*)(this->data + h->vertices_offset);
+  this->triangles = (const int*)(this->data + h->triangles_offset);
+  this->triangle_markers = this->triangles + 3 * h->n_triangles;
+  this->quads = (const int*)(this->data + h->quads_offset);
+  this->quad_markers = this->quads + 4 * h->n_quads;
+  this->boundaries = (const int*)(this->data + h->boundaries_offset);
+  this->boundary_markers = this->boundaries + 2 * h->n_boundaries;
+  this->curves = (const MeshBinaryCurve*)(this->data + h->curves_offset);
+  this->curve_data = (const double*)(this->data + h->curve_data_offset);
+
+  const char* error = this->validate();
+  if(error != NULL)
+  {
+    close();
+    throw Hermes::Exceptions::Exception("The binary mesh file %s is corrupt (%s).", filename, error);
+  }
+}
+
+const char* MeshBinaryView::validate() const
+{
+  const MeshBinaryHeader* h = this->header;
+  unsigned long long size = this->size;
+
+  // Sections.
+  if(!section_fits(h->vertices_offset, 2ULL * h->n_vertices, sizeof(double), size))
+    return "vertices";
+  if(!section_fits(h->triangles_offset, 4ULL * h->n_triangles, sizeof(int), size))
+    return "triangles";
+  if(!section_fits(h->quads_offset, 5ULL * h->n_quads, sizeof(int), size))
+    return "quads";
+  if(!section_fits(h->boundaries_offset, 3ULL * h->n_boundaries, sizeof(int), size))
+    return "boundaries";
+  if(!section_fits(h->curves_offset, h->n_curves, sizeof(MeshBinaryCurve), size))
+    return "curves";
+  if(!section_fits(h->curve_data_offset, h->n_curve_data, sizeof(double), size))
+    return "curve data";
+  if(!section_fits(h->markers_offset, h->n_markers + 1ULL, sizeof(unsigned int), size))
+    return "marker offsets";
+
+  // Marker table: nondecreasing offsets, characters within the file.
+  const unsigned int* offsets = (const unsigned int*)(this->data + h->markers_offset);
+  if(offsets[0] != 0)
+    return "marker offsets";
+  for(unsigned int i = 0; i < h->n_markers; i++)
+    if(offsets[i + 1] < offsets[i])
+      return "marker offsets";
+  unsigned long long chars_offset = h->markers_offset + sizeof(unsigned int) * (h->n_markers + 1ULL);
+  if(offsets[h->n_markers] > size - chars_offset)
+    return "marker names";
+
+  // Vertex and marker indices.
+  if(!indices_valid(this->triangles, 3ULL * h->n_triangles, h->n_vertices))
+    return "triangle vertices";
+  if(!indices_valid(this->triangle_markers, h->n_triangles, h->n_markers))
+    return "triangle markers";
+  if(!indices_valid(this->quads, 4ULL * h->n_quads, h->n_vertices))
+    return "quad vertices";
+  if(!indices_valid(this->quad_markers, h->n_quads, h->n_markers))
+    return "quad markers";
+  if(!indices_valid(this->boundaries, 2ULL * h->n_boundaries, h->n_vertices))
+    return "boundary vertices";
+  if(!indices_valid(this->boundary_markers, h->n_boundaries, h->n_markers))
+    return "boundary markers";
+
+  // Curves: end vertices, and the NURBS data within the curve data section.
+  for(unsigned int i = 0; i < h->n_curves; i++)
+  {
+    const MeshBinaryCurve& curve = this->curves[i];
+    if(!indices_valid(&curve.v1, 1, h->n_vertices) || !indices_valid(&curve.v2, 1, h->n_vertices))
+      return "curve vertices";
+    if(curve.type == H2D_BINARY_CURVE_NURBS)
+    {
+      if(curve.degree < 1 || curve.n_inner_points < 0 || curve.n_inner_knots < 0 || curve.data_offset < 0)
+        return "curve";
+      if((unsigned long long)curve.data_offset + 3ULL * curve.n_inner_points + curve.n_inner_knots > h->n_curve_data)
+        return "curve data";
+    }
+    else if(curve.type != H2D_BINARY_CURVE_ARC)
+      return "curve type";
+  }
+
+  return NULL;
+}
+
+void MeshBinaryView::close()
+{
+  if(this->data != NULL)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(this->data);
+#else
+    munmap((void*)this->data, this->size);
+#endif
+  }
+#ifdef _WIN32
+  if(this->mapping_handle != NULL)
+    CloseHandle((HANDLE)this->mapping_handle);
+  if(this->file_handle != NULL)
+    CloseHandle((HANDLE)this->file_handle);
+  this->file_handle = NULL;
+  this->mapping_handle = NULL;
+#endif
+  this->data = NULL;
+  this->size = 0;
+  this->header = NULL;
+}
+
+std::string MeshBinaryView::get_marker(int marker_id) const
+{
+  if(marker_id < 0 || (unsigned int)marker_id >= this->header->n_markers)
+    throw Hermes::Exceptions::Exception("Invalid marker id %d in a binary mesh file.", marker_id);
+  const unsigned int* offsets = (const unsigned int*)(this->data + this->header->markers_offset);
+  const char* chars = (const char*)(offsets + this->header->n_markers + 1);
+  return std::string(chars + offsets[marker_id], offsets[marker_id + 1] - offsets[marker_id]);
+}
+
+/* Binary mesh reader */
+
+MeshReaderH2DBinary::MeshReaderH2DBinary()
+{
+}
+
+MeshReaderH2DBinary::~MeshReaderH2DBinary()
+{
+}
+
+bool MeshReaderH2DBinary::load(const char *filename, Mesh *mesh)
+{
+  if(mesh == NULL)
+    throw Hermes::Exceptions::NullException(1);
+
+  MeshBinaryView view;
+  view.open(filename);
+  const MeshBinaryHeader* h = view.header;
+
+  // Markers are stored once in the file, expand them for Mesh::create().
+  std::vector<std::string> markers(h->n_markers);
+  for(unsigned int i = 0; i < h->n_markers; i++)
+    markers[i] = view.get_marker(i);
+
+  std::string* tri_markers = new std::string[h->n_triangles + 1];
+  for(unsigned int i = 0; i < h->n_triangles; i++)
+    tri_markers[i] = markers[view.triangle_markers[i]];
+  std::string* quad_markers = new std::string[h->n_quads + 1];
+  for(unsigned int i = 0; i < h->n_quads; i++)
+    quad_markers[i] = markers[view.quad_markers[i]];
+  std::string* bdy_markers = new std::string[h->n_boundaries + 1];
+  for(unsigned int i = 0; i < h->n_boundaries; i++)
+    bdy_markers[i] = markers[view.boundary_markers[i]];
+
+  // Vertices and element connectivity are passed to the mesh directly from the mapping.
+  mesh->create(h->n_vertices, (double2*)view.vertices,
+    h->n_triangles, (int3*)view.triangles, tri_markers,
+    h->n_quads, (int4*)view.quads, quad_markers,
+    h->n_boundaries, (int2*)view.boundaries, bdy_markers);
+
+  delete [] tri_markers;
+  delete [] quad_markers;
+  delete [] bdy_markers;
+
+  // Curved edges.
+  if(h->n_curves > 0)
+  {
+    for(unsigned int i = 0; i < h->n_curves; i++)
+    {
+      const MeshBinaryCurve& curve = view.curves[i];
+      if(curve.type == H2D_BINARY_CURVE_ARC)
+        attach_arc(mesh, curve.v1, curve.v2, curve.angle);
+      else
+      {
+        const double* data = view.curve_data + curve.data_offset;
+        attach_nurbs(mesh, curve.v1, curve.v2, curve.degree, curve.n_inner_points, data,
+                     curve.n_inner_knots, data + 3 * curve.n_inner_points);
+      }
+    }
+    finalize_curves(mesh);
+  }
+
+  this->info("Binary mesh %s loaded (%u vertices, %u elements).", filename, h->n_vertices, h->n_triangles + h->n_quads);
+  return true;
+}
+
+/* Binary mesh writer */
+
+namespace
+{
+  // Pads the file with zeros to the next 8-byte boundary.
+  unsigned long long align_file(FILE* f, unsigned long long pos)
+  {
+    static const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    unsigned long long padding = (8 - pos % 8) % 8;
+    if(padding > 0)
+      fwrite(zeros, 1, (size_t)padding, f);
+    return pos + padding;
+  }
+
+  int marker_id(std::map<std::string, int>& marker_ids, std::vector<std::string>& marker_names, const std::string& marker)
+  {
+    std::map<std::string, int>::iterator it = marker_ids.find(marker);
+    if(it != marker_ids.end())
+      return it->second;
+    int id = (int)marker_names.size();
+    marker_ids.insert(std::pair<std::string, int>(marker, id));
+    marker_names.push_back(marker);
+    return id;
+  }
+}
+
+bool MeshReaderH2DBinary::save(const char *filename, Mesh *mesh)
+{
+  if(mesh == NULL)
+    throw Hermes::Exceptions::NullException(2);
+
+  std::map<std::string, int> marker_ids;
+  std::vector<std::string> marker_names;
+
+  // Vertices: compact numbering of the vertex nodes.
+  std::map<int, int> vertex_index;
+  std::vector<double> vertices;
+  Node* n;
+  for_all_vertex_nodes(n, mesh)
+  {
+    vertex_index.insert(std::pair<int, int>(n->id, (int)(vertices.size() / 2)));
+    vertices.push_back(n->x);
+    vertices.push_back(n->y);
+  }
+
+  // Base elements, boundary edges and curves.
+  std::vector<int> triangles, triangle_markers, quads, quad_markers, boundaries, boundary_markers;
+  std::vector<MeshBinaryCurve> curves;
+  std::vector<double> curve_data;
+  std::map<int, bool> edge_done, curve_done;
+  Element* e;
+  for_all_base_elements(e, mesh)
+  {
+    int marker = marker_id(marker_ids, marker_names, mesh->get_element_markers_conversion().get_user_marker(e->marker).marker);
+    if(e->is_triangle())
+    {
+      for(int i = 0; i < 3; i++)
+        triangles.push_back(vertex_index[e->vn[i]->id]);
+      triangle_markers.push_back(marker);
+    }
+    else
+    {
+      for(int i = 0; i < 4; i++)
+        quads.push_back(vertex_index[e->vn[i]->id]);
+      quad_markers.push_back(marker);
+    }
+
+    for(unsigned int i = 0; i < e->get_nvert(); i++)
+    {
+      Node* en = e->en[i];
+      int v1 = vertex_index[e->vn[i]->id];
+      int v2 = vertex_index[e->vn[e->next_vert(i)]->id];
+
+      if(en->bnd && edge_done.find(en->id) == edge_done.end())
+      {
+        edge_done[en->id] = true;
+        boundaries.push_back(v1);
+        boundaries.push_back(v2);
+        boundary_markers.push_back(marker_id(marker_ids, marker_names, mesh->get_boundary_markers_conversion().get_user_marker(en->marker).marker));
+      }
+
+      if(e->cm != NULL && e->cm->nurbs[i] != NULL && curve_done.find(en->id) == curve_done.end())
+      {
+        curve_done[en->id] = true;
+        Nurbs* nurbs = e->cm->nurbs[i];
+        MeshBinaryCurve curve;
+        memset(&curve, 0, sizeof(MeshBinaryCurve));
+        curve.v1 = v1;
+        curve.v2 = v2;
+        curve.degree = nurbs->degree;
+        if(nurbs->arc)
+        {
+          curve.type = H2D_BINARY_CURVE_ARC;
+          curve.angle = nurbs->angle;
+        }
+        else
+        {
+          curve.type = H2D_BINARY_CURVE_NURBS;
+          curve.n_inner_points = nurbs->np - 2;
+          curve.n_inner_knots = nurbs->nk - 2 * (nurbs->degree + 1);
+          curve.data_offset = (int)curve_data.size();
+          for(int j = 1; j < nurbs->np - 1; j++)
+            for(int k = 0; k < 3; k++)
+              curve_data.push_back(nurbs->pt[j][k]);
+          for(int j = nurbs->degree + 1; j < nurbs->nk - nurbs->degree - 1; j++)
+            curve_data.push_back(nurbs->kv[j]);
+        }
+        curves.push_back(curve);
+      }
+    }
+  }
+
+  FILE* f = fopen(filename, "wb");
+  if(f == NULL)
+    throw Hermes::Exceptions::Exception("Could not create the binary mesh file %s.", filename);
+
+  MeshBinaryHeader h;
+  memset(&h, 0, sizeof(MeshBinaryHeader));
+  strncpy(h.magic, H2D_BINARY_MESH_MAGIC, 8);
+  h.version = H2D_BINARY_MESH_VERSION;
+  h.byte_order = H2D_BINARY_MESH_BYTE_ORDER;
+  h.n_vertices = (unsigned int)(vertices.size() / 2);
+  h.n_triangles = (unsigned int)triangle_markers.size();
+  h.n_quads = (unsigned int)quad_markers.size();
+  h.n_boundaries = (unsigned int)boundary_markers.size();
+  h.n_curves = (unsigned int)curves.size();
+  h.n_curve_data = (unsigned int)curve_data.size();
+  h.n_markers = (unsigned int)marker_names.size();
+
+  // The header is written twice, the second time with the final offsets.
+  fwrite(&h, sizeof(MeshBinaryHeader), 1, f);
+  unsigned long long pos = align_file(f, sizeof(MeshBinaryHeader));
+
+#define WRITE_SECTION(offset, vec) \
+  offset = pos; \
+  if(!vec.empty()) \
+    fwrite(&vec[0], sizeof(vec[0]), vec.size(), f); \
+  pos = align_file(f, pos + sizeof(vec[0]) * vec.size());
+
+  WRITE_SECTION(h.vertices_offset, vertices);
+  h.triangles_offset = pos;
+  if(!triangles.empty())
+    fwrite(&triangles[0], sizeof(int), triangles.size(), f);
+  if(!triangle_markers.empty())
+    fwrite(&triangle_markers[0], sizeof(int), triangle_markers.size(), f);
+  pos = align_file(f, pos + sizeof(int) * (triangles.size() + triangle_markers.size()));
+  h.quads_offset = pos;
+  if(!quads.empty())
+    fwrite(&quads[0], sizeof(int), quads.size(), f);
+  if(!quad_markers.empty())
+    fwrite(&quad_markers[0], sizeof(int), quad_markers.size(), f);
+  pos = align_file(f, pos + sizeof(int) * (quads.size() + quad_markers.size()));
+  h.boundaries_offset = pos;
+  if(!boundaries.empty())
+    fwrite(&boundaries[0], sizeof(int), boundaries.size(), f);
+  if(!boundary_markers.empty())
+    fwrite(&boundary_markers[0], sizeof(int), boundary_markers.size(), f);
+  pos = align_file(f, pos + sizeof(int) * (boundaries.size() + boundary_markers.size()));
+  WRITE_SECTION(h.curves_offset, curves);
+  WRITE_SECTION(h.curve_data_offset, curve_data);
+#undef WRITE_SECTION
+
+  // Marker table.
+  h.markers_offset = pos;
+  std::vector<unsigned int> offsets(marker_names.size() + 1, 0);
+  for(unsigned int i = 0; i < marker_names.size(); i++)
+    offsets[i + 1] = offsets[i] + (unsigned int)marker_names[i].length();
+  fwrite(&offsets[0], sizeof(unsigned int), offsets.size(), f);
+  for(unsigned int i = 0; i < marker_names.size(); i++)
+    fwrite(marker_names[i].c_str(), 1, marker_names[i].length(), f);
+  pos = align_file(f, pos + sizeof(unsigned int) * offsets.size() + offsets.back());
+  h.file_size = pos;
+
+  fseek(f, 0, SEEK_SET);
+  fwrite(&h, sizeof(MeshBinaryHeader), 1, f);
+  bool ok = (ferror(f) == 0);
+  fclose(f);
+  if(!ok)
+    throw Hermes::Exceptions::Exception("Could not write the binary mesh file %s.", filename);
+
+  this->info("Binary mesh %s saved (%u vertices, %u elements, %u curves).", filename, h.n_vertices, h.n_triangles + h.n_quads, h.n_curves);
+  return true;
+}
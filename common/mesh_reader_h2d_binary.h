@@ -0,0 +1,134 @@
+#ifndef __HERMES_TUTORIAL_MESH_READER_H2D_BINARY_H
+#define __HERMES_TUTORIAL_MESH_READER_H2D_BINARY_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Binary mesh container */
+
+// Layout of a binary mesh file (all integers little-endian, all sections
+// 8-byte aligned so that they can be used in place after mmap()):
+//
+//   header      MeshBinaryHeader
+//   vertices    double[n_vertices][2]
+//   triangles   int[n_triangles][3], followed by int[n_triangles] marker ids
+//   quads       int[n_quads][4], followed by int[n_quads] marker ids
+//   boundaries  int[n_boundaries][2], followed by int[n_boundaries] marker ids
+//   curves      MeshBinaryCurve[n_curves]
+//   curve data  double[n_curve_data] (NURBS inner points (x, y, w) and knots)
+//   markers     unsigned int[n_markers + 1] offsets, followed by the characters
+//
+// Symbolic <variables> of the XML format are resolved by the converter, so the
+// file only contains numbers. Marker ids index into the shared marker table.
+
+#define H2D_BINARY_MESH_MAGIC "H2DMESH"
+#define H2D_BINARY_MESH_VERSION 1
+#define H2D_BINARY_MESH_BYTE_ORDER 0x01020304
+
+struct MeshBinaryHeader
+{
+  char magic[8];
+  unsigned int version;
+  unsigned int byte_order;
+
+  unsigned int n_vertices;
+  unsigned int n_triangles;
+  unsigned int n_quads;
+  unsigned int n_boundaries;
+  unsigned int n_curves;
+  unsigned int n_curve_data;
+  unsigned int n_markers;
+  unsigned int reserved;
+
+  // Section offsets in bytes from the beginning of the file.
+  unsigned long long vertices_offset;
+  unsigned long long triangles_offset;
+  unsigned long long quads_offset;
+  unsigned long long boundaries_offset;
+  unsigned long long curves_offset;
+  unsigned long long curve_data_offset;
+  unsigned long long markers_offset;
+  unsigned long long file_size;
+};
+
+enum MeshBinaryCurveType
+{
+  H2D_BINARY_CURVE_ARC = 0,
+  H2D_BINARY_CURVE_NURBS = 1
+};
+
+struct MeshBinaryCurve
+{
+  int v1, v2;
+  int type;
+  int degree;
+  // Number of inner control points and inner knots (NURBS only).
+  int n_inner_points;
+  int n_inner_knots;
+  // Index of the first value of this curve in the curve data section.
+  int data_offset;
+  int reserved;
+  // Central angle in degrees (arcs only).
+  double angle;
+};
+
+/// Read-only view of a binary mesh file. All pointers point directly into
+/// the mapped file, nothing is copied.
+class MeshBinaryView
+{
+public:
+  MeshBinaryView();
+  ~MeshBinaryView();
+
+  /// Maps the file into memory and validates it: the header, all sections
+  /// against the file size, and all vertex, marker and curve data indices
+  /// against their tables.
+  void open(const char *filename);
+  /// Unmaps the file.
+  void close();
+
+  const MeshBinaryHeader* header;
+  const double* vertices;
+  const int* triangles;
+  const int* triangle_markers;
+  const int* quads;
+  const int* quad_markers;
+  const int* boundaries;
+  const int* boundary_markers;
+  const MeshBinaryCurve* curves;
+  const double* curve_data;
+
+  /// Marker name for a marker id.
+  std::string get_marker(int marker_id) const;
+
+protected:
+  /// The name of the first invalid part of the mapped file, NULL if valid.
+  const char* validate() const;
+
+  const char* data;
+  size_t size;
+#ifdef _WIN32
+  void* file_handle;
+  void* mapping_handle;
+#endif
+};
+
+/// Reader / writer of the binary mesh format, used in the same way as
+/// MeshReaderH2D and MeshReaderH2DXML.
+class MeshReaderH2DBinary : public Hermes::Mixins::Loggable
+{
+public:
+  MeshReaderH2DBinary();
+  virtual ~MeshReaderH2DBinary();
+
+  /// Loads the mesh from a binary mesh file.
+  virtual bool load(const char *filename, Mesh *mesh);
+
+  /// Saves the base elements of the mesh (including boundary markers and curves)
+  /// into a binary mesh file.
+  virtual bool save(const char *filename, Mesh *mesh);
+};
+
+#endif
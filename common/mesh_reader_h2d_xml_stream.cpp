@@ -0,0 +1,472 @@
+#include "mesh_reader_h2d_xml_stream.h"
+#include "mesh_curves.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+// Size of the chunks the file is read in.
+static const size_t XML_STREAM_CHUNK_SIZE = 1 << 16;
+
+MeshReaderH2DXMLStream::MeshReaderH2DXMLStream() : file(NULL), buffer_pos(0), buffer_len(0),
+  parallel_number_parsing(false), batch_size(65536)
+{
+}
+
+MeshReaderH2DXMLStream::~MeshReaderH2DXMLStream()
+{
+  clear();
+}
+
+void MeshReaderH2DXMLStream::set_parallel_number_parsing(bool parallel, int batch_size)
+{
+  this->parallel_number_parsing = parallel;
+  this->batch_size = batch_size > 0 ? batch_size : 1;
+}
+
+void MeshReaderH2DXMLStream::clear()
+{
+  if(this->file != NULL)
+    fclose(this->file);
+  this->file = NULL;
+  this->buffer.clear();
+  this->buffer_pos = this->buffer_len = 0;
+  this->variables.clear();
+  this->vertices.clear();
+  this->vertex_defined.clear();
+  this->pending_index.clear();
+  this->pending_x.clear();
+  this->pending_y.clear();
+  this->triangles.clear();
+  this->triangle_markers.clear();
+  this->quads.clear();
+  this->quad_markers.clear();
+  this->boundaries.clear();
+  this->boundary_markers.clear();
+  this->marker_ids.clear();
+  this->marker_names.clear();
+  this->curves.clear();
+  this->refinements.clear();
+}
+
+const std::string& MeshReaderH2DXMLStream::Tag::get(const char* name, const char* alt_name) const
+{
+  std::map<std::string, std::string>::const_iterator it = this->attributes.find(name);
+  if(it == this->attributes.end() && alt_name != NULL)
+    it = this->attributes.find(alt_name);
+  if(it == this->attributes.end())
+    throw Hermes::Exceptions::Exception("Missing attribute '%s' in the tag <%s>.", name, this->name.c_str());
+  return it->second;
+}
+
+bool MeshReaderH2DXMLStream::next_char(char& c)
+{
+  if(this->buffer_pos == this->buffer_len)
+  {
+    this->buffer_len = fread(&this->buffer[0], 1, this->buffer.size(), this->file);
+    this->buffer_pos = 0;
+    if(this->buffer_len == 0)
+      return false;
+  }
+  c = this->buffer[this->buffer_pos++];
+  return true;
+}
+
+void MeshReaderH2DXMLStream::skip_until(const char* end)
+{
+  size_t len = strlen(end), matched = 0;
+  char c;
+  while(matched < len && next_char(c))
+  {
+    if(c == end[matched])
+      matched++;
+    else
+      matched = (c == end[0]) ? 1 : 0;
+  }
+}
+
+bool MeshReaderH2DXMLStream::next_tag(Tag& tag)
+{
+  char c;
+  while(true)
+  {
+    // Skip text up to the next tag.
+    do
+    {
+      if(!next_char(c))
+        return false;
+    }
+    while(c != '<');
+
+    if(!next_char(c))
+      return false;
+
+    if(c == '?')
+    {
+      skip_until("?>");
+      continue;
+    }
+    if(c == '!')
+    {
+      // Comment or declaration.
+      char c2;
+      if(next_char(c2) && c2 == '-')
+        skip_until("-->");
+      else
+        skip_until(">");
+      continue;
+    }
+    break;
+  }
+
+  tag.name.clear();
+  tag.attributes.clear();
+  tag.self_closing = false;
+  tag.end_tag = (c == '/');
+  if(tag.end_tag && !next_char(c))
+    return false;
+
+  // Tag name without the namespace prefix.
+  while(!isspace((unsigned char)c) && c != '>' && c != '/')
+  {
+    if(c == ':')
+      tag.name.clear();
+    else
+      tag.name += c;
+    if(!next_char(c))
+      return false;
+  }
+
+  // Attributes.
+  std::string attr_name, attr_value;
+  while(true)
+  {
+    while(isspace((unsigned char)c))
+      if(!next_char(c))
+        return false;
+
+    if(c == '>')
+      return true;
+    if(c == '/')
+    {
+      tag.self_closing = true;
+      skip_until(">");
+      return true;
+    }
+
+    attr_name.clear();
+    while(c != '=' && !isspace((unsigned char)c))
+    {
+      attr_name += c;
+      if(!next_char(c))
+        return false;
+    }
+    while(c != '"' && c != '\'')
+      if(!next_char(c))
+        return false;
+
+    char quote = c;
+    attr_value.clear();
+    while(next_char(c) && c != quote)
+      attr_value += c;
+
+    // Namespace declarations etc. are stored as well, they are simply never asked for.
+    tag.attributes[attr_name] = attr_value;
+
+    if(!next_char(c))
+      return false;
+  }
+}
+
+double MeshReaderH2DXMLStream::parse_value(const std::string& str) const
+{
+  std::map<std::string, double>::const_iterator it = this->variables.find(str);
+  if(it != this->variables.end())
+    return it->second;
+
+  const char* s = str.c_str();
+  char* end;
+  double value = strtod(s, &end);
+  while(isspace((unsigned char)*end))
+    end++;
+  if(end != s && *end == '\0')
+    return value;
+
+  // Spellings of zero that strtod() does not accept, "." or "-.": an optional
+  // sign, then a single dot and zeros only.
+  size_t first = str.find_first_not_of(" \t\r\n");
+  size_t last = str.find_last_not_of(" \t\r\n");
+  if(first != std::string::npos)
+  {
+    if(str[first] == '-' || str[first] == '+')
+      first++;
+    int dots = 0;
+    bool zero = first <= last;
+    for(size_t i = first; zero && i <= last; i++)
+    {
+      if(str[i] == '.')
+        dots++;
+      else if(str[i] != '0')
+        zero = false;
+    }
+    if(zero && dots == 1)
+      return 0.0;
+  }
+
+  throw Hermes::Exceptions::Exception("Could not convert '%s' to a number (undefined variable?).", str.c_str());
+}
+
+int MeshReaderH2DXMLStream::parse_int(const std::string& str) const
+{
+  const char* s = str.c_str();
+  char* end;
+  long value = strtol(s, &end, 10);
+  if(end == s)
+    throw Hermes::Exceptions::Exception("Could not convert '%s' to an integer.", s);
+  return (int)value;
+}
+
+int MeshReaderH2DXMLStream::marker_id(const std::string& marker)
+{
+  std::map<std::string, int>::iterator it = this->marker_ids.find(marker);
+  if(it != this->marker_ids.end())
+    return it->second;
+  int id = (int)this->marker_names.size();
+  this->marker_ids.insert(std::pair<std::string, int>(marker, id));
+  this->marker_names.push_back(marker);
+  return id;
+}
+
+void MeshReaderH2DXMLStream::flush_vertices()
+{
+  int count = (int)this->pending_index.size();
+  if(count == 0)
+    return;
+
+  int max_index = -1;
+  for(int i = 0; i < count; i++)
+    if(this->pending_index[i] > max_index)
+      max_index = this->pending_index[i];
+  if(max_index >= (int)this->vertex_defined.size())
+  {
+    this->vertices.resize(2 * (max_index + 1), 0.0);
+    this->vertex_defined.resize(max_index + 1, 0);
+  }
+
+  // Exceptions must not leave an OpenMP region, errors are collected instead.
+  int failed = -1;
+#pragma omp parallel for if(parallel_number_parsing) schedule(static)
+  for(int i = 0; i < count; i++)
+  {
+    try
+    {
+      int idx = this->pending_index[i];
+      this->vertices[2 * idx] = parse_value(this->pending_x[i]);
+      this->vertices[2 * idx + 1] = parse_value(this->pending_y[i]);
+      this->vertex_defined[idx] = 1;
+    }
+    catch(Hermes::Exceptions::Exception&)
+    {
+#pragma omp critical (xml_stream_failed)
+      failed = i;
+    }
+  }
+
+  if(failed >= 0)
+    throw Hermes::Exceptions::Exception("Invalid coordinates of vertex %d: '%s', '%s'.", this->pending_index[failed],
+      this->pending_x[failed].c_str(), this->pending_y[failed].c_str());
+
+  this->pending_index.clear();
+  this->pending_x.clear();
+  this->pending_y.clear();
+}
+
+bool MeshReaderH2DXMLStream::load(const char *filename, Mesh *mesh)
+{
+  if(mesh == NULL)
+    throw Hermes::Exceptions::NullException(1);
+
+  clear();
+  this->file = fopen(filename, "rb");
+  if(this->file == NULL)
+    throw Hermes::Exceptions::Exception("Could not open the mesh file %s.", filename);
+  this->buffer.resize(XML_STREAM_CHUNK_SIZE);
+
+  try
+  {
+    Tag tag;
+    // Index of the open <NURBS> in 'curves' (its inner points and knots
+    // follow), -1 if there is none.
+    int nurbs = -1;
+    while(next_tag(tag))
+    {
+      if(tag.end_tag)
+      {
+        if(tag.name == "vertices")
+          flush_vertices();
+        else if(tag.name == "NURBS")
+          nurbs = -1;
+        continue;
+      }
+
+      const std::string& name = tag.name;
+      if(name == "var" || name == "variable")
+        this->variables[tag.get("name")] = parse_value(tag.get("value"));
+      else if(name == "v" || name == "vertex")
+      {
+        this->pending_index.push_back(parse_int(tag.get("i")));
+        this->pending_x.push_back(tag.get("x"));
+        this->pending_y.push_back(tag.get("y"));
+        if((int)this->pending_index.size() >= this->batch_size)
+          flush_vertices();
+      }
+      else if(name == "t" || name == "triangle")
+      {
+        this->triangles.push_back(parse_int(tag.get("v1")));
+        this->triangles.push_back(parse_int(tag.get("v2")));
+        this->triangles.push_back(parse_int(tag.get("v3")));
+        this->triangle_markers.push_back(marker_id(tag.get("m", "marker")));
+      }
+      else if(name == "q" || name == "quad")
+      {
+        this->quads.push_back(parse_int(tag.get("v1")));
+        this->quads.push_back(parse_int(tag.get("v2")));
+        this->quads.push_back(parse_int(tag.get("v3")));
+        this->quads.push_back(parse_int(tag.get("v4")));
+        this->quad_markers.push_back(marker_id(tag.get("m", "marker")));
+      }
+      else if(name == "ed" || name == "edge")
+      {
+        this->boundaries.push_back(parse_int(tag.get("v1")));
+        this->boundaries.push_back(parse_int(tag.get("v2")));
+        this->boundary_markers.push_back(marker_id(tag.get("m", "marker")));
+      }
+      else if(name == "arc")
+      {
+        CurveData curve;
+        curve.v1 = parse_int(tag.get("v1"));
+        curve.v2 = parse_int(tag.get("v2"));
+        curve.arc = true;
+        curve.angle = parse_value(tag.get("angle", "a"));
+        curve.degree = 2;
+        this->curves.push_back(curve);
+      }
+      else if(name == "NURBS")
+      {
+        CurveData curve;
+        curve.v1 = parse_int(tag.get("v1"));
+        curve.v2 = parse_int(tag.get("v2"));
+        curve.arc = false;
+        curve.angle = 0.0;
+        curve.degree = parse_int(tag.get("degree", "deg"));
+        this->curves.push_back(curve);
+        nurbs = tag.self_closing ? -1 : (int)this->curves.size() - 1;
+      }
+      else if(name == "inner_point" && nurbs >= 0)
+      {
+        std::vector<double>& inner_points = this->curves[nurbs].inner_points;
+        inner_points.push_back(parse_value(tag.get("x")));
+        inner_points.push_back(parse_value(tag.get("y")));
+        inner_points.push_back(parse_value(tag.get("weight")));
+      }
+      else if(name == "knot" && nurbs >= 0)
+        this->curves[nurbs].inner_knots.push_back(parse_value(tag.get("value")));
+      else if(name == "refinement" || name == "ref")
+      {
+        this->refinements.push_back(parse_int(tag.get("element_id")));
+        this->refinements.push_back(parse_int(tag.get("refinement_type")));
+      }
+    }
+    flush_vertices();
+
+    fclose(this->file);
+    this->file = NULL;
+    this->buffer.clear();
+
+    create_mesh(mesh);
+  }
+  catch(Hermes::Exceptions::Exception&)
+  {
+    clear();
+    throw;
+  }
+
+  this->info("Mesh %s streamed (%d vertices, %d elements).", filename, (int)this->vertex_defined.size(),
+    (int)(this->triangle_markers.size() + this->quad_markers.size()));
+  clear();
+  return true;
+}
+
+void MeshReaderH2DXMLStream::check_indices(const std::vector<int>& indices, int count, const char* what, int per_item)
+{
+  for(unsigned int i = 0; i < indices.size(); i++)
+    if(indices[i] < 0 || indices[i] >= count)
+      throw Hermes::Exceptions::Exception("The %s %d refers to the index %d, valid are 0..%d.", what, (int)i / per_item,
+        indices[i], count - 1);
+}
+
+void MeshReaderH2DXMLStream::create_mesh(Mesh* mesh)
+{
+  int nv = (int)this->vertex_defined.size();
+  for(int i = 0; i < nv; i++)
+    if(!this->vertex_defined[i])
+      throw Hermes::Exceptions::Exception("Vertex %d is not defined in the mesh file.", i);
+
+  int nt = (int)this->triangle_markers.size();
+  int nq = (int)this->quad_markers.size();
+  int nm = (int)this->boundary_markers.size();
+
+  // Mesh::create() does not check the indices, a bad file would corrupt memory.
+  check_indices(this->triangles, nv, "triangle", 3);
+  check_indices(this->quads, nv, "quad", 4);
+  check_indices(this->boundaries, nv, "boundary edge", 2);
+  check_indices(this->triangle_markers, (int)this->marker_names.size(), "triangle marker", 1);
+  check_indices(this->quad_markers, (int)this->marker_names.size(), "quad marker", 1);
+  check_indices(this->boundary_markers, (int)this->marker_names.size(), "boundary marker", 1);
+  for(unsigned int i = 0; i < this->curves.size(); i++)
+  {
+    const CurveData& curve = this->curves[i];
+    if(curve.v1 < 0 || curve.v1 >= nv || curve.v2 < 0 || curve.v2 >= nv)
+      throw Hermes::Exceptions::Exception("Curve %d refers to the vertices %d, %d, the mesh has %d.", (int)i, curve.v1, curve.v2, nv);
+  }
+
+  std::string* tri_markers = new std::string[nt + 1];
+  for(int i = 0; i < nt; i++)
+    tri_markers[i] = this->marker_names[this->triangle_markers[i]];
+  std::string* quad_markers = new std::string[nq + 1];
+  for(int i = 0; i < nq; i++)
+    quad_markers[i] = this->marker_names[this->quad_markers[i]];
+  std::string* bdy_markers = new std::string[nm + 1];
+  for(int i = 0; i < nm; i++)
+    bdy_markers[i] = this->marker_names[this->boundary_markers[i]];
+
+  // The vectors are contiguous, so they are handed over without copying.
+  mesh->create(nv, nv ? (double2*)&this->vertices[0] : NULL,
+    nt, nt ? (int3*)&this->triangles[0] : NULL, tri_markers,
+    nq, nq ? (int4*)&this->quads[0] : NULL, quad_markers,
+    nm, nm ? (int2*)&this->boundaries[0] : NULL, bdy_markers);
+
+  delete [] tri_markers;
+  delete [] quad_markers;
+  delete [] bdy_markers;
+
+  // Curved edges.
+  if(!this->curves.empty())
+  {
+    for(unsigned int i = 0; i < this->curves.size(); i++)
+    {
+      const CurveData& curve = this->curves[i];
+      if(curve.arc)
+        attach_arc(mesh, curve.v1, curve.v2, curve.angle);
+      else
+        attach_nurbs(mesh, curve.v1, curve.v2, curve.degree,
+          (int)curve.inner_points.size() / 3, curve.inner_points.empty() ? NULL : &curve.inner_points[0],
+          (int)curve.inner_knots.size(), curve.inner_knots.empty() ? NULL : &curve.inner_knots[0]);
+    }
+    finalize_curves(mesh);
+  }
+
+  // Refinements stored in the file.
+  for(unsigned int i = 0; i < this->refinements.size(); i += 2)
+    mesh->refine_element_id(this->refinements[i], this->refinements[i + 1]);
+}
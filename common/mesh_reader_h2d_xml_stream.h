@@ -0,0 +1,117 @@
+#ifndef __HERMES_TUTORIAL_MESH_READER_H2D_XML_STREAM_H
+#define __HERMES_TUTORIAL_MESH_READER_H2D_XML_STREAM_H
+
+#include "hermes2d.h"
+
+#include <map>
+#include <cstdio>
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Streaming XML mesh reader */
+
+// Reads the same files as MeshReaderH2DXML, but instead of building the
+// whole document tree first, it scans the file in fixed-size chunks and
+// processes every tag as soon as it is complete. Symbolic <variables> are
+// resolved on the fly, so the memory used is proportional to the vertex and
+// element tables and independent of the size of the document. No validation
+// against the schema is performed.
+//
+// Both the short (<v>, <t>, <q>, <ed>, <var>) and the long (<vertex>,
+// <triangle>, <quad>, <edge>, <variable>) tag names are accepted.
+
+class MeshReaderH2DXMLStream : public Hermes::Mixins::Loggable
+{
+public:
+  MeshReaderH2DXMLStream();
+  virtual ~MeshReaderH2DXMLStream();
+
+  /// Loads the mesh from an XML mesh file.
+  virtual bool load(const char *filename, Mesh *mesh);
+
+  /// Parse the coordinates of the vertex block in parallel (OpenMP).
+  /// Vertex attributes are collected in batches of 'batch_size' vertices,
+  /// each batch is converted to numbers by all threads.
+  void set_parallel_number_parsing(bool parallel, int batch_size = 65536);
+
+protected:
+  /// One start tag with its attributes.
+  struct Tag
+  {
+    std::string name;
+    bool self_closing;
+    bool end_tag;
+    std::map<std::string, std::string> attributes;
+
+    /// Attribute value, also looks for the alternative (long) attribute name.
+    const std::string& get(const char* name, const char* alt_name = NULL) const;
+  };
+
+  /// Buffered reading of the file.
+  bool next_char(char& c);
+  /// Reads the next tag, skipping text, comments and processing instructions.
+  /// Returns false at the end of the file.
+  bool next_tag(Tag& tag);
+  /// Skips input until the string 'end' was read.
+  void skip_until(const char* end);
+
+  /// Converts a coordinate (a number or a variable name) to a double.
+  double parse_value(const std::string& str) const;
+  /// Converts an integer attribute.
+  int parse_int(const std::string& str) const;
+  /// Marker id in the marker table.
+  int marker_id(const std::string& marker);
+
+  /// Converts the pending vertex batch to numbers.
+  void flush_vertices();
+
+  /// Throws unless all 'indices' are in [0, count), 'per_item' indices
+  /// belong to one item (for the message).
+  static void check_indices(const std::vector<int>& indices, int count, const char* what, int per_item);
+
+  /// Applies the collected data to the mesh.
+  void create_mesh(Mesh* mesh);
+
+  void clear();
+
+  // Input.
+  FILE* file;
+  std::vector<char> buffer;
+  size_t buffer_pos, buffer_len;
+
+  // Settings.
+  bool parallel_number_parsing;
+  int batch_size;
+
+  // Resolved variables.
+  std::map<std::string, double> variables;
+
+  // Vertices (x, y by vertex index) and the pending batch of unparsed ones.
+  std::vector<double> vertices;
+  std::vector<int> vertex_defined;
+  std::vector<int> pending_index;
+  std::vector<std::string> pending_x, pending_y;
+
+  // Elements, boundaries and markers.
+  std::vector<int> triangles, triangle_markers, quads, quad_markers, boundaries, boundary_markers;
+  std::map<std::string, int> marker_ids;
+  std::vector<std::string> marker_names;
+
+  // Curves: (v1, v2, angle) for arcs, general NURBS data separately.
+  struct CurveData
+  {
+    int v1, v2;
+    bool arc;
+    double angle;
+    int degree;
+    std::vector<double> inner_points;
+    std::vector<double> inner_knots;
+  };
+  std::vector<CurveData> curves;
+
+  // Refinements (element id, refinement type).
+  std::vector<int> refinements;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "mesh_refinement_plan.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+MeshRefinementPlan::MeshRefinementPlan() : uniform_levels(0), uniform_refinement(0)
+{
+}
+
+void MeshRefinementPlan::add_uniform(int levels, int refinement)
+{
+  if(this->uniform_levels > 0 && refinement != this->uniform_refinement)
+    throw Hermes::Exceptions::Exception("All uniform refinements in a MeshRefinementPlan must be of the same type.");
+  this->uniform_levels += levels;
+  this->uniform_refinement = refinement;
+}
+
+void MeshRefinementPlan::add_towards_vertex(int vertex_id, int depth)
+{
+  VertexRefinement r;
+  r.vertex_id = vertex_id;
+  r.depth = depth;
+  this->vertex_refinements.push_back(r);
+}
+
+void MeshRefinementPlan::add_towards_boundary(std::string marker, int depth, bool aniso)
+{
+  BoundaryRefinement r;
+  r.marker = marker;
+  r.depth = depth;
+  r.aniso = aniso;
+  this->boundary_refinements.push_back(r);
+}
+
+void MeshRefinementPlan::add_element(int element_id, int refinement)
+{
+  this->element_refinements.push_back(element_id);
+  this->element_refinements.push_back(refinement);
+}
+
+void MeshRefinementPlan::clear()
+{
+  this->uniform_levels = 0;
+  this->uniform_refinement = 0;
+  this->vertex_refinements.clear();
+  this->boundary_refinements.clear();
+  this->element_refinements.clear();
+}
+
+int MeshRefinementPlan::get_local_refinement(Element* e, int sweep, const std::vector<std::vector<char> >& boundary_vertices) const
+{
+  // Requested refinements are combined: isotropic wins, two different
+  // anisotropic refinements give an isotropic one.
+  int result = -1;
+
+  for(unsigned int i = 0; i < this->vertex_refinements.size(); i++)
+  {
+    if(sweep >= this->vertex_refinements[i].depth)
+      continue;
+    for(unsigned int j = 0; j < e->get_nvert(); j++)
+      if(e->vn[j]->id == this->vertex_refinements[i].vertex_id)
+        return 0;
+  }
+
+  for(unsigned int i = 0; i < this->boundary_refinements.size(); i++)
+  {
+    const BoundaryRefinement& r = this->boundary_refinements[i];
+    if(sweep >= r.depth)
+      continue;
+
+    // Same criterion as Mesh::refine_towards_boundary(): elements with
+    // a vertex on the boundary are refined.
+    const std::vector<char>& on_bdy = boundary_vertices[i];
+    bool any = false;
+    for(unsigned int j = 0; j < e->get_nvert(); j++)
+      if(on_bdy[e->vn[j]->id])
+        any = true;
+    if(!any)
+      continue;
+
+    int refinement = 0;
+    if(e->is_quad() && r.aniso)
+    {
+      char v0 = on_bdy[e->vn[0]->id], v1 = on_bdy[e->vn[1]->id], v2 = on_bdy[e->vn[2]->id], v3 = on_bdy[e->vn[3]->id];
+      if((v0 && v2) || (v1 && v3))
+        refinement = 0;
+      else if((v0 && v1) || (v3 && v2))
+        refinement = 1;
+      else if((v1 && v2) || (v3 && v0))
+        refinement = 2;
+    }
+
+    if(refinement == 0)
+      return 0;
+    result = (result == -1 || result == refinement) ? refinement : 0;
+  }
+
+  return result;
+}
+
+void MeshRefinementPlan::apply(Mesh* mesh)
+{
+  // Internal boundary markers.
+  std::vector<int> internal_markers(this->boundary_refinements.size());
+  for(unsigned int i = 0; i < this->boundary_refinements.size(); i++)
+  {
+    const std::string& marker = this->boundary_refinements[i].marker;
+    if(!mesh->get_boundary_markers_conversion().get_internal_marker(marker).valid)
+      throw Hermes::Exceptions::Exception("Boundary marker %s not found in the mesh.", marker.c_str());
+    internal_markers[i] = mesh->get_boundary_markers_conversion().get_internal_marker(marker).marker;
+  }
+
+  int local_sweeps = 0;
+  for(unsigned int i = 0; i < this->vertex_refinements.size(); i++)
+    local_sweeps = std::max(local_sweeps, this->vertex_refinements[i].depth);
+  for(unsigned int i = 0; i < this->boundary_refinements.size(); i++)
+    local_sweeps = std::max(local_sweeps, this->boundary_refinements[i].depth);
+
+  // Uniform sweeps: nothing to mark.
+  for(int sweep = 0; sweep < this->uniform_levels; sweep++)
+    mesh->refine_all_elements(this->uniform_refinement);
+
+  // Local sweeps.
+  std::vector<int> active;
+  std::vector<int> marked;
+  for(int sweep = 0; sweep < local_sweeps; sweep++)
+  {
+    active.clear();
+    Element* e;
+    for_all_active_elements(e, mesh)
+      active.push_back(e->id);
+    int num_active = (int)active.size();
+
+    // Vertices on the boundaries that are refined in this sweep.
+    std::vector<std::vector<char> > boundary_vertices(this->boundary_refinements.size());
+    for(unsigned int i = 0; i < this->boundary_refinements.size(); i++)
+    {
+      if(sweep >= this->boundary_refinements[i].depth)
+        continue;
+      boundary_vertices[i].assign(mesh->get_max_node_id() + 1, 0);
+      for_all_active_elements(e, mesh)
+        for(unsigned int j = 0; j < e->get_nvert(); j++)
+          if(e->en[j]->bnd && e->en[j]->marker == internal_markers[i])
+            boundary_vertices[i][e->en[j]->p1] = boundary_vertices[i][e->en[j]->p2] = 1;
+    }
+
+    // Marking pass. Every thread collects its marks separately,
+    // the lists are merged in thread order to keep the result deterministic.
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    std::vector<std::vector<int> > thread_marks(num_threads);
+#pragma omp parallel num_threads(num_threads)
+    {
+      int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      std::vector<int>& marks = thread_marks[thread];
+#pragma omp for schedule(static)
+      for(int i = 0; i < num_active; i++)
+      {
+        Element* el = mesh->get_element_fast(active[i]);
+        int refinement = get_local_refinement(el, sweep, boundary_vertices);
+        if(refinement >= 0)
+        {
+          marks.push_back(active[i]);
+          marks.push_back(refinement);
+        }
+      }
+    }
+
+    marked.clear();
+    for(int t = 0; t < num_threads; t++)
+      marked.insert(marked.end(), thread_marks[t].begin(), thread_marks[t].end());
+
+    // Splitting pass. Splitting creates nodes in the node hash table of the
+    // mesh, which is shared by all elements and not thread safe, so this is
+    // serial even for elements without common vertices.
+    for(unsigned int i = 0; i < marked.size(); i += 2)
+      mesh->refine_element_id(marked[i], marked[i + 1]);
+
+    this->info("Refinement sweep %d: %d of %d elements refined.", sweep + 1, (int)marked.size() / 2, num_active);
+  }
+
+  // Individual elements.
+  for(unsigned int i = 0; i < this->element_refinements.size(); i += 2)
+    mesh->refine_element_id(this->element_refinements[i], this->element_refinements[i + 1]);
+}
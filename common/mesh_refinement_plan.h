@@ -0,0 +1,83 @@
+#ifndef __HERMES_TUTORIAL_MESH_REFINEMENT_PLAN_H
+#define __HERMES_TUTORIAL_MESH_REFINEMENT_PLAN_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Batched initial mesh refinements */
+
+// Collects initial refinements (uniform, towards a vertex, towards a boundary,
+// individual elements) and applies them together. Instead of walking the
+// element tree once per operation and level, the plan performs one sweep per
+// local refinement level: the refinement of every active element is
+// determined for all operations at once (OpenMP, with thread-local mark lists
+// merged afterwards), and then all marked elements are split in one pass.
+//
+// Only the marking is parallel. Splitting an element creates and looks up
+// nodes in the node hash table of the mesh, which is shared by all elements
+// and not thread safe, so the splitting pass (Mesh::refine_element_id()) and
+// the uniform levels (Mesh::refine_all_elements()) remain serial. The plan
+// saves the repeated tree walks of the individual calls, it does not make
+// the splitting itself scale with the number of cores.
+//
+// Uniform refinements are always performed first. The local refinements
+// (towards vertices and boundaries) are merged level by level, i.e., the
+// k-th level of every local operation is applied in the k-th sweep after the
+// uniform ones. Where the refined regions of two local operations overlap,
+// the result may therefore differ from calling Mesh::refine_towards_vertex()
+// and Mesh::refine_towards_boundary() one after another. Refinements of
+// individual elements are applied last, in the order they were added; their
+// ids refer to the mesh after all sweeps.
+
+class MeshRefinementPlan : public Hermes::Mixins::Loggable
+{
+public:
+  MeshRefinementPlan();
+
+  /// Refine all elements 'levels' times (refinement type as in Mesh::refine_all_elements()).
+  void add_uniform(int levels, int refinement = 0);
+
+  /// Refine elements sharing the vertex 'vertex_id', 'depth' times.
+  void add_towards_vertex(int vertex_id, int depth);
+
+  /// Refine elements adjacent to the boundary 'marker', 'depth' times. With
+  /// 'aniso' set, quadrilaterals are split anisotropically towards the boundary.
+  void add_towards_boundary(std::string marker, int depth, bool aniso = true);
+
+  /// Refine one element (refinement type as in Mesh::refine_element_id()).
+  void add_element(int element_id, int refinement = 0);
+
+  /// Applies all operations to the mesh. The plan can be applied to several meshes.
+  void apply(Mesh* mesh);
+
+  /// Removes all operations.
+  void clear();
+
+protected:
+  /// Refinement of the element requested in the given local sweep, -1 for none.
+  int get_local_refinement(Element* e, int sweep, const std::vector<std::vector<char> >& boundary_vertices) const;
+
+  int uniform_levels, uniform_refinement;
+
+  struct VertexRefinement
+  {
+    int vertex_id;
+    int depth;
+  };
+  std::vector<VertexRefinement> vertex_refinements;
+
+  struct BoundaryRefinement
+  {
+    std::string marker;
+    int depth;
+    bool aniso;
+  };
+  std::vector<BoundaryRefinement> boundary_refinements;
+
+  // Pairs (element id, refinement type).
+  std::vector<int> element_refinements;
+};
+
+#endif
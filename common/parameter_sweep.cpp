@@ -0,0 +1,109 @@
+#include "parameter_sweep.h"
+
+#include <fstream>
+#include <sstream>
+
+ParameterSweep::ParameterSweep(const Space<double>* space) : space(space)
+{
+}
+
+ParameterSweep::~ParameterSweep()
+{
+}
+
+void ParameterSweep::run(int num_sets, int num_threads)
+{
+  if (num_sets < 1)
+  {
+    this->info("No parameter sets to solve.");
+    return;
+  }
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > num_sets)
+    num_threads = num_sets;
+
+  this->info("Solving %d parameter sets with %d thread(s).", num_sets, num_threads);
+
+#pragma omp parallel num_threads(num_threads)
+  solve_sets(num_sets);
+}
+
+void ParameterSweep::solve_sets(int num_sets)
+{
+  int ndof = space->get_num_dofs();
+  std::vector<double> zero(ndof, 0.0);
+
+  // Kept for all sets solved by this thread.
+  DiscreteProblem<double>* dp = NULL;
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  Hermes::Solvers::LinearMatrixSolver<double>* solver = Hermes::Solvers::create_linear_solver<double>(matrix, rhs);
+  bool factorized = false;
+
+#pragma omp for schedule(dynamic)
+  for (int index = 0; index < num_sets; index++)
+  {
+    // Nothing may be thrown out of the parallel region.
+    WeakForm<double>* wf = NULL;
+    try
+    {
+      wf = create_weak_form(index);
+
+      // The structure of the matrix is only created by the first assembly.
+      if (dp == NULL)
+        dp = new DiscreteProblem<double>(wf, space);
+      else
+        dp->set_weak_formulation(wf);
+
+      // The solution is the Newton step from zero.
+      dp->assemble(&zero[0], matrix, rhs);
+      rhs->change_sign();
+
+      if (factorized)
+        solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_MATRIX_REORDERING);
+      if (!solver->solve())
+        throw Hermes::Exceptions::Exception("The matrix solver failed.");
+      factorized = true;
+
+#pragma omp critical (parameter_sweep)
+      process_solution(index, solver->get_sln_vector());
+    }
+    catch (std::exception& e)
+    {
+      this->warn("Parameter set %d failed: %s", index, e.what());
+    }
+    delete wf;
+  }
+
+  delete solver;
+  delete matrix;
+  delete rhs;
+  delete dp;
+}
+
+std::vector<std::vector<double> > ParameterSweep::read_sets(const char* filename, int num_values, const char* names)
+{
+  std::ifstream file(filename);
+  if (!file)
+    throw Hermes::Exceptions::Exception("Unable to open the parameter file '%s'.", filename);
+
+  std::vector<std::vector<double> > sets;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(file, line))
+  {
+    line_number++;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    std::istringstream stream(line);
+    std::vector<double> values(num_values);
+    for (int i = 0; i < num_values; i++)
+      if (!(stream >> values[i]))
+        throw Hermes::Exceptions::Exception("Line %d of '%s': expected %s.", line_number, filename, names);
+    sets.push_back(values);
+  }
+  return sets;
+}
@@ -0,0 +1,52 @@
+#ifndef __HERMES_TUTORIAL_PARAMETER_SWEEP_H
+#define __HERMES_TUTORIAL_PARAMETER_SWEEP_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Parameter sweeps */
+
+// Solves a linear problem for many parameter sets on the same space. Every
+// thread keeps one DiscreteProblem, one matrix and one matrix solver for all
+// the sets it solves: the sparsity structure is created once, and after the
+// first factorization the solver reuses the symbolic analysis (matrix
+// reordering), so per parameter set only the numeric assembly and the
+// numeric factorization are performed.
+//
+// The parameter sets are distributed among the threads dynamically (OpenMP).
+// A derived class creates the weak form of a set and processes its solution.
+
+class ParameterSweep : public Hermes::Mixins::Loggable
+{
+public:
+  ParameterSweep(const Space<double>* space);
+  virtual ~ParameterSweep();
+
+  /// Solves the sets 0 ... num_sets-1 with 'num_threads' threads. A set whose
+  /// assembly or solution fails is reported and skipped.
+  void run(int num_sets, int num_threads = 1);
+
+  /// Reads the parameter sets of 'num_values' values each from a file, one
+  /// set per line ('#' starts a comment). 'names' lists the values for the
+  /// error message. Throws an exception if the file cannot be read or a line
+  /// is malformed.
+  static std::vector<std::vector<double> > read_sets(const char* filename, int num_values, const char* names);
+
+protected:
+  /// Weak form of the set 'index', deleted after the set was solved. Called
+  /// by the thread solving the set.
+  virtual WeakForm<double>* create_weak_form(int index) = 0;
+
+  /// Receives the coefficient vector of the solution of the set 'index'.
+  /// Calls are serialized.
+  virtual void process_solution(int index, const double* coeff_vec) = 0;
+
+  /// Solves the sets assigned to the calling thread.
+  void solve_sets(int num_sets);
+
+  const Space<double>* space;
+};
+
+#endif
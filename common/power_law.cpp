@@ -0,0 +1,94 @@
+#include "power_law.h"
+
+#include <cmath>
+
+/* Power-law nonlinearities */
+
+PowerLawNonlinearity::PowerLawNonlinearity(double c0, double c1) : c0(c0), c1(c1)
+{
+}
+
+Ord PowerLawNonlinearity::value(Ord u) const
+{
+  return Ord(10);
+}
+
+Ord PowerLawNonlinearity::derivative(Ord u) const
+{
+  return Ord(10);
+}
+
+RealPowerLawNonlinearity::RealPowerLawNonlinearity(double alpha, double c0, double c1)
+  : PowerLawNonlinearity(c0, c1), alpha(alpha)
+{
+}
+
+double RealPowerLawNonlinearity::value(double u) const
+{
+  return c0 + c1 * std::pow(u, alpha);
+}
+
+double RealPowerLawNonlinearity::derivative(double u) const
+{
+  return c1 * alpha * std::pow(u, alpha - 1.0);
+}
+
+void RealPowerLawNonlinearity::value_and_derivative(int n, const double* u, double* value, double* derivative) const
+{
+  // u^alpha = exp(alpha * log(u)) and alpha * u^(alpha-1) = alpha * u^alpha / u
+  // for u > 0, other points are fixed below.
+  bool all_positive = true;
+  for (int i = 0; i < n; i++)
+  {
+    double u_pos = (u[i] > 0) ? u[i] : 1.0;
+    double p = std::exp(alpha * std::log(u_pos));
+    value[i] = c0 + c1 * p;
+    derivative[i] = c1 * alpha * p / u_pos;
+    all_positive &= (u[i] > 0);
+  }
+  if (all_positive)
+    return;
+
+  for (int i = 0; i < n; i++)
+    if (!(u[i] > 0))
+    {
+      value[i] = this->value(u[i]);
+      derivative[i] = this->derivative(u[i]);
+    }
+}
+
+void RealPowerLawNonlinearity::values(int n, const double* u, double* value) const
+{
+  bool all_positive = true;
+  for (int i = 0; i < n; i++)
+  {
+    double u_pos = (u[i] > 0) ? u[i] : 1.0;
+    value[i] = c0 + c1 * std::exp(alpha * std::log(u_pos));
+    all_positive &= (u[i] > 0);
+  }
+  if (all_positive)
+    return;
+
+  for (int i = 0; i < n; i++)
+    if (!(u[i] > 0))
+      value[i] = this->value(u[i]);
+}
+
+PowerLawNonlinearity* create_power_law_nonlinearity(double alpha, double c0, double c1)
+{
+  if (alpha == (int) alpha)
+  {
+    switch ((int) alpha)
+    {
+    case 1: return new IntegerPowerLawNonlinearity<1>(c0, c1);
+    case 2: return new IntegerPowerLawNonlinearity<2>(c0, c1);
+    case 3: return new IntegerPowerLawNonlinearity<3>(c0, c1);
+    case 4: return new IntegerPowerLawNonlinearity<4>(c0, c1);
+    case 5: return new IntegerPowerLawNonlinearity<5>(c0, c1);
+    case 6: return new IntegerPowerLawNonlinearity<6>(c0, c1);
+    case 7: return new IntegerPowerLawNonlinearity<7>(c0, c1);
+    case 8: return new IntegerPowerLawNonlinearity<8>(c0, c1);
+    }
+  }
+  return new RealPowerLawNonlinearity(alpha, c0, c1);
+}
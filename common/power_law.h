@@ -0,0 +1,119 @@
+#ifndef __HERMES_TUTORIAL_POWER_LAW_H
+#define __HERMES_TUTORIAL_POWER_LAW_H
+
+#include "hermes2d.h"
+#include "batch_nonlinearity.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Power-law nonlinearities */
+
+// Nonlinearity lambda(u) = c0 + c1 * u^alpha, evaluated in batches by the
+// forms of batch_nonlinearity.h. For integer exponents
+// (IntegerPowerLawNonlinearity) the power is unrolled at compile time into
+// multiplications (repeated squaring), and the derivative reuses u^(alpha-1).
+// Other exponents go through exp(alpha * log(u)) in a loop without calls to
+// pow() and without branches, which the compiler can vectorize (e.g. with
+// glibc's vector math library).
+//
+// The integration order is 10, as for the custom nonlinearities of the
+// tutorial examples.
+
+/// u^N by repeated squaring, unrolled at compile time.
+template<int N>
+struct IntegerPower
+{
+  static double eval(double u)
+  {
+    return (N % 2 ? u : 1.0) * IntegerPower<N / 2>::eval(u * u);
+  }
+};
+
+template<>
+struct IntegerPower<1>
+{
+  static double eval(double u) { return u; }
+};
+
+template<>
+struct IntegerPower<0>
+{
+  static double eval(double u) { return 1.0; }
+};
+
+class PowerLawNonlinearity : public BatchNonlinearity
+{
+public:
+  PowerLawNonlinearity(double c0, double c1);
+
+  virtual Ord value(Ord u) const;
+  virtual Ord derivative(Ord u) const;
+
+  using BatchNonlinearity::value;
+  using BatchNonlinearity::derivative;
+
+protected:
+  double c0, c1;
+};
+
+/// Exponent N >= 1 known at compile time.
+template<int N>
+class IntegerPowerLawNonlinearity : public PowerLawNonlinearity
+{
+public:
+  IntegerPowerLawNonlinearity(double c0 = 0.0, double c1 = 1.0) : PowerLawNonlinearity(c0, c1) {}
+
+  virtual double value(double u) const
+  {
+    return c0 + c1 * IntegerPower<N>::eval(u);
+  }
+
+  virtual double derivative(double u) const
+  {
+    return c1 * N * IntegerPower<N - 1>::eval(u);
+  }
+
+  virtual void value_and_derivative(int n, const double* u, double* value, double* derivative) const
+  {
+    for (int i = 0; i < n; i++)
+    {
+      double p = IntegerPower<N - 1>::eval(u[i]);
+      value[i] = c0 + c1 * p * u[i];
+      derivative[i] = c1 * N * p;
+    }
+  }
+
+  virtual void values(int n, const double* u, double* value) const
+  {
+    for (int i = 0; i < n; i++)
+      value[i] = c0 + c1 * IntegerPower<N>::eval(u[i]);
+  }
+
+  using PowerLawNonlinearity::value;
+  using PowerLawNonlinearity::derivative;
+};
+
+/// Any exponent. Non-positive u are evaluated by std::pow().
+class RealPowerLawNonlinearity : public PowerLawNonlinearity
+{
+public:
+  RealPowerLawNonlinearity(double alpha, double c0 = 0.0, double c1 = 1.0);
+
+  virtual double value(double u) const;
+  virtual double derivative(double u) const;
+  virtual void value_and_derivative(int n, const double* u, double* value, double* derivative) const;
+  virtual void values(int n, const double* u, double* value) const;
+
+  using PowerLawNonlinearity::value;
+  using PowerLawNonlinearity::derivative;
+
+protected:
+  double alpha;
+};
+
+/// IntegerPowerLawNonlinearity for alpha = 1, ..., 8, otherwise
+/// RealPowerLawNonlinearity.
+PowerLawNonlinearity* create_power_law_nonlinearity(double alpha, double c0 = 0.0, double c1 = 1.0);
+
+#endif
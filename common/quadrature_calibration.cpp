@@ -0,0 +1,218 @@
+#include "quadrature_calibration.h"
+
+#include <algorithm>
+
+/* Order settings of one form */
+
+FormOrderCalibration::FormOrderCalibration(const std::string& name)
+  : name(name), reduction(0), cap(-1), recording(false), max_requested_order(0)
+{
+  passed_reduction[0] = passed_reduction[1] = -1;
+  failed[0] = failed[1] = false;
+}
+
+Ord FormOrderCalibration::adjust_order(const Ord& requested)
+{
+  // Orders above the maximum are not available, lowering them would not
+  // change the quadrature.
+  int order = std::min(requested.get_order(), H2D_MAX_QUAD_ORDER);
+
+  if (recording)
+  {
+#pragma omp critical (quadrature_calibration)
+    max_requested_order = std::max(max_requested_order, order);
+  }
+
+  order = std::max(order - reduction, 0);
+  if (cap >= 0)
+    order = std::min(order, cap);
+  return Ord(order);
+}
+
+void FormOrderCalibration::record(int element_id, double value)
+{
+  if (!recording)
+    return;
+
+  // Every element is assembled by a single thread, so the order of the
+  // values of one element does not depend on the number of threads.
+#pragma omp critical (quadrature_calibration)
+  values[element_id].push_back(value);
+}
+
+void FormOrderCalibration::set_reduction(int reduction)
+{
+  this->reduction = reduction;
+}
+
+void FormOrderCalibration::set_cap(int cap)
+{
+  this->cap = cap;
+}
+
+/* Calibration */
+
+QuadratureCalibration::QuadratureCalibration(double tolerance, int max_reduction)
+  : tolerance(tolerance), max_reduction(max_reduction), cap(-1)
+{
+}
+
+QuadratureCalibration::~QuadratureCalibration()
+{
+  for (unsigned int i = 0; i < forms.size(); i++)
+    delete forms[i];
+}
+
+FormOrderCalibration* QuadratureCalibration::add_form(const std::string& name)
+{
+  forms.push_back(new FormOrderCalibration(name));
+  forms.back()->set_cap(cap);
+  return forms.back();
+}
+
+void QuadratureCalibration::set_cap(int cap)
+{
+  this->cap = cap;
+  for (unsigned int i = 0; i < forms.size(); i++)
+    forms[i]->set_cap(cap);
+}
+
+void QuadratureCalibration::assemble(WeakForm<double>* wf, Space<double>* space, double* coeff_vec)
+{
+  DiscreteProblem<double> dp(wf, space);
+  Hermes::Algebra::SparseMatrix<double>* matrix = Hermes::Algebra::create_matrix<double>();
+  Hermes::Algebra::Vector<double>* rhs = Hermes::Algebra::create_vector<double>();
+  dp.assemble(coeff_vec, matrix, rhs);
+  delete matrix;
+  delete rhs;
+}
+
+void QuadratureCalibration::run(WeakForm<double>* wf, Space<double>* space, double* coeff_vec)
+{
+  Mesh* mesh = space->get_mesh();
+
+  std::vector<double> zero;
+  if (coeff_vec == NULL)
+  {
+    zero.assign(space->get_num_dofs(), 0.0);
+    coeff_vec = &zero[0];
+  }
+
+  // Reference: the orders requested by ord().
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    FormOrderCalibration* form = forms[i];
+    form->reduction = 0;
+    form->cap = -1;
+    form->recording = true;
+    form->max_requested_order = 0;
+    form->values.clear();
+    form->passed_reduction[0] = form->passed_reduction[1] = -1;
+    form->failed[0] = form->failed[1] = false;
+  }
+  this->info("Quadrature calibration: assembling with the requested orders.");
+  assemble(wf, space, coeff_vec);
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    FormOrderCalibration* form = forms[i];
+    form->reference.swap(form->values);
+    form->values.clear();
+    for (std::map<int, std::vector<double> >::iterator it = form->reference.begin(); it != form->reference.end(); ++it)
+      form->passed_reduction[mesh->get_element(it->first)->is_triangle() ? 0 : 1] = 0;
+  }
+
+  // Lower the orders until all forms failed on all element types.
+  for (int reduction = 1; reduction <= max_reduction; reduction++)
+  {
+    bool open = false;
+    for (unsigned int i = 0; i < forms.size(); i++)
+      for (int type = 0; type < 2; type++)
+        if (forms[i]->passed_reduction[type] >= 0 && !forms[i]->failed[type])
+          open = true;
+    if (!open)
+      break;
+
+    for (unsigned int i = 0; i < forms.size(); i++)
+    {
+      forms[i]->reduction = reduction;
+      forms[i]->values.clear();
+    }
+    this->info("Quadrature calibration: assembling with the orders lowered by %d.", reduction);
+    assemble(wf, space, coeff_vec);
+    for (unsigned int i = 0; i < forms.size(); i++)
+      compare(forms[i], mesh, reduction);
+  }
+
+  // Report.
+  const char* type_names[2] = { "triangles", "quads" };
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    FormOrderCalibration* form = forms[i];
+    form->recording = false;
+    form->reduction = 0;
+    form->cap = cap;
+    form->values.clear();
+    form->reference.clear();
+
+    this->info("Form '%s': ord() requests orders up to %d.", form->name.c_str(), form->max_requested_order);
+    for (int type = 0; type < 2; type++)
+    {
+      if (form->passed_reduction[type] < 0)
+        continue;
+      this->info("  %s: order %d (requested minus %d) is within the tolerance %g.", type_names[type],
+                 std::max(form->max_requested_order - form->passed_reduction[type], 0),
+                 form->passed_reduction[type], tolerance);
+    }
+  }
+}
+
+void QuadratureCalibration::compare(FormOrderCalibration* form, Mesh* mesh, int reduction)
+{
+  for (std::map<int, std::vector<double> >::iterator it = form->reference.begin(); it != form->reference.end(); ++it)
+  {
+    int type = mesh->get_element(it->first)->is_triangle() ? 0 : 1;
+    if (form->failed[type])
+      continue;
+
+    const std::vector<double>& ref = it->second;
+    const std::vector<double>& val = form->values[it->first];
+    if (val.size() != ref.size())
+    {
+      this->warn("Form '%s' was evaluated differently on element %d, calibration stopped.", form->name.c_str(), it->first);
+      form->failed[0] = form->failed[1] = true;
+      return;
+    }
+
+    double scale = 0, error = 0;
+    for (unsigned int k = 0; k < ref.size(); k++)
+    {
+      scale = std::max(scale, std::abs(ref[k]));
+      error = std::max(error, std::abs(val[k] - ref[k]));
+    }
+    if (error > tolerance * scale)
+      form->failed[type] = true;
+  }
+
+  for (int type = 0; type < 2; type++)
+    if (form->passed_reduction[type] >= 0 && !form->failed[type])
+      form->passed_reduction[type] = reduction;
+}
+
+void QuadratureCalibration::apply()
+{
+  for (unsigned int i = 0; i < forms.size(); i++)
+  {
+    FormOrderCalibration* form = forms[i];
+    int reduction = -1;
+    for (int type = 0; type < 2; type++)
+      if (form->passed_reduction[type] >= 0)
+        reduction = (reduction < 0) ? form->passed_reduction[type] : std::min(reduction, form->passed_reduction[type]);
+    if (reduction > 0)
+    {
+      form->set_reduction(reduction);
+      this->info("Form '%s': integration orders lowered by %d.", form->name.c_str(), reduction);
+    }
+    if (cap >= 0)
+      this->info("Form '%s': integration orders capped at %d.", form->name.c_str(), cap);
+  }
+}
@@ -0,0 +1,164 @@
+#ifndef __HERMES_TUTORIAL_QUADRATURE_CALIBRATION_H
+#define __HERMES_TUTORIAL_QUADRATURE_CALIBRATION_H
+
+#include "hermes2d.h"
+
+#include <map>
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Quadrature order calibration */
+
+// Custom ord() methods often return safe overestimates (a fixed Ord(10), an
+// extra x*x factor), and every additional quadrature order adds integration
+// points on every element. The calibration assembles the weak form with the
+// orders requested by ord(), then repeatedly with the requested orders
+// lowered by 1, 2, ..., and compares the value of every form on every
+// element with the reference. For each form and element type it reports the
+// lowest order that keeps all element integrals within a relative tolerance.
+// The calibrated reduction can then be applied to the forms for the rest of
+// the computation.
+//
+// Forms take part if they are wrapped by OrderCalibratedMatrixForm or
+// OrderCalibratedVectorForm (surface forms are not covered). The values are
+// paired by the order in which the forms are evaluated on an element, which
+// is the same in every assembly of the same space.
+
+/// Order settings and recorded values of one form, shared by its clones.
+class FormOrderCalibration
+{
+public:
+  FormOrderCalibration(const std::string& name);
+
+  /// Order used for the integration, called by the wrappers' ord().
+  Ord adjust_order(const Ord& requested);
+
+  /// Records the value of the form on the element 'element_id' (if recording).
+  void record(int element_id, double value);
+
+  /// Lower every requested order by 'reduction' (not below zero).
+  void set_reduction(int reduction);
+  /// Upper limit of the order (-1 = no limit).
+  void set_cap(int cap);
+
+  std::string name;
+
+protected:
+  int reduction, cap;
+
+  // Calibration data.
+  bool recording;
+  int max_requested_order;
+  std::map<int, std::vector<double> > values, reference;
+  // Largest reduction within the tolerance per element type (0 = triangles,
+  // 1 = quads), -1 if there are no elements of the type.
+  int passed_reduction[2];
+  bool failed[2];
+
+  friend class QuadratureCalibration;
+};
+
+/// Wraps a volumetric matrix form of the type FormType.
+template<typename FormType>
+class OrderCalibratedMatrixForm : public FormType
+{
+public:
+  OrderCalibratedMatrixForm(const FormType& form, FormOrderCalibration* calibration)
+    : FormType(form), calibration(calibration)
+  {
+  }
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *u,
+                       Func<double> *v, Geom<double> *e, Func<double> **ext) const
+  {
+    double result = FormType::value(n, wt, u_ext, u, v, e, ext);
+    calibration->record(e->id, result);
+    return result;
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const
+  {
+    return calibration->adjust_order(FormType::ord(n, wt, u_ext, u, v, e, ext));
+  }
+
+  virtual MatrixFormVol<double>* clone() const
+  {
+    return new OrderCalibratedMatrixForm<FormType>(*this);
+  }
+
+protected:
+  FormOrderCalibration* calibration;
+};
+
+/// Wraps a volumetric vector form of the type FormType.
+template<typename FormType>
+class OrderCalibratedVectorForm : public FormType
+{
+public:
+  OrderCalibratedVectorForm(const FormType& form, FormOrderCalibration* calibration)
+    : FormType(form), calibration(calibration)
+  {
+  }
+
+  virtual double value(int n, double *wt, Func<double> *u_ext[], Func<double> *v,
+                       Geom<double> *e, Func<double> **ext) const
+  {
+    double result = FormType::value(n, wt, u_ext, v, e, ext);
+    calibration->record(e->id, result);
+    return result;
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v,
+                  Geom<Ord> *e, Func<Ord> **ext) const
+  {
+    return calibration->adjust_order(FormType::ord(n, wt, u_ext, v, e, ext));
+  }
+
+  virtual VectorFormVol<double>* clone() const
+  {
+    return new OrderCalibratedVectorForm<FormType>(*this);
+  }
+
+protected:
+  FormOrderCalibration* calibration;
+};
+
+/// Runs the calibration for all registered forms.
+class QuadratureCalibration : public Hermes::Mixins::Loggable
+{
+public:
+  /// 'tolerance' is relative to the largest value of the form on the element.
+  QuadratureCalibration(double tolerance = 1e-10, int max_reduction = 20);
+  virtual ~QuadratureCalibration();
+
+  /// Creates the settings for one form, pass them to the wrapper.
+  FormOrderCalibration* add_form(const std::string& name);
+
+  /// Assembles the weak form repeatedly on the space and reports the results.
+  /// 'coeff_vec' is the linearization point for nonlinear forms (NULL = zero).
+  void run(WeakForm<double>* wf, Space<double>* space, double* coeff_vec = NULL);
+
+  /// Applies the calibrated reduction (the smaller one of both element
+  /// types) to every form.
+  void apply();
+
+  /// Upper limit of the integration order of every form (-1 = no limit),
+  /// on top of the calibrated reduction. It also applies if the calibration
+  /// is not run, but not during run().
+  void set_cap(int cap);
+
+protected:
+  void assemble(WeakForm<double>* wf, Space<double>* space, double* coeff_vec);
+
+  /// Compares the recorded values with the reference for the given reduction.
+  void compare(FormOrderCalibration* form, Mesh* mesh, int reduction);
+
+  double tolerance;
+  int max_reduction;
+  int cap;
+  std::vector<FormOrderCalibration*> forms;
+};
+
+#endif
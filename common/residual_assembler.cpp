@@ -0,0 +1,51 @@
+#include "residual_assembler.h"
+
+#include <cmath>
+
+/* Residual-only assembly */
+
+ResidualAssembler::ResidualAssembler(DiscreteProblem<double>* dp)
+  : dp(dp), vector(Hermes::Algebra::create_vector<double>()), num_assemblies(0)
+{
+}
+
+ResidualAssembler::~ResidualAssembler()
+{
+  delete vector;
+}
+
+double ResidualAssembler::assemble(double* coeff_vec)
+{
+  dp->assemble(coeff_vec, vector);
+  num_assemblies++;
+
+  residual.resize(dp->get_num_dofs());
+  if (residual.empty())
+    return 0;
+  vector->extract(&residual[0]);
+
+  double norm = 0;
+  for (unsigned int i = 0; i < residual.size(); i++)
+    norm += residual[i] * residual[i];
+  return std::sqrt(norm);
+}
+
+const double* ResidualAssembler::get_residual() const
+{
+  return residual.empty() ? NULL : &residual[0];
+}
+
+Hermes::Algebra::Vector<double>* ResidualAssembler::get_vector()
+{
+  return vector;
+}
+
+int ResidualAssembler::get_num_dofs() const
+{
+  return residual.size();
+}
+
+int ResidualAssembler::get_num_assemblies() const
+{
+  return num_assemblies;
+}
@@ -0,0 +1,47 @@
+#ifndef __HERMES_TUTORIAL_RESIDUAL_ASSEMBLER_H
+#define __HERMES_TUTORIAL_RESIDUAL_ASSEMBLER_H
+
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Residual-only assembly */
+
+// Evaluates the residual F(x) of a DiscreteProblem without a matrix, for
+// convergence checks and line searches, which need it more often than the
+// Jacobian. The assembly goes through DiscreteProblem::assemble(coeff_vec,
+// rhs): without a matrix no matrix form is evaluated and no sparse structure
+// is built. The Hermes vector is created once and kept, and the residual is
+// extracted from it in one call into a contiguous array.
+//
+// The forms of batch_nonlinearity.h evaluate only lambda(u) for the residual,
+// not its derivative.
+
+class ResidualAssembler
+{
+public:
+  ResidualAssembler(DiscreteProblem<double>* dp);
+  ~ResidualAssembler();
+
+  /// Assembles F(coeff_vec), returns its l2 norm.
+  double assemble(double* coeff_vec);
+
+  /// F of the last assemble(), ndof entries.
+  const double* get_residual() const;
+
+  /// F of the last assemble() as a Hermes vector, e.g. the right-hand side of
+  /// a matrix solver. It may be changed until the next assemble().
+  Hermes::Algebra::Vector<double>* get_vector();
+
+  int get_num_dofs() const;
+  int get_num_assemblies() const;
+
+protected:
+  DiscreteProblem<double>* dp;
+  Hermes::Algebra::Vector<double>* vector;
+  std::vector<double> residual;
+  int num_assemblies;
+};
+
+#endif
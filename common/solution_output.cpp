@@ -0,0 +1,694 @@
+#include "solution_output.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WITH_HDF5
+#include <hdf5.h>
+#endif
+
+/* Output triangulation */
+
+OutputTriangulation::OutputTriangulation() : num_vertices(0), vertices(NULL), num_triangles(0), triangles(NULL), cell_values(NULL)
+{
+}
+
+void OutputTriangulation::set_from_linearizer(Views::Linearizer* lin)
+{
+  this->num_vertices = lin->get_num_vertices();
+  this->vertices = (const double*) lin->get_vertices();
+  this->num_triangles = lin->get_num_triangles();
+  this->triangles = (const int*) lin->get_triangles();
+  this->cell_values = NULL;
+}
+
+void OutputTriangulation::set_from_space(const Space<double>* space)
+{
+  Mesh* mesh = space->get_mesh();
+
+  this->vertex_storage.clear();
+  this->triangle_storage.clear();
+  this->cell_value_storage.clear();
+
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    int first = (int) this->vertex_storage.size() / 3;
+    for(unsigned int i = 0; i < e->get_nvert(); i++)
+    {
+      this->vertex_storage.push_back(e->vn[i]->x);
+      this->vertex_storage.push_back(e->vn[i]->y);
+      this->vertex_storage.push_back(0.0);
+    }
+
+    int order = space->get_element_order(e->id);
+    double value = (double) std::max(H2D_GET_H_ORDER(order), e->is_triangle() ? 0 : H2D_GET_V_ORDER(order));
+
+    // Quads are split along the diagonal 0-2.
+    int num_triangles = e->is_triangle() ? 1 : 2;
+    for(int t = 0; t < num_triangles; t++)
+    {
+      this->triangle_storage.push_back(first);
+      this->triangle_storage.push_back(first + t + 1);
+      this->triangle_storage.push_back(first + t + 2);
+      this->cell_value_storage.push_back(value);
+    }
+  }
+
+  this->num_vertices = (int) this->vertex_storage.size() / 3;
+  this->vertices = this->num_vertices ? &this->vertex_storage[0] : NULL;
+  this->num_triangles = (int) this->triangle_storage.size() / 3;
+  this->triangles = this->num_triangles ? &this->triangle_storage[0] : NULL;
+  this->cell_values = this->num_triangles ? &this->cell_value_storage[0] : NULL;
+}
+
+void OutputTriangulation::make_copy()
+{
+  if(this->vertices != NULL && (this->vertex_storage.empty() || this->vertices != &this->vertex_storage[0]))
+  {
+    this->vertex_storage.assign(this->vertices, this->vertices + 3 * this->num_vertices);
+    this->vertices = &this->vertex_storage[0];
+  }
+  if(this->triangles != NULL && (this->triangle_storage.empty() || this->triangles != &this->triangle_storage[0]))
+  {
+    this->triangle_storage.assign(this->triangles, this->triangles + 3 * this->num_triangles);
+    this->triangles = &this->triangle_storage[0];
+  }
+  if(this->cell_values != NULL && (this->cell_value_storage.empty() || this->cell_values != &this->cell_value_storage[0]))
+  {
+    this->cell_value_storage.assign(this->cell_values, this->cell_values + this->num_triangles);
+    this->cell_values = &this->cell_value_storage[0];
+  }
+}
+
+/* Array sources */
+
+// The writers never build the output arrays as a whole, they ask a source
+// to convert a range of tuples into a buffer instead.
+
+namespace
+{
+  class ArraySource
+  {
+  public:
+    ArraySource(size_t count, int components, int component_bytes)
+      : count(count), components(components), component_bytes(component_bytes) {}
+    virtual ~ArraySource() {}
+
+    size_t tuple_bytes() const { return components * component_bytes; }
+    size_t bytes() const { return count * tuple_bytes(); }
+
+    /// Converts the tuples [first, first + n) into 'out'.
+    virtual void fill(size_t first, size_t n, char* out) const = 0;
+
+    size_t count;
+    int components;
+    int component_bytes;
+  };
+
+  // Component 'component' of the vertices (x, y, value).
+  class VertexComponentSource : public ArraySource
+  {
+  public:
+    VertexComponentSource(const OutputTriangulation& data, int component)
+      : ArraySource(data.num_vertices, 1, sizeof(double)), data(data), component(component) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      double* result = (double*) out;
+      for(size_t i = 0; i < n; i++)
+        result[i] = data.vertices[3 * (first + i) + component];
+    }
+    const OutputTriangulation& data;
+    int component;
+  };
+
+  // Vertex coordinates, 2 (x, y) or 3 (x, y, z) components.
+  class PointSource : public ArraySource
+  {
+  public:
+    PointSource(const OutputTriangulation& data, int components, bool mode_3D)
+      : ArraySource(data.num_vertices, components, sizeof(double)), data(data), mode_3D(mode_3D) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      double* result = (double*) out;
+      for(size_t i = 0; i < n; i++)
+      {
+        const double* v = data.vertices + 3 * (first + i);
+        result[components * i] = v[0];
+        result[components * i + 1] = v[1];
+        if(components == 3)
+          result[components * i + 2] = mode_3D ? v[2] : 0.0;
+      }
+    }
+    const OutputTriangulation& data;
+    bool mode_3D;
+  };
+
+  class CellValueSource : public ArraySource
+  {
+  public:
+    CellValueSource(const OutputTriangulation& data)
+      : ArraySource(data.num_triangles, 1, sizeof(double)), data(data) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      memcpy(out, data.cell_values + first, n * sizeof(double));
+    }
+    const OutputTriangulation& data;
+  };
+
+  class ConnectivitySource : public ArraySource
+  {
+  public:
+    ConnectivitySource(const OutputTriangulation& data)
+      : ArraySource(data.num_triangles, 3, sizeof(int)), data(data) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      memcpy(out, data.triangles + 3 * first, 3 * n * sizeof(int));
+    }
+    const OutputTriangulation& data;
+  };
+
+  // VTK cell offsets (end of every cell in the connectivity array).
+  class OffsetSource : public ArraySource
+  {
+  public:
+    OffsetSource(size_t count) : ArraySource(count, 1, sizeof(int)) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      int* result = (int*) out;
+      for(size_t i = 0; i < n; i++)
+        result[i] = 3 * (int)(first + i + 1);
+    }
+  };
+
+  // VTK cell types, all VTK_TRIANGLE.
+  class TypeSource : public ArraySource
+  {
+  public:
+    TypeSource(size_t count) : ArraySource(count, 1, 1) {}
+    virtual void fill(size_t first, size_t n, char* out) const
+    {
+      memset(out, 5, n);
+    }
+  };
+
+  // Size of the conversion buffers.
+  const size_t OUTPUT_BLOCK_BYTES = 1 << 16;
+
+  size_t tuples_per_block(const ArraySource& source)
+  {
+    return std::max((size_t) 1, OUTPUT_BLOCK_BYTES / source.tuple_bytes());
+  }
+
+  bool is_little_endian()
+  {
+    unsigned int one = 1;
+    return *((unsigned char*) &one) == 1;
+  }
+}
+
+/* VTU writer */
+
+VTUWriter::VTUWriter(bool compress) : compress(compress)
+{
+#ifndef WITH_ZLIB
+  if(compress)
+    throw Hermes::Exceptions::Exception("Compressed VTU output needs zlib, build with WITH_ZLIB.");
+#endif
+}
+
+void VTUWriter::write(const OutputTriangulation& data, const char* filename, const char* value_name,
+                      const char* cell_value_name, bool mode_3D)
+{
+  // The arrays in the order in which they appear in the appended section.
+  std::vector<ArraySource*> sources;
+  std::vector<std::string> tags;
+
+  char tag[512];
+  if(value_name != NULL)
+  {
+    sprintf(tag, "<DataArray type=\"Float64\" Name=\"%.400s\" format=\"appended\"", value_name);
+    sources.push_back(new VertexComponentSource(data, 2));
+    tags.push_back(tag);
+  }
+  if(cell_value_name != NULL && data.cell_values != NULL)
+  {
+    sprintf(tag, "<DataArray type=\"Float64\" Name=\"%.400s\" format=\"appended\"", cell_value_name);
+    sources.push_back(new CellValueSource(data));
+    tags.push_back(tag);
+  }
+  sources.push_back(new PointSource(data, 3, mode_3D));
+  tags.push_back("<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"appended\"");
+  sources.push_back(new ConnectivitySource(data));
+  tags.push_back("<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\"");
+  sources.push_back(new OffsetSource(data.num_triangles));
+  tags.push_back("<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\"");
+  sources.push_back(new TypeSource(data.num_triangles));
+  tags.push_back("<DataArray type=\"UInt8\" Name=\"types\" format=\"appended\"");
+
+  // Compressed arrays are prepared in memory first, their sizes
+  // are needed for the offsets in the XML header.
+  std::vector<std::vector<unsigned long long> > block_headers(sources.size());
+  std::vector<std::vector<char> > compressed(sources.size());
+  std::vector<unsigned long long> offsets(sources.size());
+  std::vector<char> buffer;
+  unsigned long long offset = 0;
+  for(unsigned int a = 0; a < sources.size(); a++)
+  {
+    const ArraySource& source = *sources[a];
+    offsets[a] = offset;
+    if(!this->compress)
+    {
+      offset += sizeof(unsigned long long) + source.bytes();
+      continue;
+    }
+#ifdef WITH_ZLIB
+    size_t block_tuples = tuples_per_block(source);
+    size_t num_blocks = (source.count + block_tuples - 1) / block_tuples;
+    size_t last_block_bytes = (source.count % block_tuples) * source.tuple_bytes();
+    std::vector<unsigned long long>& header = block_headers[a];
+    header.push_back(num_blocks);
+    header.push_back(block_tuples * source.tuple_bytes());
+    header.push_back(last_block_bytes);
+
+    buffer.resize(block_tuples * source.tuple_bytes());
+    std::vector<Bytef> block(compressBound(buffer.size()));
+    for(size_t first = 0; first < source.count; first += block_tuples)
+    {
+      size_t n = std::min(block_tuples, source.count - first);
+      source.fill(first, n, &buffer[0]);
+      uLongf block_size = block.size();
+      if(compress2(&block[0], &block_size, (const Bytef*) &buffer[0], n * source.tuple_bytes(), Z_DEFAULT_COMPRESSION) != Z_OK)
+        throw Hermes::Exceptions::Exception("Compression of the VTU output failed.");
+      header.push_back(block_size);
+      compressed[a].insert(compressed[a].end(), (char*) &block[0], (char*) &block[0] + block_size);
+    }
+    offset += header.size() * sizeof(unsigned long long) + compressed[a].size();
+#endif
+  }
+
+  FILE* f = fopen(filename, "wb");
+  if(f == NULL)
+  {
+    for(unsigned int a = 0; a < sources.size(); a++)
+      delete sources[a];
+    throw Hermes::Exceptions::Exception("Could not open %s for writing.", filename);
+  }
+
+  fprintf(f, "<?xml version=\"1.0\"?>\n");
+  fprintf(f, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"%s>\n",
+          is_little_endian() ? "LittleEndian" : "BigEndian", this->compress ? " compressor=\"vtkZLibDataCompressor\"" : "");
+  fprintf(f, "  <UnstructuredGrid>\n");
+  fprintf(f, "    <Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", data.num_vertices, data.num_triangles);
+  unsigned int a = 0;
+  if(value_name != NULL)
+  {
+    fprintf(f, "      <PointData Scalars=\"%s\">\n", value_name);
+    fprintf(f, "        %s offset=\"%llu\"/>\n", tags[a].c_str(), offsets[a]);
+    a++;
+    fprintf(f, "      </PointData>\n");
+  }
+  if(cell_value_name != NULL && data.cell_values != NULL)
+  {
+    fprintf(f, "      <CellData Scalars=\"%s\">\n", cell_value_name);
+    fprintf(f, "        %s offset=\"%llu\"/>\n", tags[a].c_str(), offsets[a]);
+    a++;
+    fprintf(f, "      </CellData>\n");
+  }
+  fprintf(f, "      <Points>\n");
+  fprintf(f, "        %s offset=\"%llu\"/>\n", tags[a].c_str(), offsets[a]);
+  a++;
+  fprintf(f, "      </Points>\n");
+  fprintf(f, "      <Cells>\n");
+  for(; a < sources.size(); a++)
+    fprintf(f, "        %s offset=\"%llu\"/>\n", tags[a].c_str(), offsets[a]);
+  fprintf(f, "      </Cells>\n");
+  fprintf(f, "    </Piece>\n");
+  fprintf(f, "  </UnstructuredGrid>\n");
+  fprintf(f, "  <AppendedData encoding=\"raw\">\n_");
+
+  for(a = 0; a < sources.size(); a++)
+  {
+    const ArraySource& source = *sources[a];
+    if(this->compress)
+    {
+      fwrite(&block_headers[a][0], sizeof(unsigned long long), block_headers[a].size(), f);
+      if(!compressed[a].empty())
+        fwrite(&compressed[a][0], 1, compressed[a].size(), f);
+      continue;
+    }
+
+    unsigned long long bytes = source.bytes();
+    fwrite(&bytes, sizeof(unsigned long long), 1, f);
+    size_t block_tuples = tuples_per_block(source);
+    buffer.resize(block_tuples * source.tuple_bytes());
+    for(size_t first = 0; first < source.count; first += block_tuples)
+    {
+      size_t n = std::min(block_tuples, source.count - first);
+      source.fill(first, n, &buffer[0]);
+      fwrite(&buffer[0], source.tuple_bytes(), n, f);
+    }
+  }
+
+  fprintf(f, "\n  </AppendedData>\n");
+  fprintf(f, "</VTKFile>\n");
+  bool failed = ferror(f) != 0;
+  fclose(f);
+
+  for(a = 0; a < sources.size(); a++)
+    delete sources[a];
+
+  if(failed)
+    throw Hermes::Exceptions::Exception("Writing %s failed.", filename);
+}
+
+/* XDMF writer */
+
+XDMFWriter::XDMFWriter(int chunk_size) : chunk_size(chunk_size)
+{
+#ifndef WITH_HDF5
+  throw Hermes::Exceptions::Exception("XDMF output needs HDF5, build with WITH_HDF5.");
+#endif
+}
+
+#ifdef WITH_HDF5
+static void write_dataset(hid_t file, const char* name, hid_t type, const ArraySource& source, size_t chunk)
+{
+  hsize_t dims[2] = { source.count, (hsize_t) source.components };
+  int rank = source.components > 1 ? 2 : 1;
+  hid_t file_space = H5Screate_simple(rank, dims, NULL);
+  hid_t dataset = H5Dcreate2(file, name, type, file_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(dataset < 0)
+  {
+    H5Sclose(file_space);
+    throw Hermes::Exceptions::Exception("Could not create the HDF5 dataset %s.", name);
+  }
+
+  std::vector<char> buffer(chunk * source.tuple_bytes());
+  herr_t status = 0;
+  for(size_t first = 0; first < source.count && status >= 0; first += chunk)
+  {
+    size_t n = std::min(chunk, source.count - first);
+    source.fill(first, n, &buffer[0]);
+
+    hsize_t start[2] = { first, 0 };
+    hsize_t count[2] = { n, (hsize_t) source.components };
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    hid_t memory_space = H5Screate_simple(rank, count, NULL);
+    status = H5Dwrite(dataset, type, memory_space, file_space, H5P_DEFAULT, &buffer[0]);
+    H5Sclose(memory_space);
+  }
+
+  H5Dclose(dataset);
+  H5Sclose(file_space);
+  if(status < 0)
+    throw Hermes::Exceptions::Exception("Writing the HDF5 dataset %s failed.", name);
+}
+#endif
+
+void XDMFWriter::write(const OutputTriangulation& data, const char* filename_base, const char* value_name,
+                       const char* cell_value_name)
+{
+#ifdef WITH_HDF5
+  std::string h5_filename = std::string(filename_base) + ".h5";
+  std::string xmf_filename = std::string(filename_base) + ".xmf";
+  // The XDMF file refers to the HDF5 file relative to its own directory.
+  std::string h5_reference = h5_filename.substr(h5_filename.find_last_of("/\\") + 1);
+
+  hid_t file = H5Fcreate(h5_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if(file < 0)
+    throw Hermes::Exceptions::Exception("Could not create %s.", h5_filename.c_str());
+  try
+  {
+    write_dataset(file, "/vertices", H5T_NATIVE_DOUBLE, PointSource(data, 2, false), this->chunk_size);
+    write_dataset(file, "/triangles", H5T_NATIVE_INT, ConnectivitySource(data), this->chunk_size);
+    if(value_name != NULL)
+      write_dataset(file, "/values", H5T_NATIVE_DOUBLE, VertexComponentSource(data, 2), this->chunk_size);
+    if(cell_value_name != NULL && data.cell_values != NULL)
+      write_dataset(file, "/cell_values", H5T_NATIVE_DOUBLE, CellValueSource(data), this->chunk_size);
+  }
+  catch(...)
+  {
+    H5Fclose(file);
+    throw;
+  }
+  H5Fclose(file);
+
+  FILE* f = fopen(xmf_filename.c_str(), "w");
+  if(f == NULL)
+    throw Hermes::Exceptions::Exception("Could not open %s for writing.", xmf_filename.c_str());
+  const char* h5 = h5_reference.c_str();
+  fprintf(f, "<?xml version=\"1.0\" ?>\n");
+  fprintf(f, "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n");
+  fprintf(f, "<Xdmf Version=\"2.0\">\n");
+  fprintf(f, "  <Domain>\n");
+  fprintf(f, "    <Grid Name=\"mesh\" GridType=\"Uniform\">\n");
+  fprintf(f, "      <Topology TopologyType=\"Triangle\" NumberOfElements=\"%d\">\n", data.num_triangles);
+  fprintf(f, "        <DataItem Dimensions=\"%d 3\" NumberType=\"Int\" Precision=\"%d\" Format=\"HDF\">%s:/triangles</DataItem>\n",
+          data.num_triangles, (int) sizeof(int), h5);
+  fprintf(f, "      </Topology>\n");
+  fprintf(f, "      <Geometry GeometryType=\"XY\">\n");
+  fprintf(f, "        <DataItem Dimensions=\"%d 2\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">%s:/vertices</DataItem>\n",
+          data.num_vertices, h5);
+  fprintf(f, "      </Geometry>\n");
+  if(value_name != NULL)
+  {
+    fprintf(f, "      <Attribute Name=\"%s\" AttributeType=\"Scalar\" Center=\"Node\">\n", value_name);
+    fprintf(f, "        <DataItem Dimensions=\"%d\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">%s:/values</DataItem>\n",
+            data.num_vertices, h5);
+    fprintf(f, "      </Attribute>\n");
+  }
+  if(cell_value_name != NULL && data.cell_values != NULL)
+  {
+    fprintf(f, "      <Attribute Name=\"%s\" AttributeType=\"Scalar\" Center=\"Cell\">\n", cell_value_name);
+    fprintf(f, "        <DataItem Dimensions=\"%d\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">%s:/cell_values</DataItem>\n",
+            data.num_triangles, h5);
+    fprintf(f, "      </Attribute>\n");
+  }
+  fprintf(f, "    </Grid>\n");
+  fprintf(f, "  </Domain>\n");
+  fprintf(f, "</Xdmf>\n");
+  fclose(f);
+#else
+  throw Hermes::Exceptions::Exception("XDMF output needs HDF5, build with WITH_HDF5.");
+#endif
+}
+
+/* Solution output */
+
+SolutionOutput::Format SolutionOutput::get_format(int vtk_format)
+{
+  switch(vtk_format)
+  {
+  case 1:
+    return FORMAT_VTU;
+  case 2:
+    return FORMAT_VTU_ZLIB;
+  case 3:
+    return FORMAT_XDMF;
+  default:
+    throw Hermes::Exceptions::Exception("Parameter VTK_FORMAT: %d is not an output format (1 = VTU, 2 = zlib-compressed VTU, 3 = XDMF + HDF5).", vtk_format);
+  }
+}
+
+SolutionOutput::Job::Job() : mode_3D(false)
+{
+}
+
+SolutionOutput::SolutionOutput(Format format, bool background, int max_pending)
+  : format(format), background(background), max_pending(max_pending), view(NULL), thread_running(false), finish(false),
+    pending(0)
+{
+  if(this->max_pending < 1)
+    this->max_pending = 1;
+
+#ifndef WITH_ZLIB
+  if(format == FORMAT_VTU_ZLIB)
+    throw Hermes::Exceptions::Exception("Compressed VTU output needs zlib, build with WITH_ZLIB.");
+#endif
+#ifndef WITH_HDF5
+  if(format == FORMAT_XDMF)
+    throw Hermes::Exceptions::Exception("XDMF output needs HDF5, build with WITH_HDF5.");
+#endif
+
+  pthread_mutex_init(&this->mutex, NULL);
+  pthread_cond_init(&this->job_added, NULL);
+  pthread_cond_init(&this->job_done, NULL);
+  if(this->background)
+  {
+    if(pthread_create(&this->thread, NULL, SolutionOutput::worker, this) != 0)
+    {
+      this->warn("Could not start the output thread, output will be written directly.");
+      this->background = false;
+    }
+    else
+      this->thread_running = true;
+  }
+}
+
+SolutionOutput::~SolutionOutput()
+{
+  if(this->thread_running)
+  {
+    pthread_mutex_lock(&this->mutex);
+    this->finish = true;
+    pthread_cond_signal(&this->job_added);
+    pthread_mutex_unlock(&this->mutex);
+    pthread_join(this->thread, NULL);
+  }
+  pthread_cond_destroy(&this->job_done);
+  pthread_cond_destroy(&this->job_added);
+  pthread_mutex_destroy(&this->mutex);
+}
+
+void SolutionOutput::save_solution(MeshFunction<double>* sln, const char* filename_base, const char* quantity_name,
+                                   bool mode_3D, int item, double eps)
+{
+  Views::Linearizer lin;
+  lin.process_solution(sln, item, eps);
+
+  Job* job = new Job;
+  job->data.set_from_linearizer(&lin);
+  job->filename_base = filename_base;
+  job->value_name = quantity_name;
+  job->mode_3D = mode_3D;
+  this->submit(job);
+}
+
+void SolutionOutput::save_orders(const Space<double>* space, const char* filename_base)
+{
+  Job* job = new Job;
+  job->data.set_from_space(space);
+  job->filename_base = filename_base;
+  job->cell_value_name = "Order";
+  job->mode_3D = false;
+  this->submit(job);
+}
+
+void SolutionOutput::save_snapshot(const double* coeff_vec, const Space<double>* space, const char* filename_base,
+                                   const char* quantity_name, const char* title, bool mode_3D, int item, double eps)
+{
+  if(filename_base == NULL && (this->view == NULL || title == NULL))
+    return;
+
+  Solution<double> sln;
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+  this->save_snapshot(&sln, filename_base, quantity_name, title, mode_3D, item, eps);
+}
+
+void SolutionOutput::save_snapshot(MeshFunction<double>* sln, const char* filename_base, const char* quantity_name,
+                                   const char* title, bool mode_3D, int item, double eps)
+{
+  if(this->view != NULL && title != NULL)
+  {
+    this->view->set_title(title);
+    this->view->show(sln);
+  }
+  if(filename_base != NULL)
+    this->save_solution(sln, filename_base, quantity_name, mode_3D, item, eps);
+}
+
+void SolutionOutput::set_view(Views::ScalarView* view)
+{
+  this->view = view;
+}
+
+void SolutionOutput::write(Job* job)
+{
+  const char* value_name = job->value_name.empty() ? NULL : job->value_name.c_str();
+  const char* cell_value_name = job->cell_value_name.empty() ? NULL : job->cell_value_name.c_str();
+
+  if(this->format == FORMAT_XDMF)
+  {
+    XDMFWriter writer;
+    writer.write(job->data, job->filename_base.c_str(), value_name, cell_value_name);
+    this->info("Output written to %s.xmf.", job->filename_base.c_str());
+  }
+  else
+  {
+    std::string filename = job->filename_base + ".vtu";
+    VTUWriter writer(this->format == FORMAT_VTU_ZLIB);
+    writer.write(job->data, filename.c_str(), value_name, cell_value_name, job->mode_3D);
+    this->info("Output written to %s.", filename.c_str());
+  }
+}
+
+void SolutionOutput::submit(Job* job)
+{
+  if(!this->background)
+  {
+    try
+    {
+      this->write(job);
+    }
+    catch(...)
+    {
+      delete job;
+      throw;
+    }
+    delete job;
+    return;
+  }
+
+  // The borrowed arrays (e.g. of a linearizer) do not outlive the caller.
+  job->data.make_copy();
+
+  pthread_mutex_lock(&this->mutex);
+  while(this->pending >= this->max_pending)
+    pthread_cond_wait(&this->job_done, &this->mutex);
+  this->queue.push_back(job);
+  this->pending++;
+  pthread_cond_signal(&this->job_added);
+  pthread_mutex_unlock(&this->mutex);
+}
+
+void SolutionOutput::wait()
+{
+  if(!this->background)
+    return;
+  pthread_mutex_lock(&this->mutex);
+  while(this->pending > 0)
+    pthread_cond_wait(&this->job_done, &this->mutex);
+  pthread_mutex_unlock(&this->mutex);
+}
+
+void* SolutionOutput::worker(void* arg)
+{
+  SolutionOutput* output = (SolutionOutput*) arg;
+
+  pthread_mutex_lock(&output->mutex);
+  while(true)
+  {
+    while(output->queue.empty() && !output->finish)
+      pthread_cond_wait(&output->job_added, &output->mutex);
+    if(output->queue.empty())
+      break;
+
+    Job* job = output->queue.front();
+    output->queue.pop_front();
+    pthread_mutex_unlock(&output->mutex);
+
+    // Errors cannot be passed to the computation, they are only reported.
+    try
+    {
+      output->write(job);
+    }
+    catch(std::exception& e)
+    {
+      output->warn("Output to %s failed: %s", job->filename_base.c_str(), e.what());
+    }
+    delete job;
+
+    pthread_mutex_lock(&output->mutex);
+    output->pending--;
+    pthread_cond_broadcast(&output->job_done);
+  }
+  pthread_mutex_unlock(&output->mutex);
+
+  return NULL;
+}
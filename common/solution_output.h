@@ -0,0 +1,179 @@
+#ifndef __HERMES_TUTORIAL_SOLUTION_OUTPUT_H
+#define __HERMES_TUTORIAL_SOLUTION_OUTPUT_H
+
+#include "hermes2d.h"
+
+#include <deque>
+#include <pthread.h>
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Triangulated output data */
+
+// Linear triangles with a value in every vertex (linearized solutions) or
+// in every triangle (element orders). The arrays are either borrowed from a
+// Linearizer, so that nothing is copied for synchronous output, or owned by
+// the object (make_copy()), which is needed for output in the background.
+
+class OutputTriangulation
+{
+public:
+  OutputTriangulation();
+
+  /// Borrows the arrays of a Linearizer that already processed a solution.
+  void set_from_linearizer(Views::Linearizer* lin);
+
+  /// Triangulates the active elements of the space (quads are split into two
+  /// triangles), every triangle gets the polynomial order of its element.
+  void set_from_space(const Space<double>* space);
+
+  /// Copies borrowed arrays, so that the source can change or be destroyed.
+  void make_copy();
+
+  // Vertices (x, y, value) and triangles (three vertex indices).
+  int num_vertices;
+  const double* vertices;
+  int num_triangles;
+  const int* triangles;
+  // One value per triangle, or NULL.
+  const double* cell_values;
+
+protected:
+  std::vector<double> vertex_storage;
+  std::vector<int> triangle_storage;
+  std::vector<double> cell_value_storage;
+};
+
+/* Writers */
+
+/// VTK XML unstructured grid (.vtu) with binary data in the appended section,
+/// optionally compressed by zlib (needs WITH_ZLIB). The data is converted in
+/// blocks, so apart from the compressed blocks nothing is duplicated.
+class VTUWriter : public Hermes::Mixins::Loggable
+{
+public:
+  VTUWriter(bool compress = false);
+
+  /// 'value_name' names the vertex values, 'cell_value_name' the triangle values.
+  /// With 'mode_3D', the vertex value is also used as the z-coordinate.
+  void write(const OutputTriangulation& data, const char* filename, const char* value_name,
+             const char* cell_value_name = NULL, bool mode_3D = false);
+
+protected:
+  bool compress;
+};
+
+/// XDMF description (.xmf) with the heavy data in an HDF5 file (.h5) of the same
+/// base name (needs WITH_HDF5). The datasets are written in chunks of
+/// 'chunk_size' vertices or triangles.
+class XDMFWriter : public Hermes::Mixins::Loggable
+{
+public:
+  XDMFWriter(int chunk_size = 65536);
+
+  /// Writes 'filename_base'.xmf and 'filename_base'.h5.
+  void write(const OutputTriangulation& data, const char* filename_base, const char* value_name,
+             const char* cell_value_name = NULL);
+
+protected:
+  int chunk_size;
+};
+
+/* Solution output */
+
+// Replacement for Linearizer::save_solution_vtk() and Orderizer::save_orders_vtk()
+// writing binary formats. With 'background' set, the linearized data is copied
+// and written by a separate thread while the computation continues; at most
+// 'max_pending' outputs wait in the queue, after that save_*() blocks.
+//
+// save_snapshot() is meant for time stepping loops: the solution is converted
+// (from a coefficient vector), shown in a ScalarView (set_view()) and
+// linearized in the calling thread, since neither the space and mesh nor the
+// view may be used by two threads at once. Only the writing of the file, from
+// a copy of the linearized data, is left to the output thread.
+
+class SolutionOutput : public Hermes::Mixins::Loggable
+{
+public:
+  enum Format
+  {
+    FORMAT_VTU,
+    FORMAT_VTU_ZLIB,
+    FORMAT_XDMF
+  };
+
+  SolutionOutput(Format format = FORMAT_VTU, bool background = false, int max_pending = 2);
+
+  /// The format selected by the runtime parameter VTK_FORMAT of the examples:
+  /// 1 = FORMAT_VTU, 2 = FORMAT_VTU_ZLIB, 3 = FORMAT_XDMF. Throws an exception
+  /// for any other value.
+  static Format get_format(int vtk_format);
+  /// Waits until all pending output is written.
+  virtual ~SolutionOutput();
+
+  /// Linearizes the solution and writes it to 'filename_base' + extension
+  /// (.vtu, or .xmf and .h5). Parameters as in Linearizer::save_solution_vtk().
+  void save_solution(MeshFunction<double>* sln, const char* filename_base, const char* quantity_name,
+                     bool mode_3D = true, int item = H2D_FN_VAL_0, double eps = HERMES_EPS_NORMAL);
+
+  /// Writes the mesh and the element orders of the space.
+  void save_orders(const Space<double>* space, const char* filename_base);
+
+  /// Converts the coefficient vector of a solution in 'space' into a Solution,
+  /// shows it in the view set by set_view() with the title 'title' (if not
+  /// NULL) and writes it to 'filename_base' (if not NULL). Nothing is converted
+  /// if there is neither a file nor a view.
+  void save_snapshot(const double* coeff_vec, const Space<double>* space, const char* filename_base,
+                     const char* quantity_name, const char* title = NULL, bool mode_3D = true,
+                     int item = H2D_FN_VAL_0, double eps = HERMES_EPS_NORMAL);
+
+  /// As above, for a solution that is not given by a coefficient vector (e.g.
+  /// from RungeKutta). The solution is not copied, it may change as soon as
+  /// the call returns.
+  void save_snapshot(MeshFunction<double>* sln, const char* filename_base, const char* quantity_name,
+                     const char* title = NULL, bool mode_3D = true, int item = H2D_FN_VAL_0,
+                     double eps = HERMES_EPS_NORMAL);
+
+  /// View updated by save_snapshot(), NULL for none.
+  void set_view(Views::ScalarView* view);
+
+  /// Waits until all pending output is written.
+  void wait();
+
+protected:
+  struct Job
+  {
+    Job();
+
+    OutputTriangulation data;
+    std::string filename_base;
+    std::string value_name;
+    std::string cell_value_name;
+    bool mode_3D;
+  };
+
+  /// Writes job->data to the file, in the calling thread.
+  void write(Job* job);
+
+  /// Queues the job (background, the data is copied) or writes it right away.
+  void submit(Job* job);
+
+  static void* worker(void* arg);
+
+  Format format;
+  bool background;
+  int max_pending;
+  Views::ScalarView* view;
+
+  // Background output.
+  bool thread_running, finish;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t job_added, job_done;
+  std::deque<Job*> queue;
+  // Number of queued jobs and the job being written.
+  int pending;
+};
+
+#endif
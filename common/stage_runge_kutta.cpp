@@ -0,0 +1,482 @@
+#include "stage_runge_kutta.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Runge-Kutta time stepping with a cached stage matrix */
+
+static Hermes::Algebra::CSCMatrix<double>* to_csc(Hermes::Algebra::SparseMatrix<double>* matrix)
+{
+  Hermes::Algebra::CSCMatrix<double>* csc = dynamic_cast<Hermes::Algebra::CSCMatrix<double>*>(matrix);
+  if (csc == NULL)
+    throw Hermes::Exceptions::Exception("StageRungeKutta: the matrices are combined in the CSC format (SOLVER_UMFPACK).");
+  return csc;
+}
+
+// y += factor * matrix * x.
+static void add_product(Hermes::Algebra::CSCMatrix<double>* matrix, double factor, const double* x, double* y, int ndof)
+{
+  const int* ap = matrix->get_Ap();
+  const int* ai = matrix->get_Ai();
+  const double* ax = matrix->get_Ax();
+  for (int col = 0; col < ndof; col++)
+    for (int k = ap[col]; k < ap[col + 1]; k++)
+      y[ai[k]] += factor * ax[k] * x[col];
+}
+
+StageRungeKutta::FactorizedMatrix::FactorizedMatrix()
+  : matrix(NULL), rhs(NULL), solver(NULL), reordered(false), factorized(false)
+{
+}
+
+StageRungeKutta::StageRungeKutta(WeakForm<double>* wf, const Space<double>* space, ButcherTable* bt)
+  : wf(wf), space(space), num_stages(bt->get_size()), linear(true), newton_tol(1e-8), newton_max_iter(100),
+    time(0), time_step(0), ndof(-1), space_seq(-1), dp(NULL), load(NULL), mass(NULL), jacobian(NULL), residual(NULL),
+    num_steps(0), num_factorizations(0), num_numeric_factorizations(0), num_newton_iters(0)
+{
+  int s = num_stages;
+  a.resize(s * s);
+  b.resize(s);
+  c.resize(s);
+  diagonally_implicit = true;
+  stiffly_accurate = true;
+  for (int i = 0; i < s; i++)
+  {
+    for (int j = 0; j < s; j++)
+    {
+      a[i * s + j] = bt->get_A(i, j);
+      if (j > i && a[i * s + j] != 0)
+        diagonally_implicit = false;
+    }
+    b[i] = bt->get_B(i);
+    c[i] = bt->get_C(i);
+  }
+  for (int i = 0; i < s; i++)
+    if (b[i] != a[(s - 1) * s + i])
+      stiffly_accurate = false;
+}
+
+StageRungeKutta::~StageRungeKutta()
+{
+  free_stage_matrices();
+  free_solver(mass_matrix);
+  delete jacobian;
+  delete residual;
+  delete load;
+  delete dp;
+}
+
+void StageRungeKutta::set_time(double time)
+{
+  this->time = time;
+}
+
+void StageRungeKutta::set_time_step(double time_step)
+{
+  // The Newton matrices of a nonlinear problem are filled in every Newton
+  // step, only their pattern is kept.
+  if (time_step != this->time_step && linear)
+    free_stage_matrices();
+  this->time_step = time_step;
+}
+
+void StageRungeKutta::set_space(const Space<double>* space)
+{
+  this->space = space;
+  invalidate();
+}
+
+void StageRungeKutta::invalidate()
+{
+  ndof = -1;
+}
+
+void StageRungeKutta::set_linear(bool linear)
+{
+  if (!linear && !diagonally_implicit)
+    throw Hermes::Exceptions::Exception("StageRungeKutta: nonlinear problems need a diagonally implicit table.");
+  this->linear = linear;
+  invalidate();
+}
+
+void StageRungeKutta::set_newton_tol(double newton_tol)
+{
+  this->newton_tol = newton_tol;
+}
+
+void StageRungeKutta::set_newton_max_iter(int newton_max_iter)
+{
+  this->newton_max_iter = newton_max_iter;
+}
+
+bool StageRungeKutta::is_diagonally_implicit() const
+{
+  return diagonally_implicit;
+}
+
+int StageRungeKutta::get_num_steps() const
+{
+  return num_steps;
+}
+
+int StageRungeKutta::get_num_factorizations() const
+{
+  return num_factorizations;
+}
+
+int StageRungeKutta::get_num_numeric_factorizations() const
+{
+  return num_numeric_factorizations;
+}
+
+int StageRungeKutta::get_num_newton_iters() const
+{
+  return num_newton_iters;
+}
+
+void StageRungeKutta::set_stage_time(double stage_time)
+{
+  Hermes::vector<MatrixFormVol<double>*> mfvol = wf->get_mfvol();
+  for (unsigned int i = 0; i < mfvol.size(); i++)
+    mfvol[i]->set_current_stage_time(stage_time);
+  Hermes::vector<MatrixFormSurf<double>*> mfsurf = wf->get_mfsurf();
+  for (unsigned int i = 0; i < mfsurf.size(); i++)
+    mfsurf[i]->set_current_stage_time(stage_time);
+  Hermes::vector<VectorFormVol<double>*> vfvol = wf->get_vfvol();
+  for (unsigned int i = 0; i < vfvol.size(); i++)
+    vfvol[i]->set_current_stage_time(stage_time);
+  Hermes::vector<VectorFormSurf<double>*> vfsurf = wf->get_vfsurf();
+  for (unsigned int i = 0; i < vfsurf.size(); i++)
+    vfsurf[i]->set_current_stage_time(stage_time);
+}
+
+void StageRungeKutta::prepare()
+{
+  free_stage_matrices();
+  free_solver(mass_matrix);
+  delete jacobian;
+  delete residual;
+  delete load;
+  delete dp;
+
+  ndof = space->get_num_dofs();
+  space_seq = space->get_seq();
+  std::vector<double> zero(ndof, 0.0);
+
+  // M.
+  WeakForm<double> wf_mass(1);
+  wf_mass.add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol<double>(0, 0));
+  DiscreteProblem<double> dp_mass(&wf_mass, space);
+  mass = to_csc(Hermes::Algebra::create_matrix<double>());
+  dp_mass.assemble(&zero[0], mass);
+  mass_matrix.matrix = mass;
+  create_solver(mass_matrix, ndof);
+
+  // J (of a linear problem, otherwise assembled in every Newton step), and
+  // f(t, Y) from the residual assembly.
+  dp = new DiscreteProblem<double>(wf, space);
+  jacobian = to_csc(Hermes::Algebra::create_matrix<double>());
+  residual = Hermes::Algebra::create_vector<double>();
+  if (linear)
+  {
+    set_stage_time(time);
+    dp->assemble(&zero[0], jacobian);
+  }
+  load = new ResidualAssembler(dp);
+
+  stage_values.resize(num_stages * ndof);
+  stage_loads.resize(num_stages * ndof);
+  stage_slopes.resize(num_stages * ndof);
+  this->info("StageRungeKutta: mass matrix%s assembled, ndof = %d.", linear ? " and Jacobian" : "", ndof);
+}
+
+bool StageRungeKutta::create_block_matrix(int num_blocks, const double* alpha, const double* beta,
+                                          Hermes::Algebra::SparseMatrix<double>* matrix, bool keep_pattern) const
+{
+  const int* mp = mass->get_Ap();
+  const int* mi = mass->get_Ai();
+  const double* mx = mass->get_Ax();
+  const int* jp = jacobian->get_Ap();
+  const int* ji = jacobian->get_Ai();
+  const double* jx = jacobian->get_Ax();
+
+  // Columns of the blocks, the rows of M and J merged (both sorted).
+  std::vector<int> ap(1, 0), ai;
+  std::vector<double> ax;
+  for (int block_col = 0; block_col < num_blocks; block_col++)
+    for (int col = 0; col < ndof; col++)
+    {
+      for (int block_row = 0; block_row < num_blocks; block_row++)
+      {
+        double alpha_ij = alpha[block_row * num_blocks + block_col];
+        double beta_ij = beta[block_row * num_blocks + block_col];
+        if (alpha_ij == 0 && beta_ij == 0)
+          continue;
+
+        int k = mp[col], l = jp[col];
+        while (k < mp[col + 1] || l < jp[col + 1])
+        {
+          int row;
+          double value;
+          if (l == jp[col + 1] || (k < mp[col + 1] && mi[k] < ji[l]))
+          {
+            row = mi[k];
+            value = alpha_ij * mx[k++];
+          }
+          else if (k == mp[col + 1] || ji[l] < mi[k])
+          {
+            row = ji[l];
+            value = beta_ij * jx[l++];
+          }
+          else
+          {
+            row = mi[k];
+            value = alpha_ij * mx[k++] + beta_ij * jx[l++];
+          }
+          ai.push_back(block_row * ndof + row);
+          ax.push_back(value);
+        }
+      }
+      ap.push_back(ai.size());
+    }
+
+  Hermes::Algebra::CSCMatrix<double>* csc = to_csc(matrix);
+  if (keep_pattern && csc->get_Ap() != NULL && csc->get_size() == (unsigned int) (num_blocks * ndof)
+      && csc->get_nnz() == ai.size() && std::equal(ap.begin(), ap.end(), csc->get_Ap())
+      && std::equal(ai.begin(), ai.end(), csc->get_Ai()))
+  {
+    std::copy(ax.begin(), ax.end(), csc->get_Ax());
+    return true;
+  }
+  csc->create(num_blocks * ndof, ai.size(), &ap[0], &ai[0], &ax[0]);
+  return false;
+}
+
+void StageRungeKutta::create_solver(FactorizedMatrix& fm, int size)
+{
+  fm.rhs = Hermes::Algebra::create_vector<double>();
+  fm.rhs->alloc(size);
+  fm.solver = Hermes::Solvers::create_linear_solver<double>(fm.matrix, fm.rhs);
+  fm.reordered = false;
+  fm.factorized = false;
+}
+
+void StageRungeKutta::solve(FactorizedMatrix& fm, const double* rhs_values, double* x)
+{
+  int size = fm.rhs->length();
+  for (int i = 0; i < size; i++)
+    fm.rhs->set(i, rhs_values[i]);
+  if (fm.factorized)
+    fm.solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_FACTORIZATION_COMPLETELY);
+  else if (fm.reordered)
+    fm.solver->set_factorization_scheme(Hermes::Solvers::HERMES_REUSE_MATRIX_REORDERING);
+  else
+    fm.solver->set_factorization_scheme(Hermes::Solvers::HERMES_FACTORIZE_FROM_SCRATCH);
+  if (!fm.solver->solve())
+    throw Hermes::Exceptions::Exception("StageRungeKutta: matrix solver failed.");
+  if (!fm.factorized)
+  {
+    if (fm.reordered)
+      num_numeric_factorizations++;
+    else
+      num_factorizations++;
+  }
+  fm.reordered = true;
+  fm.factorized = true;
+  std::copy(fm.solver->get_sln_vector(), fm.solver->get_sln_vector() + size, x);
+}
+
+void StageRungeKutta::free_solver(FactorizedMatrix& fm)
+{
+  delete fm.solver;
+  delete fm.matrix;
+  delete fm.rhs;
+  fm = FactorizedMatrix();
+}
+
+void StageRungeKutta::free_stage_matrices()
+{
+  for (unsigned int i = 0; i < stage_matrices.size(); i++)
+    free_solver(stage_matrices[i]);
+  stage_matrices.clear();
+  stage_diagonals.clear();
+}
+
+StageRungeKutta::FactorizedMatrix& StageRungeKutta::get_stage_matrix(double diagonal)
+{
+  if (diagonal == 0)
+    return mass_matrix;
+  for (unsigned int i = 0; i < stage_diagonals.size(); i++)
+    if (stage_diagonals[i] == diagonal)
+      return stage_matrices[i];
+
+  FactorizedMatrix fm;
+  fm.matrix = Hermes::Algebra::create_matrix<double>();
+  if (linear)
+  {
+    double alpha = 1.0, beta = -time_step * diagonal;
+    create_block_matrix(1, &alpha, &beta, fm.matrix);
+    this->info("StageRungeKutta: stage matrix M - %g J assembled.", time_step * diagonal);
+  }
+  create_solver(fm, ndof);
+  stage_diagonals.push_back(diagonal);
+  stage_matrices.push_back(fm);
+  return stage_matrices.back();
+}
+
+void StageRungeKutta::solve_nonlinear_stage(int i, const double* rhs_values)
+{
+  double h_a = time_step * a[i * num_stages + i];
+  double* y = &stage_values[i * ndof];
+  double* f = &stage_slopes[i * ndof];
+  set_stage_time(time + c[i] * time_step);
+
+  // An explicit stage: M Y_i = rhs.
+  if (h_a == 0)
+  {
+    solve(mass_matrix, rhs_values, y);
+    load->assemble(y);
+    std::copy(load->get_residual(), load->get_residual() + ndof, f);
+    return;
+  }
+
+  // Newton's method for G(Y) = M Y - h a_ii f(t_i, Y) - rhs, from Y_{i-1}
+  // (from Y_n for the first stage).
+  if (i > 0)
+    std::copy(&stage_values[(i - 1) * ndof], &stage_values[i * ndof], y);
+  double alpha = 1.0, beta = -h_a;
+  FactorizedMatrix& newton_matrix = get_stage_matrix(a[i * num_stages + i]);
+  std::vector<double> g(ndof), dy(ndof);
+  for (int it = 0; ; it++)
+  {
+    dp->assemble(y, jacobian, residual);
+    residual->extract(f);
+    std::fill(g.begin(), g.end(), 0.0);
+    add_product(mass, 1.0, y, &g[0], ndof);
+    double norm = 0;
+    for (int k = 0; k < ndof; k++)
+    {
+      g[k] = -(g[k] - h_a * f[k] - rhs_values[k]);
+      norm += g[k] * g[k];
+    }
+    if (std::sqrt(norm) < newton_tol)
+      break;
+    if (it == newton_max_iter)
+      throw Hermes::Exceptions::Exception("StageRungeKutta: Newton's method did not converge in the stage %d.", i + 1);
+
+    // (M - h a_ii J(Y)) dY = -G(Y). The pattern of J does not change, so
+    // only the values are new and the symbolic factorization is reused.
+    if (!create_block_matrix(1, &alpha, &beta, newton_matrix.matrix, true))
+      newton_matrix.reordered = false;
+    newton_matrix.factorized = false;
+    solve(newton_matrix, &g[0], &dy[0]);
+    for (int k = 0; k < ndof; k++)
+      y[k] += dy[k];
+    num_newton_iters++;
+  }
+}
+
+void StageRungeKutta::rk_time_step(double* coeff_vec)
+{
+  // A space with the same number of DOFs may still be a different one.
+  if (ndof < 0 || ndof != space->get_num_dofs() || space_seq != space->get_seq())
+    prepare();
+
+  int s = num_stages;
+  double h = time_step;
+  std::vector<double> zero(ndof, 0.0), mass_y(ndof, 0.0), rhs_values(ndof);
+  add_product(mass, 1.0, coeff_vec, &mass_y[0], ndof);
+
+  // g(t_i) of all stages.
+  if (linear)
+    for (int i = 0; i < s; i++)
+    {
+      set_stage_time(time + c[i] * h);
+      load->assemble(&zero[0]);
+      std::copy(load->get_residual(), load->get_residual() + ndof, &stage_loads[i * ndof]);
+    }
+
+  if (diagonally_implicit)
+  {
+    // The Newton's method of the first stage starts from Y_n.
+    if (!linear)
+      std::copy(coeff_vec, coeff_vec + ndof, stage_values.begin());
+
+    for (int i = 0; i < s; i++)
+    {
+      // M Y_n + h sum_{j < i} a_ij f_j.
+      for (int k = 0; k < ndof; k++)
+      {
+        double value = mass_y[k];
+        for (int j = 0; j < i; j++)
+          value += h * a[i * s + j] * stage_slopes[j * ndof + k];
+        rhs_values[k] = value;
+      }
+
+      if (!linear)
+      {
+        solve_nonlinear_stage(i, &rhs_values[0]);
+        continue;
+      }
+
+      // (M - h a_ii J) Y_i = ... + h a_ii g_i.
+      double diagonal = a[i * s + i];
+      for (int k = 0; k < ndof; k++)
+        rhs_values[k] += h * diagonal * stage_loads[i * ndof + k];
+      double* y = &stage_values[i * ndof];
+      solve(get_stage_matrix(diagonal), &rhs_values[0], y);
+      std::copy(&stage_loads[i * ndof], &stage_loads[i * ndof] + ndof, &stage_slopes[i * ndof]);
+      add_product(jacobian, 1.0, y, &stage_slopes[i * ndof], ndof);
+    }
+  }
+  else
+  {
+    // M Y_i - h sum_j a_ij J Y_j = M Y_n + h sum_j a_ij g_j, one block matrix.
+    if (stage_matrices.empty())
+    {
+      std::vector<double> alpha(s * s, 0.0), beta(s * s);
+      for (int i = 0; i < s; i++)
+      {
+        alpha[i * s + i] = 1.0;
+        for (int j = 0; j < s; j++)
+          beta[i * s + j] = -h * a[i * s + j];
+      }
+      FactorizedMatrix fm;
+      fm.matrix = Hermes::Algebra::create_matrix<double>();
+      create_block_matrix(s, &alpha[0], &beta[0], fm.matrix);
+      create_solver(fm, s * ndof);
+      stage_matrices.push_back(fm);
+      this->info("StageRungeKutta: stage matrix of size %d assembled for the time step %g.", s * ndof, h);
+    }
+
+    std::vector<double> block_rhs(s * ndof);
+    for (int i = 0; i < s; i++)
+      for (int k = 0; k < ndof; k++)
+      {
+        double value = mass_y[k];
+        for (int j = 0; j < s; j++)
+          value += h * a[i * s + j] * stage_loads[j * ndof + k];
+        block_rhs[i * ndof + k] = value;
+      }
+    solve(stage_matrices[0], &block_rhs[0], &stage_values[0]);
+
+    stage_slopes = stage_loads;
+    for (int i = 0; i < s; i++)
+      add_product(jacobian, 1.0, &stage_values[i * ndof], &stage_slopes[i * ndof], ndof);
+  }
+
+  // The new time level.
+  if (stiffly_accurate)
+    std::copy(&stage_values[(s - 1) * ndof], &stage_values[(s - 1) * ndof] + ndof, coeff_vec);
+  else
+  {
+    std::vector<double> increment(ndof, 0.0), dy(ndof);
+    for (int i = 0; i < s; i++)
+      for (int k = 0; k < ndof; k++)
+        increment[k] += h * b[i] * stage_slopes[i * ndof + k];
+    solve(mass_matrix, &increment[0], &dy[0]);
+    for (int k = 0; k < ndof; k++)
+      coeff_vec[k] += dy[k];
+  }
+  num_steps++;
+}
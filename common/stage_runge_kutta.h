@@ -0,0 +1,185 @@
+#ifndef __HERMES_TUTORIAL_STAGE_RUNGE_KUTTA_H
+#define __HERMES_TUTORIAL_STAGE_RUNGE_KUTTA_H
+
+#include "hermes2d.h"
+#include "residual_assembler.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Runge-Kutta time stepping with a cached stage matrix */
+
+// Runge-Kutta time stepping of a linear problem
+//
+//   M dY/dt = f(t, Y) = J Y + g(t)
+//
+// with a constant time step h. As for RungeKutta, 'wf' is the weak form of
+// the right-hand side f: its matrix forms give J, its residual forms f. The
+// stage values Y_i = Y_n + h sum_j a_ij K_j, with M K_j = f(t_n + c_j h, Y_j),
+// solve
+//
+//   M Y_i - h sum_j a_ij J Y_j = M Y_n + h sum_j a_ij g(t_n + c_j h).
+//
+// RungeKutta assembles this s ndof x s ndof system (with the Jacobian blocks
+// M - h a_ij J) in every time step. Here M and J are assembled once, the stage
+// matrix is factorized once and kept until the time step or the space changes,
+// and only g(t) = f(t, 0) is assembled for every stage.
+//
+// Diagonally implicit tables (a_ij = 0 for j > i: DIRK, SDIRK, and explicit
+// tables) are solved stage by stage,
+//
+//   (M - h a_ii J) Y_i = M Y_n + h sum_{j < i} a_ij f(t_j, Y_j) + h a_ii g(t_i),
+//
+// with one ndof x ndof matrix for every distinct a_ii (a single one for
+// SDIRK; M itself for a_ii = 0). Other tables need the whole block matrix.
+// The new time level is
+//
+//   M Y_{n+1} = M Y_n + h sum_i b_i f(t_n + c_i h, Y_i),
+//
+// or Y_{n+1} = Y_s for stiffly accurate tables (b_i = a_si).
+//
+// Nonlinear problems (set_linear(false)) need a diagonally implicit table.
+// Every stage with a_ii != 0 is then solved by the Newton's method for
+//
+//   M Y_i - h a_ii f(t_i, Y_i) = M Y_n + h sum_{j < i} a_ij f(t_j, Y_j)
+//
+// with the ndof x ndof matrix M - h a_ii J(Y_i), starting from Y_{i-1} (Y_n
+// for the first stage). The monolithic system of RungeKutta has s times more
+// unknowns, and about s^2 times more matrix entries, in every Newton step.
+// The pattern of M - h a_ii J and its symbolic factorization are kept, so a
+// Newton step only updates the values and factorizes numerically.
+//
+// The matrices are combined in the compressed column format (CSCMatrix,
+// e.g. UMFPack). The Dirichlet values must not depend on time.
+
+class StageRungeKutta : public Hermes::Mixins::Loggable
+{
+public:
+  StageRungeKutta(WeakForm<double>* wf, const Space<double>* space, ButcherTable* bt);
+  ~StageRungeKutta();
+
+  void set_time(double time);
+
+  /// A different time step drops the stage matrices (of a linear problem).
+  void set_time_step(double time_step);
+
+  /// Drops all matrices. The same happens if the space changes (its
+  /// sequence number, e.g. after adaptivity, or its number of DOFs).
+  void set_space(const Space<double>* space);
+
+  /// Drops all matrices and factorizations, they are assembled anew in the
+  /// next time step. Needed if the weak form or the boundary conditions
+  /// change.
+  void invalidate();
+
+  /// False for a nonlinear problem (true by default).
+  void set_linear(bool linear);
+
+  /// Residual norm to stop the Newton's method of a stage at.
+  void set_newton_tol(double newton_tol);
+  void set_newton_max_iter(int newton_max_iter);
+
+  /// Whether the table is diagonally implicit (solved stage by stage).
+  bool is_diagonally_implicit() const;
+
+  /// One time step from 'coeff_vec' (previous time level), which receives
+  /// the new time level.
+  void rk_time_step(double* coeff_vec);
+
+  int get_num_steps() const;
+  /// Factorizations from scratch (symbolic and numeric).
+  int get_num_factorizations() const;
+  /// Numeric factorizations with a kept symbolic factorization (Newton steps
+  /// of a nonlinear problem after the first one).
+  int get_num_numeric_factorizations() const;
+  int get_num_newton_iters() const;
+
+protected:
+  // A matrix with its right-hand side and its kept factorization.
+  struct FactorizedMatrix
+  {
+    FactorizedMatrix();
+
+    Hermes::Algebra::SparseMatrix<double>* matrix;
+    Hermes::Algebra::Vector<double>* rhs;
+    Hermes::Solvers::LinearMatrixSolver<double>* solver;
+    // 'reordered': the symbolic factorization of the pattern of 'matrix'
+    // is kept, 'factorized': also the numeric one of its values.
+    bool reordered;
+    bool factorized;
+  };
+
+  /// Assembles M, and J for linear problems.
+  void prepare();
+
+  /// Drops the stage matrices and their factorizations.
+  void free_stage_matrices();
+
+  /// Sets the stage time of all forms of 'wf'.
+  void set_stage_time(double stage_time);
+
+  /// The blocks alpha_ij M + beta_ij J (num_blocks x num_blocks, row-wise)
+  /// into 'matrix'. With 'keep_pattern' only the values are replaced if the
+  /// pattern of 'matrix' is still the one of the blocks. Returns false if the
+  /// matrix was created anew.
+  bool create_block_matrix(int num_blocks, const double* alpha, const double* beta,
+                           Hermes::Algebra::SparseMatrix<double>* matrix, bool keep_pattern = false) const;
+
+  /// Creates the solver of fm.matrix, of size 'size'.
+  void create_solver(FactorizedMatrix& fm, int size);
+
+  /// Solves with fm, factorizes fm.matrix only if it is not factorized yet
+  /// (numerically only if it is reordered).
+  void solve(FactorizedMatrix& fm, const double* rhs_values, double* x);
+
+  void free_solver(FactorizedMatrix& fm);
+
+  /// M - h a_ii J of a linear problem (M for a_ii = 0), created at the first
+  /// use. For a nonlinear problem the matrix is only created, its values are
+  /// set in every Newton step (the pattern and the symbolic factorization are
+  /// kept over the Newton steps, stages and time steps).
+  FactorizedMatrix& get_stage_matrix(double diagonal);
+
+  /// Y_i and f(t_i, Y_i) of the stage i of a nonlinear problem, 'rhs_values'
+  /// is M Y_n + h sum_{j < i} a_ij f_j.
+  void solve_nonlinear_stage(int i, const double* rhs_values);
+
+  WeakForm<double>* wf;
+  const Space<double>* space;
+
+  // The Butcher's table, a row-wise.
+  int num_stages;
+  std::vector<double> a, b, c;
+  bool diagonally_implicit, stiffly_accurate;
+
+  bool linear;
+  double newton_tol;
+  int newton_max_iter;
+
+  double time, time_step;
+  // Number of DOFs and sequence number of the space the matrices belong
+  // to, ndof = -1 if there are none.
+  int ndof;
+  int space_seq;
+
+  DiscreteProblem<double>* dp;
+  ResidualAssembler* load;
+  Hermes::Algebra::CSCMatrix<double>* mass;
+  Hermes::Algebra::CSCMatrix<double>* jacobian;
+  Hermes::Algebra::Vector<double>* residual;
+  FactorizedMatrix mass_matrix;
+
+  // Stage matrices of the distinct a_ii (or the one block matrix).
+  std::vector<double> stage_diagonals;
+  std::vector<FactorizedMatrix> stage_matrices;
+
+  // Y_i, g(t_i) and f(t_i, Y_i) of all stages, ndof each.
+  std::vector<double> stage_values, stage_loads, stage_slopes;
+
+  int num_steps;
+  int num_factorizations;
+  int num_numeric_factorizations;
+  int num_newton_iters;
+};
+
+#endif
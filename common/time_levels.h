@@ -0,0 +1,96 @@
+#ifndef __HERMES_TUTORIAL_TIME_LEVELS_H
+#define __HERMES_TUTORIAL_TIME_LEVELS_H
+
+#include "hermes2d.h"
+#include <algorithm>
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Time levels */
+
+// Solutions of the last time levels of a time stepping method, level 0 being
+// the new one (computed in the current step), level 1 the previous one, etc.
+// After a step, rotate() makes level k the level k + 1 by moving pointers,
+// instead of copying the new solution into the previous one
+// (Solution::copy() duplicates the mesh and all coefficient arrays). The
+// storage of the dropped oldest level is reused for the next new level.
+//
+// Every level initially has its own Solution. A level may be set to an
+// external one instead, typically the initial condition (an ExactSolution
+// such as ConstantSolution); that one is only read and never becomes
+// level 0, so it is not overwritten by the time stepping.
+//
+// Only the rotation itself is free of copies. The pointers change with every
+// rotate(), so they must be taken from get() in every step; weak forms and
+// filters that keep pointers to fixed previous time levels (e.g. the
+// F-trilinos/05-trilinos-coupled example) still need Solution::copy(). The
+// meshes and spaces of the solutions are not owned: a solution on a
+// reference mesh of its own step keeps that mesh in use until its level is
+// dropped, and the caller frees it then.
+
+template<typename Scalar>
+class TimeLevels
+{
+public:
+  TimeLevels(int num_levels = 2) : owned(num_levels), levels(num_levels)
+  {
+    if (num_levels < 2)
+      throw Hermes::Exceptions::Exception("TimeLevels: at least two levels needed.");
+    for (int i = 0; i < num_levels; i++)
+      levels[i] = owned[i] = new Solution<Scalar>;
+  }
+
+  ~TimeLevels()
+  {
+    for (unsigned int i = 0; i < owned.size(); i++)
+      delete owned[i];
+  }
+
+  int get_num_levels() const
+  {
+    return levels.size();
+  }
+
+  /// Solution of the level 'level' (0: new, 1: previous, ...).
+  Solution<Scalar>* get(int level) const
+  {
+    return levels[level];
+  }
+
+  /// Uses 'sln' (not owned) as the level 'level' > 0 until it is rotated out.
+  void set(int level, Solution<Scalar>* sln)
+  {
+    if (level == 0)
+      throw Hermes::Exceptions::Exception("TimeLevels: level 0 is always an own solution.");
+    levels[level] = sln;
+  }
+
+  /// After a time step: the level k becomes the level k + 1 and the oldest
+  /// level is dropped. The new level 0 is an own solution not used by any
+  /// other level.
+  void rotate()
+  {
+    int n = levels.size();
+    for (int i = n - 1; i > 0; i--)
+      levels[i] = levels[i - 1];
+
+    // n own solutions, at most n - 1 of them used by the levels 1, ..., n - 1.
+    for (int i = 0; i < n; i++)
+      if (std::find(levels.begin() + 1, levels.end(), owned[i]) == levels.end())
+      {
+        levels[0] = owned[i];
+        return;
+      }
+  }
+
+protected:
+  std::vector<Solution<Scalar>*> owned;
+  std::vector<Solution<Scalar>*> levels;
+
+private:
+  TimeLevels(const TimeLevels&);
+  TimeLevels& operator=(const TimeLevels&);
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "tutorial_parameters.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+static std::string trim(const std::string& str)
+{
+  size_t begin = 0, end = str.length();
+  while(begin < end && isspace((unsigned char)str[begin]))
+    begin++;
+  while(end > begin && isspace((unsigned char)str[end - 1]))
+    end--;
+  return str.substr(begin, end - begin);
+}
+
+static std::string to_upper(std::string str)
+{
+  for(unsigned int i = 0; i < str.length(); i++)
+    str[i] = toupper((unsigned char)str[i]);
+  return str;
+}
+
+TutorialParameters::TutorialParameters(int argc, char* argv[]) : program(argc > 0 ? argv[0] : "example")
+{
+  // The examples construct the parameters before any try block.
+  try
+  {
+    // The configuration file first, so that the command line overrides it.
+    for(int i = 1; i < argc; i++)
+    {
+      std::string arg(argv[i]);
+      if(arg.compare(0, 9, "--config=") == 0)
+        this->load(arg.substr(9).c_str());
+    }
+
+    for(int i = 1; i < argc; i++)
+    {
+      std::string arg(argv[i]);
+      if(arg.compare(0, 9, "--config=") == 0)
+        continue;
+      if(arg == "--headless")
+      {
+        this->set("HERMES_VISUALIZATION", "false");
+        continue;
+      }
+
+      size_t equals = arg.find('=');
+      if(arg.compare(0, 2, "--") != 0 || equals == std::string::npos || equals == 2)
+        throw Hermes::Exceptions::Exception("Invalid argument '%s', expected --NAME=value, --config=file or --headless.", argv[i]);
+      this->set(arg.substr(2, equals - 2), arg.substr(equals + 1));
+    }
+  }
+  catch(Hermes::Exceptions::Exception& e)
+  {
+    this->usage_error("%s", e.what());
+  }
+}
+
+void TutorialParameters::usage_error(const char* format, ...) const
+{
+  char message[1024];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+
+  fprintf(stderr, "%s\n", message);
+  fprintf(stderr, "Usage: %s [--NAME=value ...] [--config=file] [--headless]\n", this->program.c_str());
+  if(!this->known.empty())
+  {
+    fprintf(stderr, "Parameters:");
+    for(std::set<std::string>::const_iterator it = this->known.begin(); it != this->known.end(); ++it)
+      fprintf(stderr, " %s", it->c_str());
+    fprintf(stderr, "\n");
+  }
+  exit(EXIT_FAILURE);
+}
+
+void TutorialParameters::check_unused() const
+{
+  std::string unused;
+  for(std::map<std::string, std::string>::const_iterator it = this->values.begin(); it != this->values.end(); ++it)
+    if(this->known.find(it->first) == this->known.end())
+      unused += (unused.empty() ? "" : ", ") + it->first;
+  if(!unused.empty())
+    this->usage_error("Unknown parameter(s): %s.", unused.c_str());
+}
+
+void TutorialParameters::load(const char* filename)
+{
+  std::ifstream file(filename);
+  if(!file.is_open())
+    throw Hermes::Exceptions::Exception("Configuration file %s could not be opened.", filename);
+
+  std::string line;
+  int line_number = 0;
+  while(std::getline(file, line))
+  {
+    line_number++;
+    size_t comment = line.find('#');
+    if(comment != std::string::npos)
+      line.erase(comment);
+    line = trim(line);
+    if(line.empty())
+      continue;
+
+    size_t equals = line.find('=');
+    if(equals == std::string::npos || equals == 0)
+      throw Hermes::Exceptions::Exception("%s:%d: expected NAME = value.", filename, line_number);
+    this->set(line.substr(0, equals), line.substr(equals + 1));
+  }
+  this->info("Parameters read from %s.", filename);
+}
+
+void TutorialParameters::set(std::string name, std::string value)
+{
+  this->values[to_upper(trim(name))] = trim(value);
+}
+
+const std::string* TutorialParameters::find(const char* name) const
+{
+  std::string upper = to_upper(name);
+  this->known.insert(upper);
+  std::map<std::string, std::string>::const_iterator it = this->values.find(upper);
+  if(it == this->values.end())
+    return NULL;
+  return &it->second;
+}
+
+bool TutorialParameters::is_set(const char* name) const
+{
+  return this->find(name) != NULL;
+}
+
+void TutorialParameters::get(const char* name, bool& value) const
+{
+  const std::string* str = this->find(name);
+  if(str == NULL)
+    return;
+
+  std::string lower = *str;
+  for(unsigned int i = 0; i < lower.length(); i++)
+    lower[i] = tolower((unsigned char)lower[i]);
+
+  if(lower == "true" || lower == "yes" || lower == "on" || lower == "1")
+    value = true;
+  else if(lower == "false" || lower == "no" || lower == "off" || lower == "0")
+    value = false;
+  else
+    this->usage_error("Parameter %s: '%s' is not a boolean value.", name, str->c_str());
+  this->info("%s = %s", name, value ? "true" : "false");
+}
+
+void TutorialParameters::get(const char* name, int& value) const
+{
+  const std::string* str = this->find(name);
+  if(str == NULL)
+    return;
+
+  char* end;
+  errno = 0;
+  long result = strtol(str->c_str(), &end, 10);
+  if(str->empty() || *end != '\0' || errno == ERANGE || result != (int)result)
+    this->usage_error("Parameter %s: '%s' is not an integer.", name, str->c_str());
+  value = (int)result;
+  this->info("%s = %d", name, value);
+}
+
+void TutorialParameters::get(const char* name, unsigned int& value) const
+{
+  int result = (int)value;
+  this->get(name, result);
+  if(result < 0)
+    this->usage_error("Parameter %s must not be negative.", name);
+  value = (unsigned int)result;
+}
+
+void TutorialParameters::get(const char* name, double& value) const
+{
+  const std::string* str = this->find(name);
+  if(str == NULL)
+    return;
+
+  char* end;
+  double result = strtod(str->c_str(), &end);
+  if(str->empty() || *end != '\0')
+    this->usage_error("Parameter %s: '%s' is not a number.", name, str->c_str());
+  value = result;
+  this->info("%s = %g", name, value);
+}
+
+void TutorialParameters::get(const char* name, std::string& value) const
+{
+  const std::string* str = this->find(name);
+  if(str == NULL)
+    return;
+  value = *str;
+  this->info("%s = %s", name, value.c_str());
+}
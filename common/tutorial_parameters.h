@@ -0,0 +1,76 @@
+#ifndef __HERMES_TUTORIAL_TUTORIAL_PARAMETERS_H
+#define __HERMES_TUTORIAL_TUTORIAL_PARAMETERS_H
+
+#include "hermes2d.h"
+
+#include <map>
+#include <set>
+
+/* Runtime parameters of the tutorial examples */
+
+// Lets the parameters defined at the top of every main.cpp be changed
+// without recompiling. Values are given on the command line,
+//
+//   ./example --P_INIT=3 --INIT_REF_NUM=2 --HERMES_VISUALIZATION=false
+//
+// or in a configuration file passed as --config=file, with one
+// "NAME = value" pair per line ('#' starts a comment). Command line values
+// override the ones from the file. Names are not case sensitive, boolean
+// values are true/false, yes/no, on/off or 1/0. The switch --headless is
+// a shortcut for --HERMES_VISUALIZATION=false.
+//
+// Every example then reads the parameters it knows:
+//
+//   TutorialParameters parameters(argc, argv);
+//   parameters.get("P_INIT", P_INIT);
+//
+//   parameters.check_unused();
+//
+// The default values in main.cpp are kept for parameters that were not given.
+// A malformed argument or value prints the error with a usage message and
+// ends the program, as does a given parameter the example never asked for
+// (e.g. a misspelled name), which check_unused() reports.
+
+class TutorialParameters : public Hermes::Mixins::Loggable
+{
+public:
+  TutorialParameters(int argc, char* argv[]);
+
+  /// Overwrites 'value' if the parameter 'name' was given.
+  /// Ends the program if the given value cannot be converted.
+  void get(const char* name, bool& value) const;
+  void get(const char* name, int& value) const;
+  void get(const char* name, unsigned int& value) const;
+  void get(const char* name, double& value) const;
+  void get(const char* name, std::string& value) const;
+
+  /// True if the parameter 'name' was given.
+  bool is_set(const char* name) const;
+
+  /// Ends the program if a parameter was given that no get() asked for,
+  /// to be called after all parameters were read.
+  void check_unused() const;
+
+protected:
+  /// Prints the message and the usage, then ends the program.
+  void usage_error(const char* format, ...) const;
+
+  /// Reads "NAME = value" lines from a configuration file.
+  void load(const char* filename);
+
+  /// Stores one parameter.
+  void set(std::string name, std::string value);
+
+  /// Raw value of the parameter 'name', NULL if not given.
+  const std::string* find(const char* name) const;
+
+  std::string program;
+
+  // Upper-case names -> values.
+  std::map<std::string, std::string> values;
+
+  // Upper-case names the example asked for.
+  mutable std::set<std::string> known;
+};
+
+#endif
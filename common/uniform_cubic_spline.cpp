@@ -0,0 +1,152 @@
+#include "uniform_cubic_spline.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Grid cells per interval at most, for very unevenly spaced knots.
+static const int MAX_CELLS_PER_INTERVAL = 64;
+
+UniformCubicSpline::UniformCubicSpline(const Hermes1DFunction<double>* spline, const Hermes::vector<double>& points)
+  : spline(spline)
+{
+  num_intervals = points.size() - 1;
+  if (num_intervals < 1)
+    throw Hermes::Exceptions::Exception("UniformCubicSpline needs at least two knots.");
+
+  // Hermite form of the cubic of each interval, plus the right end as the
+  // last entry.
+  pieces.resize(num_intervals + 1);
+  double min_width = points[num_intervals] - points[0];
+  for (int k = 0; k < num_intervals; k++)
+  {
+    double x0 = points[k], x1 = points[k + 1], h = x1 - x0;
+    if (!(h > 0))
+      throw Hermes::Exceptions::Exception("Knots of UniformCubicSpline must be increasing.");
+    min_width = std::min(min_width, h);
+
+    double y0 = spline->value(x0), y1 = spline->value(x1);
+    double d0 = spline->derivative(x0), d1 = spline->derivative(x1);
+    double slope = (y1 - y0) / h;
+    pieces[k].x = x0;
+    pieces[k].a = y0;
+    pieces[k].b = d0;
+    pieces[k].c = (3 * slope - 2 * d0 - d1) / h;
+    pieces[k].d = (d0 + d1 - 2 * slope) / (h * h);
+  }
+  x_left = points[0];
+  x_right = points[num_intervals];
+  pieces[num_intervals].x = x_right;
+  pieces[num_intervals].a = pieces[num_intervals].b = pieces[num_intervals].c = pieces[num_intervals].d = 0;
+
+  // Extrapolation.
+  value_left = spline->value(x_left);
+  slope_left = spline->derivative(x_left - (points[1] - points[0]));
+  value_right = spline->value(x_right);
+  slope_right = spline->derivative(x_right + (points[num_intervals] - points[num_intervals - 1]));
+
+  // Cells not wider than the shortest interval, if possible.
+  double length = x_right - x_left;
+  int num_cells = (int) std::ceil(length / min_width);
+  num_cells = std::max(num_intervals, std::min(num_cells, MAX_CELLS_PER_INTERVAL * num_intervals));
+  inv_cell_width = num_cells / length;
+
+  cell_interval.resize(num_cells);
+  int k = 0;
+  for (int j = 0; j < num_cells; j++)
+  {
+    double cell_left = x_left + j / inv_cell_width;
+    while (k < num_intervals - 1 && pieces[k + 1].x <= cell_left)
+      k++;
+    cell_interval[j] = k;
+  }
+}
+
+int UniformCubicSpline::get_num_cells() const
+{
+  return cell_interval.size();
+}
+
+int UniformCubicSpline::find_interval(double u) const
+{
+  if (u < x_left)
+    return -1;
+  if (u > x_right)
+    return num_intervals;
+
+  int cell = (int) ((u - x_left) * inv_cell_width);
+  if (cell >= (int) cell_interval.size())
+    cell = cell_interval.size() - 1;
+  int k = cell_interval[cell];
+  while (k < num_intervals - 1 && u >= pieces[k + 1].x)
+    k++;
+  return k;
+}
+
+void UniformCubicSpline::evaluate(int k, double u, double& value, double& derivative) const
+{
+  if (k < 0)
+  {
+    value = value_left + slope_left * (u - x_left);
+    derivative = slope_left;
+  }
+  else if (k >= num_intervals)
+  {
+    value = value_right + slope_right * (u - x_right);
+    derivative = slope_right;
+  }
+  else
+  {
+    const Piece& p = pieces[k];
+    double t = u - p.x;
+    value = p.a + t * (p.b + t * (p.c + t * p.d));
+    derivative = p.b + t * (2 * p.c + 3 * t * p.d);
+  }
+}
+
+double UniformCubicSpline::value(double u) const
+{
+  double val, der;
+  evaluate(find_interval(u), u, val, der);
+  return val;
+}
+
+double UniformCubicSpline::derivative(double u) const
+{
+  double val, der;
+  evaluate(find_interval(u), u, val, der);
+  return der;
+}
+
+void UniformCubicSpline::value_and_derivative(int n, const double* u, double* value, double* derivative) const
+{
+  for (int i = 0; i < n; i++)
+    evaluate(find_interval(u[i]), u[i], value[i], derivative[i]);
+}
+
+void UniformCubicSpline::values(int n, const double* u, double* value) const
+{
+  for (int i = 0; i < n; i++)
+  {
+    int k = find_interval(u[i]);
+    if (k < 0)
+      value[i] = value_left + slope_left * (u[i] - x_left);
+    else if (k >= num_intervals)
+      value[i] = value_right + slope_right * (u[i] - x_right);
+    else
+    {
+      const Piece& p = pieces[k];
+      double t = u[i] - p.x;
+      value[i] = p.a + t * (p.b + t * (p.c + t * p.d));
+    }
+  }
+}
+
+Ord UniformCubicSpline::value(Ord u) const
+{
+  return spline->value(u);
+}
+
+Ord UniformCubicSpline::derivative(Ord u) const
+{
+  return spline->derivative(u);
+}
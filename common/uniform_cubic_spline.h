@@ -0,0 +1,64 @@
+#ifndef __HERMES_TUTORIAL_UNIFORM_CUBIC_SPLINE_H
+#define __HERMES_TUTORIAL_UNIFORM_CUBIC_SPLINE_H
+
+#include "hermes2d.h"
+#include "batch_nonlinearity.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+/* Cubic spline with constant-time lookup */
+
+// Evaluates the same piecewise cubic function as a given cubic spline (e.g.
+// CubicSpline after calculate_coeffs()), without searching the interval of
+// every point. A uniform grid over the knots stores for each cell the first
+// interval that intersects it, so the lookup is one multiply-and-floor plus
+// (with a cell not wider than the shortest interval) at most one comparison.
+//
+// The cubic on each interval is reconstructed exactly from the values and the
+// derivatives of the spline at its end points, the linear or constant
+// extrapolation from the slope of the spline outside. The integration order
+// is taken from the original spline, which has to outlive this object.
+
+class UniformCubicSpline : public BatchNonlinearity
+{
+public:
+  /// 'points' are the knots of 'spline', in increasing order.
+  UniformCubicSpline(const Hermes1DFunction<double>* spline, const Hermes::vector<double>& points);
+
+  virtual double value(double u) const;
+  virtual double derivative(double u) const;
+  virtual void value_and_derivative(int n, const double* u, double* value, double* derivative) const;
+  virtual void values(int n, const double* u, double* value) const;
+
+  virtual Ord value(Ord u) const;
+  virtual Ord derivative(Ord u) const;
+
+  int get_num_cells() const;
+
+protected:
+  /// Interval containing u, -1 left of the knots, num_intervals right of them.
+  int find_interval(double u) const;
+
+  /// Value and derivative of the cubic of the interval 'k' (or of the
+  /// extrapolation) at u.
+  void evaluate(int k, double u, double& value, double& derivative) const;
+
+  const Hermes1DFunction<double>* spline;
+
+  // Cubic a + b t + c t^2 + d t^3, t = u - x, of each interval.
+  struct Piece
+  {
+    double x, a, b, c, d;
+  };
+  std::vector<Piece> pieces;
+  int num_intervals;
+  double x_left, x_right;
+  double value_left, slope_left, value_right, slope_right;
+
+  // First interval intersecting each cell of the grid.
+  std::vector<int> cell_interval;
+  double inv_cell_width;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+#include "mesh_reader_h2d_binary.h"
+#include "mesh_reader_h2d_xml_stream.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// This utility converts meshes in the original (*.mesh) or XML (*.xml)
+// format into the binary format read by MeshReaderH2DBinary. The binary
+// file contains the base mesh with all <variables> already resolved,
+// boundary markers and curved edges (circular arcs and NURBS), and it is
+// memory-mapped when loaded. XML files are read by the streaming reader
+// MeshReaderH2DXMLStream, so large meshes can be converted without building
+// the document tree in memory.
+//
+// Usage: mesh-converter input.mesh|input.xml output.h2db
+//
+// Note: The base mesh is stored, element refinements listed in the
+// <refinements> section of an XML file are not carried over.
+
+static bool ends_with(const std::string& str, const std::string& suffix)
+{
+  return str.length() >= suffix.length() && str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc != 3)
+  {
+    printf("Usage: %s input.mesh|input.xml output.h2db\n", argv[0]);
+    return 1;
+  }
+
+  std::string input(argv[1]);
+  Mesh mesh;
+  try
+  {
+    if(ends_with(input, ".xml"))
+    {
+      MeshReaderH2DXMLStream mloader;
+      mloader.set_parallel_number_parsing(true);
+      Hermes::Mixins::Loggable::Static::info("Reading mesh in XML format.");
+      mloader.load(argv[1], &mesh);
+    }
+    else
+    {
+      MeshReaderH2D mloader;
+      Hermes::Mixins::Loggable::Static::info("Reading mesh in original format.");
+      mloader.load(argv[1], &mesh);
+    }
+
+    MeshReaderH2DBinary mwriter;
+    mwriter.save(argv[2], &mesh);
+
+    // Read the file back to make sure it is valid.
+    Mesh check_mesh;
+    mwriter.load(argv[2], &check_mesh);
+    if(check_mesh.get_num_base_elements() != mesh.get_num_base_elements())
+      throw Hermes::Exceptions::Exception("Element count mismatch after conversion.");
+  }
+  catch(Hermes::Exceptions::Exception& e)
+  {
+    e.print_msg();
+    return 1;
+  }
+
+  return 0;
+}